@@ -0,0 +1,151 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file direct_writer.hpp
+ * \brief Sequential writing of large files, bypassing the page cache.
+ */
+
+#ifndef RCPPUTILS__DIRECT_WRITER_HPP_
+#define RCPPUTILS__DIRECT_WRITER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <system_error>
+
+#include "rcpputils/filesystem_helper.hpp"
+#include "rcpputils/visibility_control.hpp"
+
+namespace rcpputils
+{
+namespace fs
+{
+
+/// Options of direct_writer.
+struct direct_writer_options
+{
+  /// The size of each buffer in bytes, rounded up to a multiple of the alignment.
+  size_t buffer_size = 1 << 20;
+  /// The number of buffers, at least 2 so that one fills while another is written.
+  size_t num_buffers = 2;
+  /// The alignment of the buffers, sizes and positions written, or 0 to ask the filesystem.
+  size_t alignment = 0;
+};
+
+/**
+ * \brief Writes a file sequentially from a pool of aligned buffers, bypassing the page cache.
+ *
+ * The file is opened with open_flags::direct, so data goes from the buffers to the storage
+ * without filling the page cache, which would otherwise evict the pages of everything else
+ * when recording for long at high rates.
+ *
+ * Data is copied into the current buffer. Once full, the buffer is handed to a thread that
+ * writes it, and the next free buffer of the pool is filled meanwhile. Writing only waits when
+ * all buffers are waiting to be written, that is when the storage is slower than the producer.
+ *
+ * Direct I/O needs buffers, sizes and positions aligned to the logical block size of the
+ * storage, which is queried with statx() on Linux, 4096 bytes otherwise. On closing, the last
+ * partial buffer is padded up to the alignment, written, and the file is truncated to the
+ * number of bytes actually written.
+ *
+ * On filesystems that do not support direct I/O, such as tmpfs before Linux 6.6, the file is
+ * written through the page cache instead, see is_direct().
+ *
+ * The writer is meant to be used by a single thread.
+ */
+class direct_writer
+{
+public:
+  /**
+   * \brief Create or truncate a file, and allocate the buffers.
+   *
+   * \param[in] p The file to write.
+   * \param[in] options The size and number of the buffers.
+   * \throws std::invalid_argument if there are fewer than 2 buffers, or the alignment is not a
+   * power of 2.
+   * \throws std::system_error if the file cannot be opened.
+   */
+  RCPPUTILS_PUBLIC
+  explicit direct_writer(const path & p, const direct_writer_options & options = {});
+
+  /// Close the file, ignoring errors, see close().
+  RCPPUTILS_PUBLIC
+  ~direct_writer();
+
+  RCPPUTILS_PUBLIC
+  direct_writer(direct_writer && other) noexcept;
+
+  RCPPUTILS_PUBLIC
+  direct_writer & operator=(direct_writer && other) noexcept;
+
+  direct_writer(const direct_writer &) = delete;
+  direct_writer & operator=(const direct_writer &) = delete;
+
+  /**
+   * \brief Append data to the file.
+   *
+   * The data is copied, so it can be reused as soon as the function returns, while it is written
+   * in the background. Failures to write earlier buffers are reported by the next call.
+   *
+   * \param[in] data The bytes to append.
+   * \param[in] size The number of bytes to append.
+   * \param[out] ec Set to the reason of the first failure to write, or cleared if there was none.
+   * \return The number of bytes appended, fewer than size only on error.
+   */
+  RCPPUTILS_PUBLIC
+  size_t write(const void * data, size_t size, std::error_code & ec) noexcept;
+
+  /**
+   * \brief Write the remaining data, wait for all buffers to be written, and close the file.
+   *
+   * \throws std::system_error if writing any buffer, or the tail, failed.
+   */
+  RCPPUTILS_PUBLIC
+  void close();
+
+  /**
+   * \brief Write the remaining data, wait for all buffers to be written, and close the file,
+   * reporting failures through an error code.
+   *
+   * \param[out] ec Set to the reason of the first failure, or cleared on success. The file is
+   * closed either way.
+   */
+  RCPPUTILS_PUBLIC
+  void close(std::error_code & ec) noexcept;
+
+  /// Whether the file is still open, that is close() was not called.
+  RCPPUTILS_PUBLIC
+  bool is_open() const noexcept;
+
+  /// Whether the file bypasses the page cache, false if the filesystem does not support it.
+  RCPPUTILS_PUBLIC
+  bool is_direct() const noexcept;
+
+  /// The alignment of the buffers, sizes and positions written, in bytes.
+  RCPPUTILS_PUBLIC
+  size_t alignment() const noexcept;
+
+  /// The number of bytes appended so far, which the file holds once closed.
+  RCPPUTILS_PUBLIC
+  uint64_t size() const noexcept;
+
+private:
+  struct impl;
+  std::unique_ptr<impl> impl_;
+};
+
+}  // namespace fs
+}  // namespace rcpputils
+
+#endif  // RCPPUTILS__DIRECT_WRITER_HPP_
@@ -0,0 +1,294 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file directory_handle.hpp
+ * \brief Operations on the entries of an open directory, by their relative names.
+ */
+
+#ifndef RCPPUTILS__DIRECTORY_HANDLE_HPP_
+#define RCPPUTILS__DIRECTORY_HANDLE_HPP_
+
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+#include "rcpputils/visibility_control.hpp"
+
+namespace rcpputils
+{
+namespace fs
+{
+
+/**
+ * \brief An open directory, whose entries are accessed relative to it.
+ *
+ * The directory is opened once, with O_PATH on Linux, and each operation passes its descriptor
+ * with a relative name to the *at() system calls. The kernel thus looks up the names from the
+ * directory instead of walking its whole path again for each operation, and the operations
+ * keep applying to the same directory if it is moved or renamed meanwhile.
+ *
+ * Names are relative paths, usually a single component. Names that are absolute paths ignore
+ * the directory. The directory is closed on destruction.
+ *
+ * On Windows, which has no *at() functions, directories cannot be opened, and every operation
+ * fails with std::errc::function_not_supported.
+ */
+class directory_handle
+{
+public:
+  /// Construct a handle that refers to no directory.
+  directory_handle() noexcept = default;
+
+  /**
+   * \brief Open a directory.
+   *
+   * \param[in] p The directory to open.
+   * \throws std::system_error if p cannot be opened or is not a directory.
+   */
+  RCPPUTILS_PUBLIC
+  explicit directory_handle(const rcpputils::fs::path & p);
+
+  /**
+   * \brief Open a directory, reporting failures through an error code.
+   *
+   * \param[in] p The directory to open.
+   * \param[out] ec Set to the reason of the failure, or cleared on success. The handle refers to
+   * no directory on failure.
+   */
+  RCPPUTILS_PUBLIC
+  directory_handle(const rcpputils::fs::path & p, std::error_code & ec);
+
+  RCPPUTILS_PUBLIC
+  ~directory_handle();
+
+  RCPPUTILS_PUBLIC
+  directory_handle(directory_handle && other) noexcept;
+
+  RCPPUTILS_PUBLIC
+  directory_handle & operator=(directory_handle && other) noexcept;
+
+  directory_handle(const directory_handle &) = delete;
+  directory_handle & operator=(const directory_handle &) = delete;
+
+  /// Whether the handle refers to a directory.
+  bool is_open() const noexcept {return fd_ >= 0;}
+
+  /// The descriptor of the directory, to pass to other *at() calls, or -1 if not open.
+  int native_handle() const noexcept {return fd_;}
+
+  /// The path the directory was opened with.
+  const rcpputils::fs::path & path() const noexcept {return path_;}
+
+  /// Close the directory, leaving the handle referring to none.
+  RCPPUTILS_PUBLIC
+  void close() noexcept;
+
+  /**
+   * \brief Open a directory relative to this one.
+   *
+   * \param[in] name The relative path of the directory.
+   * \return The handle of the directory.
+   * \throws std::system_error if the directory cannot be opened.
+   */
+  RCPPUTILS_PUBLIC
+  directory_handle open(std::string_view name) const;
+
+  /**
+   * \brief Open a directory relative to this one, reporting failures through an error code.
+   *
+   * \param[in] name The relative path of the directory.
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   * \return The handle of the directory, which refers to none on error.
+   */
+  RCPPUTILS_PUBLIC
+  directory_handle open(std::string_view name, std::error_code & ec) const;
+
+  /**
+   * \brief Query the status of an entry with a single fstatat() call, following symlinks.
+   *
+   * \param[in] name The relative path of the entry.
+   * \return The status of the entry, whose type is file_type::not_found if it does not exist.
+   * \throws std::system_error if the status cannot be determined for another reason.
+   */
+  RCPPUTILS_PUBLIC
+  file_status status(std::string_view name) const;
+
+  /**
+   * \brief Query the status of an entry, following symlinks, reporting failures through an
+   * error code.
+   *
+   * \param[in] name The relative path of the entry.
+   * \param[out] ec Set to the reason of the failure, or cleared on success. A missing entry is
+   * not a failure.
+   * \return The status of the entry, whose type is file_type::none on error.
+   */
+  RCPPUTILS_PUBLIC
+  file_status status(std::string_view name, std::error_code & ec) const noexcept;
+
+  /**
+   * \brief Query the status of an entry itself, not following symlinks.
+   *
+   * \sa status(std::string_view) const
+   */
+  RCPPUTILS_PUBLIC
+  file_status symlink_status(std::string_view name) const;
+
+  /**
+   * \brief Query the status of an entry itself, reporting failures through an error code.
+   *
+   * \sa status(std::string_view, std::error_code &) const
+   */
+  RCPPUTILS_PUBLIC
+  file_status symlink_status(std::string_view name, std::error_code & ec) const noexcept;
+
+  /**
+   * \brief Check if an entry exists, with a single faccessat() call.
+   *
+   * \param[in] name The relative path of the entry.
+   * \return True if the entry exists, false otherwise.
+   */
+  RCPPUTILS_PUBLIC
+  bool exists(std::string_view name) const noexcept;
+
+  /**
+   * \brief Check if an entry exists, telling apart a missing entry from one that cannot be
+   * queried.
+   *
+   * \param[in] name The relative path of the entry.
+   * \param[out] ec Set to the reason the entry cannot be queried, or cleared if it can.
+   * \return True if the entry exists, false if it does not or on error.
+   */
+  RCPPUTILS_PUBLIC
+  bool exists(std::string_view name, std::error_code & ec) const noexcept;
+
+  /**
+   * \brief Create a directory in this one, unless it exists already.
+   *
+   * \param[in] name The relative path of the new directory, whose parent must exist.
+   * \return True if the directory was created, false if it already existed.
+   * \throws std::system_error if the directory cannot be created, or name is not a directory.
+   */
+  RCPPUTILS_PUBLIC
+  bool create_directory(std::string_view name) const;
+
+  /**
+   * \brief Create a directory in this one, reporting failures through an error code.
+   *
+   * \param[in] name The relative path of the new directory, whose parent must exist.
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   * \return True if the directory was created, false if it already existed or on error.
+   */
+  RCPPUTILS_PUBLIC
+  bool create_directory(std::string_view name, std::error_code & ec) const noexcept;
+
+  /**
+   * \brief Remove a file or an empty directory in this one.
+   *
+   * \param[in] name The relative path of the entry.
+   * \return True if the entry was removed, false if it did not exist.
+   * \throws std::system_error if the entry cannot be removed.
+   */
+  RCPPUTILS_PUBLIC
+  bool remove(std::string_view name) const;
+
+  /**
+   * \brief Remove a file or an empty directory in this one, reporting failures through an
+   * error code.
+   *
+   * \param[in] name The relative path of the entry.
+   * \param[out] ec Set to the reason of the failure, or cleared on success. A missing entry is
+   * not a failure.
+   * \return True if the entry was removed, false if it did not exist or on error.
+   */
+  RCPPUTILS_PUBLIC
+  bool remove(std::string_view name, std::error_code & ec) const noexcept;
+
+  /**
+   * \brief Rename an entry of this directory, replacing the destination if it exists.
+   *
+   * \param[in] from The relative path of the entry.
+   * \param[in] to The new relative path of the entry.
+   * \throws std::system_error if the entry cannot be renamed.
+   */
+  RCPPUTILS_PUBLIC
+  void rename(std::string_view from, std::string_view to) const;
+
+  /**
+   * \brief Rename an entry of this directory, reporting failures through an error code.
+   *
+   * \param[in] from The relative path of the entry.
+   * \param[in] to The new relative path of the entry.
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   */
+  RCPPUTILS_PUBLIC
+  void rename(std::string_view from, std::string_view to, std::error_code & ec) const noexcept;
+
+  /**
+   * \brief Move an entry of this directory into another one, replacing the destination if it
+   * exists.
+   *
+   * \param[in] from The relative path of the entry.
+   * \param[in] to_directory The directory to move the entry to, on the same filesystem.
+   * \param[in] to The new path of the entry, relative to to_directory.
+   * \throws std::system_error if the entry cannot be moved.
+   */
+  RCPPUTILS_PUBLIC
+  void rename(
+    std::string_view from, const directory_handle & to_directory, std::string_view to) const;
+
+  /**
+   * \brief Move an entry of this directory into another one, reporting failures through an
+   * error code.
+   *
+   * \param[in] from The relative path of the entry.
+   * \param[in] to_directory The directory to move the entry to, on the same filesystem.
+   * \param[in] to The new path of the entry, relative to to_directory.
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   */
+  RCPPUTILS_PUBLIC
+  void rename(
+    std::string_view from, const directory_handle & to_directory, std::string_view to,
+    std::error_code & ec) const noexcept;
+
+  /**
+   * \brief List the entries of the directory, skipping "." and "..", in unspecified order.
+   *
+   * The type of each entry is the one reported by the listing, as with directory_iterator, and
+   * its path is the one of the directory joined with its name.
+   *
+   * \return The entries of the directory.
+   * \throws std::system_error if the directory cannot be read.
+   */
+  RCPPUTILS_PUBLIC
+  std::vector<directory_entry> list() const;
+
+  /**
+   * \brief List the entries of the directory, reporting failures through an error code.
+   *
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   * \return The entries of the directory, or none on error.
+   */
+  RCPPUTILS_PUBLIC
+  std::vector<directory_entry> list(std::error_code & ec) const;
+
+private:
+  rcpputils::fs::path path_;
+  int fd_ = -1;
+};
+
+}  // namespace fs
+}  // namespace rcpputils
+
+#endif  // RCPPUTILS__DIRECTORY_HANDLE_HPP_
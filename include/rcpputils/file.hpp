@@ -0,0 +1,351 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file file.hpp
+ * \brief An open file, read and written at explicit positions without buffering.
+ */
+
+#ifndef RCPPUTILS__FILE_HPP_
+#define RCPPUTILS__FILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <system_error>
+
+#include "rcpputils/filesystem_helper.hpp"
+#include "rcpputils/visibility_control.hpp"
+
+namespace rcpputils
+{
+namespace fs
+{
+
+/// How a file is opened, combined with operator|.
+enum class open_flags : unsigned
+{
+  none = 0,
+  read = 1,  ///< The file can be read.
+  write = 2,  ///< The file can be written.
+  read_write = 3,  ///< The file can be read and written.
+  create = 4,  ///< The file is created if it does not exist.
+  truncate = 8,  ///< The content of the file is discarded when opening it for writing.
+  append = 16,  ///< Writes at the current position always go to the end of the file.
+  exclusive = 32,  ///< With create, opening fails if the file exists.
+  /// Bypass the page cache, with O_DIRECT on Linux and F_NOCACHE on macOS. On Linux, buffers,
+  /// sizes and positions must then be aligned, see direct_writer, and opening fails with
+  /// std::errc::invalid_argument on filesystems that do not support it.
+  direct = 64
+};
+
+/// \cond
+constexpr open_flags operator&(open_flags a, open_flags b) noexcept
+{
+  return static_cast<open_flags>(static_cast<unsigned>(a) & static_cast<unsigned>(b));
+}
+
+constexpr open_flags operator|(open_flags a, open_flags b) noexcept
+{
+  return static_cast<open_flags>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+}
+/// \endcond
+
+/// How the content of a file is going to be accessed, see posix_fadvise().
+enum class file_advice
+{
+  normal,  ///< No particular pattern, the default read-ahead.
+  sequential,  ///< In order, so pages can be read ahead aggressively.
+  random,  ///< In no particular order, so read-ahead would be wasted.
+  willneed,  ///< Soon, so reading the pages can start right away.
+  dontneed,  ///< Not again, so the cached pages can be dropped once written back.
+  noreuse  ///< Only once.
+};
+
+/// A range of memory to write from, with the layout of struct iovec.
+struct const_buffer
+{
+  const void * data;
+  size_t size;
+};
+
+/// A range of memory to read into, with the layout of struct iovec.
+struct mutable_buffer
+{
+  void * data;
+  size_t size;
+};
+
+/**
+ * \brief An open file, closed on destruction.
+ *
+ * Reads and writes go straight to the descriptor, without buffering. The positional functions
+ * do not use nor move the position of the file, so several threads can use them at once.
+ * The vectored functions gather or scatter several buffers with a single system call, which
+ * saves copying them into one staging buffer, for instance a header, a payload and a trailer.
+ *
+ * Only opening the file throws. The other functions report failures through an error code and
+ * never allocate, so they can be used in loops writing records.
+ * Reads and writes are retried until all bytes are transferred, so they only transfer fewer
+ * bytes than requested on error, or when reading reaches the end of the file.
+ *
+ * On Windows files cannot be opened, and every operation fails with
+ * std::errc::function_not_supported.
+ */
+class file
+{
+public:
+  /// Construct an object that refers to no file.
+  file() noexcept = default;
+
+  /**
+   * \brief Open a file.
+   *
+   * \param[in] p The file to open.
+   * \param[in] flags How to open the file, which must include read, write or both.
+   * \throws std::system_error if the file cannot be opened.
+   */
+  RCPPUTILS_PUBLIC
+  explicit file(const path & p, open_flags flags = open_flags::read);
+
+  RCPPUTILS_PUBLIC
+  ~file();
+
+  RCPPUTILS_PUBLIC
+  file(file && other) noexcept;
+
+  RCPPUTILS_PUBLIC
+  file & operator=(file && other) noexcept;
+
+  file(const file &) = delete;
+  file & operator=(const file &) = delete;
+
+  /**
+   * \brief Open a file, closing the one open before.
+   *
+   * \param[in] p The file to open.
+   * \param[in] flags How to open the file, which must include read, write or both.
+   * \throws std::system_error if the file cannot be opened.
+   */
+  RCPPUTILS_PUBLIC
+  void open(const path & p, open_flags flags);
+
+  /**
+   * \brief Open a file, closing the one open before, reporting failures through an error code.
+   *
+   * \param[in] p The file to open.
+   * \param[in] flags How to open the file, which must include read, write or both.
+   * \param[out] ec Set to the reason of the failure, or cleared on success. The object refers
+   * to no file on failure.
+   */
+  RCPPUTILS_PUBLIC
+  void open(const path & p, open_flags flags, std::error_code & ec) noexcept;
+
+  /// Whether the object refers to a file.
+  bool is_open() const noexcept {return fd_ >= 0;}
+
+  /// The descriptor of the file, or -1 if not open.
+  int native_handle() const noexcept {return fd_;}
+
+  /// Close the file, leaving the object referring to none.
+  RCPPUTILS_PUBLIC
+  void close() noexcept;
+
+  /**
+   * \brief Close the file, reporting the failures of writes that close() detects, on NFS for
+   * instance.
+   *
+   * \param[out] ec Set to the reason of the failure, or cleared on success. The file is closed
+   * either way.
+   */
+  RCPPUTILS_PUBLIC
+  void close(std::error_code & ec) noexcept;
+
+  /**
+   * \brief Read from the current position, moving it past the bytes read.
+   *
+   * \param[out] data Where to store the bytes.
+   * \param[in] size The number of bytes to read.
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   * \return The number of bytes read, fewer than size at the end of the file or on error.
+   */
+  RCPPUTILS_PUBLIC
+  size_t read(void * data, size_t size, std::error_code & ec) noexcept;
+
+  /**
+   * \brief Write at the current position, or at the end of the file with open_flags::append.
+   *
+   * \param[in] data The bytes to write.
+   * \param[in] size The number of bytes to write.
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   * \return The number of bytes written, fewer than size only on error.
+   */
+  RCPPUTILS_PUBLIC
+  size_t write(const void * data, size_t size, std::error_code & ec) noexcept;
+
+  /**
+   * \brief Read at a position, with pread().
+   *
+   * \param[out] data Where to store the bytes.
+   * \param[in] size The number of bytes to read.
+   * \param[in] offset The position in the file to read from, in bytes.
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   * \return The number of bytes read, fewer than size at the end of the file or on error.
+   */
+  RCPPUTILS_PUBLIC
+  size_t pread(void * data, size_t size, uint64_t offset, std::error_code & ec) const noexcept;
+
+  /**
+   * \brief Write at a position, with pwrite().
+   *
+   * \param[in] data The bytes to write.
+   * \param[in] size The number of bytes to write.
+   * \param[in] offset The position in the file to write to, in bytes.
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   * \return The number of bytes written, fewer than size only on error.
+   */
+  RCPPUTILS_PUBLIC
+  size_t pwrite(
+    const void * data, size_t size, uint64_t offset, std::error_code & ec) const noexcept;
+
+  /**
+   * \brief Read from the current position into several buffers in turn, with readv().
+   *
+   * \param[in] buffers The buffers to fill, in order.
+   * \param[in] count The number of buffers.
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   * \return The number of bytes read, fewer than requested at the end of the file or on error.
+   */
+  RCPPUTILS_PUBLIC
+  size_t readv(const mutable_buffer * buffers, size_t count, std::error_code & ec) noexcept;
+
+  /// \copydoc readv(const mutable_buffer *, size_t, std::error_code &)
+  size_t readv(std::initializer_list<mutable_buffer> buffers, std::error_code & ec) noexcept
+  {
+    return readv(buffers.begin(), buffers.size(), ec);
+  }
+
+  /**
+   * \brief Write several buffers in turn at the current position, with writev().
+   *
+   * \param[in] buffers The buffers to write, in order.
+   * \param[in] count The number of buffers.
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   * \return The number of bytes written, fewer than requested only on error.
+   */
+  RCPPUTILS_PUBLIC
+  size_t writev(const const_buffer * buffers, size_t count, std::error_code & ec) noexcept;
+
+  /// \copydoc writev(const const_buffer *, size_t, std::error_code &)
+  size_t writev(std::initializer_list<const_buffer> buffers, std::error_code & ec) noexcept
+  {
+    return writev(buffers.begin(), buffers.size(), ec);
+  }
+
+  /**
+   * \brief Read at a position into several buffers in turn, with preadv() where available.
+   *
+   * \param[in] buffers The buffers to fill, in order.
+   * \param[in] count The number of buffers.
+   * \param[in] offset The position in the file to read from, in bytes.
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   * \return The number of bytes read, fewer than requested at the end of the file or on error.
+   */
+  RCPPUTILS_PUBLIC
+  size_t preadv(
+    const mutable_buffer * buffers, size_t count, uint64_t offset,
+    std::error_code & ec) const noexcept;
+
+  /**
+   * \brief Write several buffers in turn at a position, with pwritev() where available.
+   *
+   * \param[in] buffers The buffers to write, in order.
+   * \param[in] count The number of buffers.
+   * \param[in] offset The position in the file to write to, in bytes.
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   * \return The number of bytes written, fewer than requested only on error.
+   */
+  RCPPUTILS_PUBLIC
+  size_t pwritev(
+    const const_buffer * buffers, size_t count, uint64_t offset,
+    std::error_code & ec) const noexcept;
+
+  /**
+   * \brief Allocate the blocks of a range of the file, growing it if the range ends past it.
+   *
+   * Writing to the range afterwards cannot fail for lack of space, and is not slowed down by
+   * allocating blocks. Uses fallocate() on Linux, and posix_fallocate() elsewhere.
+   *
+   * \param[in] offset The position of the range in the file, in bytes.
+   * \param[in] length The size of the range in bytes.
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   */
+  RCPPUTILS_PUBLIC
+  void allocate(uint64_t offset, uint64_t length, std::error_code & ec) const noexcept;
+
+  /**
+   * \brief Resize the file, with ftruncate().
+   *
+   * \param[in] size The new size of the file in bytes.
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   */
+  RCPPUTILS_PUBLIC
+  void resize(uint64_t size, std::error_code & ec) const noexcept;
+
+  /**
+   * \brief Get the size of the file.
+   *
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   * \return The size of the file in bytes, or static_cast<uint64_t>(-1) on error.
+   */
+  RCPPUTILS_PUBLIC
+  uint64_t size(std::error_code & ec) const noexcept;
+
+  /**
+   * \brief Wait until the content of the file is on the storage, with fdatasync().
+   *
+   * Unlike sync(), metadata such as the modification time is only written if it is needed to
+   * read the content back, as the size is.
+   *
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   */
+  RCPPUTILS_PUBLIC
+  void sync_data(std::error_code & ec) const noexcept;
+
+  /**
+   * \brief Wait until the content and the metadata of the file are on the storage, with fsync().
+   *
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   */
+  RCPPUTILS_PUBLIC
+  void sync(std::error_code & ec) const noexcept;
+
+  /**
+   * \brief Tell the kernel how a range of the file is going to be accessed, with posix_fadvise().
+   *
+   * \param[in] advice The access pattern.
+   * \param[in] offset The position of the range in the file, in bytes.
+   * \param[in] length The size of the range in bytes, or 0 for up to the end of the file.
+   * \return True if the hint was taken, false if the system does not support it.
+   */
+  RCPPUTILS_PUBLIC
+  bool advise(file_advice advice, uint64_t offset = 0, uint64_t length = 0) const noexcept;
+
+private:
+  int fd_ = -1;
+};
+
+}  // namespace fs
+}  // namespace rcpputils
+
+#endif  // RCPPUTILS__FILE_HPP_
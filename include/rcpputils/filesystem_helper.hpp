@@ -39,7 +39,17 @@
 #ifndef RCPPUTILS__FILESYSTEM_HELPER_HPP_
 #define RCPPUTILS__FILESYSTEM_HELPER_HPP_
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
 #include <vector>
 
 #include "rcpputils/visibility_control.hpp"
@@ -64,16 +74,109 @@ static constexpr const char kPreferredSeparator = RCPPUTILS_IMPL_OS_DIRSEP;
 
 #undef RCPPUTILS_IMPL_OS_DIRSEP
 
+/**
+ * \brief Tag type selecting deferred component parsing when constructing a path.
+ *
+ * \sa path::path(std::string, deferred_parse_t)
+ */
+struct deferred_parse_t
+{
+  explicit deferred_parse_t() = default;
+};
+
+/// Tag value selecting deferred component parsing when constructing a path.
+inline constexpr deferred_parse_t deferred_parse{};
 
 /**
  * \brief Drop-in replacement for [std::filesystem::path](https://en.cppreference.com/w/cpp/filesystem/path).
  *
- * It must conform to the same standard described and cannot include methods that are not
- * incorporated there.
+ * It must conform to the same standard described. Methods that are not incorporated there
+ * are limited to cheaper variants of standard operations.
  */
 class path
 {
+  /// \internal Boundaries of a single component inside the path string.
+  struct component
+  {
+    uint32_t offset;
+    uint32_t length;
+  };
+
+public:
+  /**
+   * \brief Bidirectional iterator over the components of a path.
+   *
+   * Components are yielded as views into the storage of the path, so iterating does not allocate.
+   * Any operation that modifies or destroys the path invalidates its iterators.
+   */
+  class const_iterator
+  {
 public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view *;
+    using reference = const std::string_view &;
+
+    const_iterator() = default;
+
+    reference operator*() const {return current_;}
+    pointer operator->() const {return &current_;}
+
+    const_iterator & operator++()
+    {
+      ++component_;
+      update();
+      return *this;
+    }
+
+    const_iterator operator++(int)
+    {
+      const_iterator tmp(*this);
+      ++*this;
+      return tmp;
+    }
+
+    const_iterator & operator--()
+    {
+      --component_;
+      update();
+      return *this;
+    }
+
+    const_iterator operator--(int)
+    {
+      const_iterator tmp(*this);
+      --*this;
+      return tmp;
+    }
+
+    bool operator==(const const_iterator & other) const {return component_ == other.component_;}
+    bool operator!=(const const_iterator & other) const {return component_ != other.component_;}
+
+private:
+    friend class path;
+
+    const_iterator(const path * owner, const component * c)
+    : owner_(owner), component_(c)
+    {
+      update();
+    }
+
+    void update()
+    {
+      if (component_ != owner_->components_.data() + owner_->components_.size()) {
+        current_ = std::string_view(owner_->path_).substr(component_->offset, component_->length);
+      } else {
+        current_ = std::string_view();
+      }
+    }
+
+    const path * owner_ = nullptr;
+    const component * component_ = nullptr;
+    std::string_view current_;
+  };
+
   /**
     * \brief Constructs an empty path.
     */
@@ -88,17 +191,75 @@ public:
   RCPPUTILS_PUBLIC
   path(const std::string & p);  // NOLINT(runtime/explicit): this is a conversion constructor
 
+  /**
+   * \brief Conversion constructor taking over the buffer of a std::string path.
+   *
+   * \param[in] p A string path split by the platform's string path separator.
+   */
+  RCPPUTILS_PUBLIC
+  path(std::string && p);  // NOLINT(runtime/explicit): this is a conversion constructor
+
+  /**
+   * \brief Conversion constructor from a std::string_view path.
+   *
+   * \param[in] p A string path split by the platform's string path separator.
+   */
+  RCPPUTILS_PUBLIC
+  path(std::string_view p);  // NOLINT(runtime/explicit): this is a conversion constructor
+
+  /**
+   * \brief Conversion constructor from a null-terminated string path.
+   *
+   * \param[in] p A string path split by the platform's string path separator.
+   */
+  RCPPUTILS_PUBLIC
+  path(const char * p);  // NOLINT(runtime/explicit): this is a conversion constructor
+
+  /**
+   * \brief Construct a path whose components are only parsed when first needed.
+   *
+   * Separators are normalized right away, so string(), exists(), is_directory() and the other
+   * queries that only need the full path cost no more than a string copy. Splitting the path
+   * into components is deferred to the first call to cbegin() or cend().
+   *
+   * The components are published atomically, so a const path can still be shared between
+   * threads, the first one to iterate parsing it while the others wait.
+   *
+   * \param[in] p A string path split by the platform's string path separator.
+   */
+  RCPPUTILS_PUBLIC
+  path(std::string p, deferred_parse_t);
+
   /**
     * \brief Copy constructor.
     */
-  RCPPUTILS_PUBLIC path(const path & p) = default;
+  RCPPUTILS_PUBLIC path(const path & p);
 
   /**
    * \brief Copy assignment operator.
    *
    * \return Reference to the copied path.
    */
-  RCPPUTILS_PUBLIC path & operator=(const path &) = default;
+  RCPPUTILS_PUBLIC path & operator=(const path & p);
+
+  /**
+    * \brief Move constructor.
+    */
+  RCPPUTILS_PUBLIC path(path && p) noexcept;
+
+  /**
+   * \brief Move assignment operator.
+   *
+   * \return Reference to the assigned path.
+   */
+  RCPPUTILS_PUBLIC path & operator=(path && p) noexcept;
+
+  /**
+   * \brief Get the path in its native format without copying it.
+   *
+   * \return A reference to the path string, valid until this path is modified or destroyed.
+   */
+  RCPPUTILS_PUBLIC const std::string & native() const noexcept;
 
   /**
    * \brief Get the path delimited using this system's path separator.
@@ -136,6 +297,14 @@ public:
   */
   RCPPUTILS_PUBLIC uint64_t file_size() const;
 
+  /**
+   * \brief Return the size of the file in bytes, reporting failures through an error code.
+   *
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   * \return The size of the file in bytes, or static_cast<uint64_t>(-1) on error.
+   */
+  RCPPUTILS_PUBLIC uint64_t file_size(std::error_code & ec) const noexcept;
+
   /**
   * \brief Check if the path is empty.
   *
@@ -150,19 +319,34 @@ public:
   */
   RCPPUTILS_PUBLIC bool is_absolute() const;
 
+  /**
+  * \brief Compare this path with another one, component by component.
+  *
+  * Components are compared as strings, so the order matches a sort of the components
+  * themselves: "a/b" comes before "a-b", although '/' comes after '-'. Paths with the same
+  * components but different separators, as "a//b" and "a/b", are ordered rather than equal, so
+  * the order is consistent with operator==(). No allocation is made.
+  * See https://en.cppreference.com/w/cpp/filesystem/path/compare
+  *
+  * \param[in] other The path to compare with.
+  * \return A negative value if this path comes first, 0 if both are equal, a positive value
+  * otherwise.
+  */
+  RCPPUTILS_PUBLIC int compare(const path & other) const noexcept;
+
   /**
   * \brief Const iterator to first element of this path.
   *
   * \return A const iterator to the first element.
   */
-  RCPPUTILS_PUBLIC std::vector<std::string>::const_iterator cbegin() const;
+  RCPPUTILS_PUBLIC const_iterator cbegin() const;
 
   /**
   * Const iterator to one past the last element of this path.
   *
   * return A const iterator to one past the last element of the path.
   */
-  RCPPUTILS_PUBLIC std::vector<std::string>::const_iterator cend() const;
+  RCPPUTILS_PUBLIC const_iterator cend() const;
 
   /**
   * \brief Get the parent directory of this path.
@@ -171,6 +355,16 @@ public:
   */
   RCPPUTILS_PUBLIC path parent_path() const;
 
+  /**
+  * \brief Get the parent directory of this path without allocating.
+  *
+  * Unlike parent_path(), a relative path with a single component yields an empty view rather
+  * than ".", since there is no parent to refer to inside this path.
+  *
+  * \return A view of the leading part of this path naming the parent directory.
+  */
+  RCPPUTILS_PUBLIC std::string_view parent_path_view() const noexcept;
+
   /**
   * \brief Get the last element in this path.
   *
@@ -180,20 +374,109 @@ public:
   */
   RCPPUTILS_PUBLIC path filename() const;
 
+  /**
+  * \brief Get the last element in this path without allocating.
+  *
+  * \return A view of the last element in this path.
+  */
+  RCPPUTILS_PUBLIC std::string_view filename_view() const noexcept;
+
+  /**
+  * \brief Get the filename of this path without its extension.
+  *
+  * \return The filename stripped of the extension.
+  */
+  RCPPUTILS_PUBLIC path stem() const;
+
+  /**
+  * \brief Get the filename of this path without its extension, without allocating.
+  *
+  * \return A view of the filename stripped of the extension.
+  */
+  RCPPUTILS_PUBLIC std::string_view stem_view() const noexcept;
+
   /**
   * \brief Get a relative path to the component including and following the last '.'.
   *
+  * Only the filename is considered. A filename starting with its only '.', like ".bashrc",
+  * as well as "." and "..", have no extension.
+  *
   * \return The string extension
   */
   RCPPUTILS_PUBLIC path extension() const;
 
+  /**
+  * \brief Get the extension of the filename of this path without allocating.
+  *
+  * \return A view of the extension, including the leading '.'.
+  */
+  RCPPUTILS_PUBLIC std::string_view extension_view() const noexcept;
+
+  /**
+  * \brief Get the normal form of this path, with "." and ".." components resolved lexically.
+  *
+  * Only the components are considered, without querying the filesystem, so unlike canonical()
+  * a ".." following a symlink removes the symlink rather than going to the parent of its target.
+  * Repeated separators are collapsed, and a trailing separator is kept.
+  * See https://en.cppreference.com/w/cpp/filesystem/path/lexically_normal
+  *
+  * \return The normalized path, or "." if nothing is left of a relative path.
+  */
+  RCPPUTILS_PUBLIC path lexically_normal() const;
+
+  /**
+  * \brief Get the path leading from a base to this path, comparing their components only.
+  *
+  * Both paths should be normalized first, as "." and ".." components are compared as names.
+  * See https://en.cppreference.com/w/cpp/filesystem/path/lexically_relative
+  *
+  * \param[in] base The path to start from.
+  * \return The relative path, "." if both are equal, or an empty path if their roots differ or
+  * the base has more ".." components than can be undone.
+  */
+  RCPPUTILS_PUBLIC path lexically_relative(const path & base) const;
+
+  /**
+  * \brief Get the path leading from a base to this path, or this path if there is none.
+  *
+  * See https://en.cppreference.com/w/cpp/filesystem/path/lexically_proximate
+  *
+  * \param[in] base The path to start from.
+  * \return lexically_relative(base) if it is not empty, this path otherwise.
+  */
+  RCPPUTILS_PUBLIC path lexically_proximate(const path & base) const;
+
   /**
   * \brief Concatenate a path and a string into a single path.
   *
   * \param[in] other the string compnoent to concatenate
   * \return The combined path of this and other.
   */
-  RCPPUTILS_PUBLIC path operator/(const std::string & other) const;
+  RCPPUTILS_PUBLIC path operator/(const std::string & other) const &;
+
+  /**
+  * \brief Concatenate a path and a string into a single path, reusing the storage of this path.
+  *
+  * \param[in] other the string component to concatenate
+  * \return The combined path of this and other.
+  */
+  RCPPUTILS_PUBLIC path operator/(const std::string & other) &&;
+
+  /**
+  * \brief Concatenate a path and a null-terminated string into a single path.
+  *
+  * \param[in] other the string component to concatenate
+  * \return The combined path of this and other.
+  */
+  RCPPUTILS_PUBLIC path operator/(const char * other) const &;
+
+  /**
+  * \brief Concatenate a path and a null-terminated string, reusing the storage of this path.
+  *
+  * \param[in] other the string component to concatenate
+  * \return The combined path of this and other.
+  */
+  RCPPUTILS_PUBLIC path operator/(const char * other) &&;
 
   /**
   * \brief Append a string component to this path.
@@ -203,13 +486,29 @@ public:
   */
   RCPPUTILS_PUBLIC path & operator/=(const std::string & other);
 
+  /**
+  * \brief Append a null-terminated string component to this path.
+  *
+  * \param[in] other the string component to append
+  * \return *this
+  */
+  RCPPUTILS_PUBLIC path & operator/=(const char * other);
+
   /**
   * \brief Concatenate two paths together.
   *
   * \param[in] other the path to append
   * \return The combined path.
   */
-  RCPPUTILS_PUBLIC path operator/(const path & other) const;
+  RCPPUTILS_PUBLIC path operator/(const path & other) const &;
+
+  /**
+  * \brief Concatenate two paths together, reusing the storage of this path.
+  *
+  * \param[in] other the path to append
+  * \return The combined path.
+  */
+  RCPPUTILS_PUBLIC path operator/(const path & other) &&;
 
   /**
   * \brief Append a string component to this path.
@@ -220,131 +519,1354 @@ public:
   RCPPUTILS_PUBLIC path & operator/=(const path & other);
 
 private:
+  /// \internal Append a string component in place, see operator/=.
+  void append(std::string_view other);
+
+  /// \internal Copy this path into a new one with room for `extra` more characters.
+  path copy_with_capacity(size_t extra) const;
+
+  /// \internal Record the components of path_ starting at character position `from`.
+  void parse_components(size_t from) const;
+
+  /// \internal Build the component table of a path constructed with deferred_parse.
+  void ensure_parsed() const;
+
+  /// \internal Whether components_ is up to date, acquired before reading it.
+  bool is_parsed() const noexcept;
+
+  /// \internal The progress of the component table of a path constructed with deferred_parse.
+  enum class parse_state : unsigned char
+  {
+    unparsed,
+    parsing,
+    parsed
+  };
+
   std::string path_;
-  std::vector<std::string> path_as_vector_;
+  mutable std::vector<component> components_;
+  // Released once components_ is built, since a const path may be parsed by any thread using it
+  mutable std::atomic<parse_state> parse_state_{parse_state::parsed};
 };
 
 /**
- * \brief Check if the path is a regular file.
+ * \brief Drop-in replacement for std::filesystem::file_type.
  *
- * \param[in] p The path to check
- * \return True if the path exists, false otherwise.
+ * See https://en.cppreference.com/w/cpp/filesystem/file_type
  */
-RCPPUTILS_PUBLIC bool is_regular_file(const path & p) noexcept;
+enum class file_type
+{
+  none,  ///< The status could not be determined.
+  not_found,  ///< The file does not exist.
+  regular,
+  directory,
+  symlink,
+  block,
+  character,
+  fifo,
+  socket,
+  unknown  ///< The file exists but its type is not one of the above.
+};
 
 /**
- * \brief Check if the path is a directory.
+ * \brief Drop-in replacement for std::filesystem::perms.
  *
- * \param[in] p The path to check
- * \return True if the path is an existing directory, false otherwise.
+ * See https://en.cppreference.com/w/cpp/filesystem/perms
  */
-RCPPUTILS_PUBLIC bool is_directory(const path & p) noexcept;
+enum class perms : unsigned
+{
+  none = 0,
+  owner_read = 0400,
+  owner_write = 0200,
+  owner_exec = 0100,
+  owner_all = 0700,
+  group_read = 040,
+  group_write = 020,
+  group_exec = 010,
+  group_all = 070,
+  others_read = 04,
+  others_write = 02,
+  others_exec = 01,
+  others_all = 07,
+  all = 0777,
+  set_uid = 04000,
+  set_gid = 02000,
+  sticky_bit = 01000,
+  mask = 07777,
+  unknown = 0xFFFF
+};
+
+/// \cond
+constexpr perms operator&(perms a, perms b) noexcept
+{
+  return static_cast<perms>(static_cast<unsigned>(a) & static_cast<unsigned>(b));
+}
+
+constexpr perms operator|(perms a, perms b) noexcept
+{
+  return static_cast<perms>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+}
+/// \endcond
+
+/// Time point used for file modification times, with the resolution reported by the OS.
+using file_time_type =
+  std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds>;
 
 /**
- * \brief Get the file size of the path.
- *
- * \param[in] p The path to get the file size of.
- * \return The file size in bytes.
+ * \brief The result of a single status query on a path.
  *
- * \throws std::sytem_error
+ * Like [std::filesystem::file_status](https://en.cppreference.com/w/cpp/filesystem/file_status)
+ * it holds the type and permissions of a file, and additionally all the other attributes that
+ * the same syscall returns, so that further queries on the same file are free.
  */
-RCPPUTILS_PUBLIC uint64_t file_size(const path & p);
+class file_status
+{
+public:
+  /// Construct the status of a file whose status is unknown.
+  file_status() noexcept = default;
+
+  /**
+   * \brief Construct a status from its attributes.
+   *
+   * \param[in] type The type of the file.
+   * \param[in] permissions The permission bits of the file.
+   * \param[in] size The size of the file in bytes.
+   * \param[in] last_write_time The time of the last modification of the file.
+   * \param[in] inode The inode number of the file.
+   * \param[in] device The identifier of the device containing the file.
+   */
+  explicit file_status(
+    file_type type, perms permissions = perms::unknown, uint64_t size = 0,
+    file_time_type last_write_time = file_time_type(), uint64_t inode = 0,
+    uint64_t device = 0) noexcept
+  : type_(type), permissions_(permissions), size_(size), last_write_time_(last_write_time),
+    inode_(inode), device_(device)
+  {
+  }
+
+  /// The type of the file.
+  file_type type() const noexcept {return type_;}
+
+  /// The permission bits of the file.
+  perms permissions() const noexcept {return permissions_;}
+
+  /// The size of the file in bytes.
+  uint64_t size() const noexcept {return size_;}
+
+  /// The time of the last modification of the file.
+  file_time_type last_write_time() const noexcept {return last_write_time_;}
+
+  /// The inode number of the file, or 0 where the OS does not provide one.
+  uint64_t inode() const noexcept {return inode_;}
+
+  /// The identifier of the device containing the file.
+  uint64_t device() const noexcept {return device_;}
+
+private:
+  file_type type_ = file_type::none;
+  perms permissions_ = perms::unknown;
+  uint64_t size_ = 0;
+  file_time_type last_write_time_;
+  uint64_t inode_ = 0;
+  uint64_t device_ = 0;
+};
 
 /**
- * \brief Check if a path exists.
+ * \brief Query the status of a path with a single stat call, following symlinks.
  *
- * \param[in] path_to_check The path to check.
- * \return True if the path exists, false otherwise.
+ * \param[in] p The path to query.
+ * \return The status of the file, whose type is file_type::not_found if it does not exist.
+ * \throws std::system_error if the status cannot be determined for another reason.
  */
-RCPPUTILS_PUBLIC bool exists(const path & path_to_check);
-
+RCPPUTILS_PUBLIC file_status status(const path & p);
 
 /**
- * \brief Get a path to a location in the temporary directory, if it's available.
+ * \brief Query the status of a path, following symlinks, reporting failures through an error code.
  *
- * This does not create any directories.
- * On Windows, this uses "GetTempPathA"
- * On non-Windows, this prefers the environment variable TMPDIR, falling back to /tmp
+ * A path that does not exist is not a failure, as for status(const path &).
  *
- * \return A path to a directory for storing temporary files and directories.
+ * \param[in] p The path to query.
+ * \param[out] ec Set to the reason of the failure, or cleared on success.
+ * \return The status of the file, whose type is file_type::none on error.
  */
-RCPPUTILS_PUBLIC path temp_directory_path();
+RCPPUTILS_PUBLIC file_status status(const path & p, std::error_code & ec) noexcept;
 
 /**
- * \brief Construct a uniquely named temporary directory, in "parent", with format base_nameXXXXXX
- *
- * The output, if successful, is guaranteed to be a newly-created directory.
- * The underlying implementation keeps generating paths until one that does not exist is found.
- * This guarantees that there will be no existing files in the returned directory.
+ * \brief Query the status of a path with a single lstat call, not following symlinks.
  *
- * \param[in] base_name User-specified portion of the created directory
- * \param[in] parent_path The parent path of the directory that will be created
- * \return A path to a newly-created directory with base_name and a 6-character unique suffix
+ * On Windows, this is equivalent to status().
  *
- * \throws std::system_error If any OS APIs do not succeed.
+ * \param[in] p The path to query.
+ * \return The status of the file, whose type is file_type::not_found if it does not exist.
+ * \throws std::system_error if the status cannot be determined for another reason.
  */
-RCPPUTILS_PUBLIC path create_temp_directory(
-  const std::string & base_name,
-  const path & parent_path = temp_directory_path());
+RCPPUTILS_PUBLIC file_status symlink_status(const path & p);
 
 /**
- * \brief Return current working directory.
- *
- * \return The current working directory.
+ * \brief Query the status of a path itself, reporting failures through an error code.
  *
- * \throws std::system_error
+ * \sa status(const path &, std::error_code &)
  */
-RCPPUTILS_PUBLIC path current_path();
+RCPPUTILS_PUBLIC file_status symlink_status(const path & p, std::error_code & ec) noexcept;
 
 /**
- * \brief Create a directory with the given path p.
+ * \brief Resolve a path to an absolute one without symlinks, "." or ".." components.
  *
- * This builds directories recursively and will skip directories if they are already created.
- * \param[in] p The path at which to create the directory.
- * \return Return true if the directory already exists or is created, false otherwise.
+ * \param[in] p The path to resolve, relative to the current working directory if not absolute.
+ * \return The resolved path.
+ * \throws std::system_error if the path does not exist or cannot be resolved.
  */
-RCPPUTILS_PUBLIC bool create_directories(const path & p);
+RCPPUTILS_PUBLIC path canonical(const path & p);
 
 /**
- * \brief Remove the file or directory at the path p.
+ * \brief Resolve a path like canonical(const path &), reporting failures through an error code.
  *
- * \param[in] p The path of the object to remove.
- * \return true if the file exists and it was successfully removed, false otherwise.
+ * \param[in] p The path to resolve, relative to the current working directory if not absolute.
+ * \param[out] ec Set to the reason of the failure, or cleared on success.
+ * \return The resolved path, or an empty path on error.
  */
-RCPPUTILS_PUBLIC bool remove(const path & p);
+RCPPUTILS_PUBLIC path canonical(const path & p, std::error_code & ec);
 
 /**
- * \brief Remove the directory at the path p and its content.
+ * \brief Resolves many paths with canonical(), remembering the directories already resolved.
  *
- * Additionally to \sa remove, remove_all removes a directory and its containing files.
+ * Each directory is resolved from its resolved parent, so a directory that was not seen yet costs
+ * a single lstat call unless it is a symlink, and paths in a directory that was seen cost a single
+ * lstat call for their last component. Resolving many paths under a shared root thus avoids
+ * walking all their components with realpath() every time.
  *
- * \param[in] p The path of the directory to remove.
- * \return true if the directory exists and it was successfully removed, false otherwise.
+ * The directories are assumed not to be moved or replaced while they are cached; clear() drops
+ * them after such a change. The cache can be used from several threads.
  */
-RCPPUTILS_PUBLIC bool remove_all(const path & p);
+class canonical_cache
+{
+public:
+  /// Construct an empty cache.
+  RCPPUTILS_PUBLIC canonical_cache();
+
+  RCPPUTILS_PUBLIC ~canonical_cache();
+
+  canonical_cache(const canonical_cache &) = delete;
+  canonical_cache & operator=(const canonical_cache &) = delete;
+
+  /**
+   * \brief Resolve a path like canonical() does.
+   *
+   * \param[in] p The path to resolve, relative to the current working directory if not absolute.
+   * \return The resolved path.
+   * \throws std::system_error if the path does not exist or cannot be resolved.
+   */
+  RCPPUTILS_PUBLIC path canonical(const path & p);
+
+  /**
+   * \brief Resolve a path like canonical() does, reporting failures through an error code.
+   *
+   * \param[in] p The path to resolve, relative to the current working directory if not absolute.
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   * \return The resolved path, or an empty path on error.
+   */
+  RCPPUTILS_PUBLIC path canonical(const path & p, std::error_code & ec);
+
+  /// The number of directories resolved so far.
+  RCPPUTILS_PUBLIC size_t size() const;
+
+  /// Forget the directories resolved so far.
+  RCPPUTILS_PUBLIC void clear();
+
+private:
+  struct impl;
+  std::unique_ptr<impl> impl_;
+};
 
 /**
- * \brief Remove extension(s) from a path.
+ * \brief Check if the status is known, i.e. it is not file_type::none.
  *
- * An extension is defined as text starting from the end of a path to the first period (.) character.
+ * \param[in] s The status to check.
+ * \return True if the status is known, false otherwise.
+ */
+RCPPUTILS_PUBLIC bool status_known(const file_status & s) noexcept;
+
+/**
+ * \brief Check if the path is a regular file.
  *
- * \param[in] file_path The file path string.
- * \param[in] n_times The number of extensions to remove if there are multiple extensions.
- * \return The path object.
+ * \param[in] p The path to check
+ * \return True if the path exists, false otherwise.
  */
-RCPPUTILS_PUBLIC path remove_extension(const path & file_path, int n_times = 1);
+RCPPUTILS_PUBLIC bool is_regular_file(const path & p) noexcept;
 
 /**
- * \brief Compare two paths for equality.
+ * \brief Check if the path is a regular file, reporting failures through an error code.
  *
- * \return True if both paths are equal as strings.
+ * \param[in] p The path to check
+ * \param[out] ec Set to the reason the path cannot be queried, or cleared if it can.
+ * \return True if the path is an existing regular file, false otherwise or on error.
  */
-RCPPUTILS_PUBLIC bool operator==(const path & a, const path & b);
-RCPPUTILS_PUBLIC bool operator!=(const path & a, const path & b);
+RCPPUTILS_PUBLIC bool is_regular_file(const path & p, std::error_code & ec) noexcept;
 
 /**
-* \brief Convert the path to a string for ostream usage, such as in logging or string formatting.
-*
+ * \brief Check if a queried status is the one of a regular file.
+ *
+ * \param[in] s The status to check
+ * \return True if the status is the one of an existing regular file, false otherwise.
+ */
+RCPPUTILS_PUBLIC bool is_regular_file(const file_status & s) noexcept;
+
+/**
+ * \brief Check if the path is a directory.
+ *
+ * \param[in] p The path to check
+ * \return True if the path is an existing directory, false otherwise.
+ */
+RCPPUTILS_PUBLIC bool is_directory(const path & p) noexcept;
+
+/**
+ * \brief Check if the path is a directory, reporting failures through an error code.
+ *
+ * \param[in] p The path to check
+ * \param[out] ec Set to the reason the path cannot be queried, or cleared if it can.
+ * \return True if the path is an existing directory, false otherwise or on error.
+ */
+RCPPUTILS_PUBLIC bool is_directory(const path & p, std::error_code & ec) noexcept;
+
+/**
+ * \brief Check if a queried status is the one of a directory.
+ *
+ * \param[in] s The status to check
+ * \return True if the status is the one of an existing directory, false otherwise.
+ */
+RCPPUTILS_PUBLIC bool is_directory(const file_status & s) noexcept;
+
+/**
+ * \brief Check if the path is a symbolic link, without following it.
+ *
+ * \param[in] p The path to check
+ * \return True if the path is an existing symbolic link, false otherwise.
+ */
+RCPPUTILS_PUBLIC bool is_symlink(const path & p) noexcept;
+
+/**
+ * \brief Check if the path is a symbolic link, reporting failures through an error code.
+ *
+ * \param[in] p The path to check
+ * \param[out] ec Set to the reason the path cannot be queried, or cleared if it can.
+ * \return True if the path is an existing symbolic link, false otherwise or on error.
+ */
+RCPPUTILS_PUBLIC bool is_symlink(const path & p, std::error_code & ec) noexcept;
+
+/**
+ * \brief Check if a queried status is the one of a symbolic link.
+ *
+ * Only a status obtained with symlink_status() can be the one of a symbolic link.
+ *
+ * \param[in] s The status to check
+ * \return True if the status is the one of a symbolic link, false otherwise.
+ */
+RCPPUTILS_PUBLIC bool is_symlink(const file_status & s) noexcept;
+
+/**
+ * \brief Get the file size of the path.
+ *
+ * \param[in] p The path to get the file size of.
+ * \return The file size in bytes.
+ *
+ * \throws std::sytem_error
+ */
+RCPPUTILS_PUBLIC uint64_t file_size(const path & p);
+
+/**
+ * \brief Get the file size of the path, reporting failures through an error code.
+ *
+ * \param[in] p The path to get the file size of.
+ * \param[out] ec Set to the reason of the failure, or cleared on success.
+ * \return The file size in bytes, or static_cast<uint64_t>(-1) on error.
+ */
+RCPPUTILS_PUBLIC uint64_t file_size(const path & p, std::error_code & ec) noexcept;
+
+/**
+ * \brief Get the file size from a queried status.
+ *
+ * \param[in] s The status of the file.
+ * \return The file size in bytes.
+ *
+ * \throws std::system_error if the status is not the one of an existing file, or of a directory.
+ */
+RCPPUTILS_PUBLIC uint64_t file_size(const file_status & s);
+
+/**
+ * \brief Get the file size from a queried status, reporting failures through an error code.
+ *
+ * \param[in] s The status of the file.
+ * \param[out] ec Set to the reason of the failure, or cleared on success.
+ * \return The file size in bytes, or static_cast<uint64_t>(-1) on error.
+ */
+RCPPUTILS_PUBLIC uint64_t file_size(const file_status & s, std::error_code & ec) noexcept;
+
+/**
+ * \brief Check if a path exists.
+ *
+ * \param[in] path_to_check The path to check.
+ * \return True if the path exists, false otherwise.
+ */
+RCPPUTILS_PUBLIC bool exists(const path & path_to_check);
+
+/**
+ * \brief Check if a path exists, telling apart a missing path from one that cannot be queried.
+ *
+ * \param[in] path_to_check The path to check.
+ * \param[out] ec Set to the reason the path cannot be queried, or cleared if it can.
+ * \return True if the path exists, false if it does not or on error.
+ */
+RCPPUTILS_PUBLIC bool exists(const path & path_to_check, std::error_code & ec) noexcept;
+
+/**
+ * \brief Check if a queried status is the one of an existing file.
+ *
+ * \param[in] s The status to check.
+ * \return True if the status is known and the file exists, false otherwise.
+ */
+RCPPUTILS_PUBLIC bool exists(const file_status & s) noexcept;
+
+
+/**
+ * \brief Get a path to a location in the temporary directory, if it's available.
+ *
+ * This does not create any directories.
+ * On Windows, this uses "GetTempPathA"
+ * On non-Windows, this prefers the environment variable TMPDIR, falling back to /tmp
+ *
+ * \return A path to a directory for storing temporary files and directories.
+ */
+RCPPUTILS_PUBLIC path temp_directory_path();
+
+/**
+ * \brief Get the temporary directory like temp_directory_path(), reporting failures through an
+ * error code.
+ *
+ * \param[out] ec Set to the reason of the failure, or cleared on success.
+ * \return A path to a directory for storing temporary files, or an empty path on error.
+ */
+RCPPUTILS_PUBLIC path temp_directory_path(std::error_code & ec);
+
+/**
+ * \brief Construct a uniquely named temporary directory, in "parent", with format base_nameXXXXXX
+ *
+ * The output, if successful, is guaranteed to be a newly-created directory.
+ * The underlying implementation keeps generating paths until one that does not exist is found.
+ * This guarantees that there will be no existing files in the returned directory.
+ *
+ * \param[in] base_name User-specified portion of the created directory
+ * \param[in] parent_path The parent path of the directory that will be created
+ * \return A path to a newly-created directory with base_name and a 6-character unique suffix
+ *
+ * \throws std::system_error If any OS APIs do not succeed.
+ */
+RCPPUTILS_PUBLIC path create_temp_directory(
+  const std::string & base_name,
+  const path & parent_path = temp_directory_path());
+
+/**
+ * \brief Construct a uniquely named temporary directory, reporting failures through an error code.
+ *
+ * \param[in] base_name User-specified portion of the created directory
+ * \param[in] parent_path The parent path of the directory that will be created
+ * \param[out] ec Set to the reason of the failure, or cleared on success.
+ * \return A path to a newly-created directory, or an empty path on error.
+ */
+RCPPUTILS_PUBLIC path create_temp_directory(
+  const std::string & base_name, const path & parent_path, std::error_code & ec);
+
+/// Options for read_file().
+struct read_options
+{
+  /// Hint the kernel to read ahead aggressively, with posix_fadvise().
+  bool sequential = true;
+  /// Don't update the access time of the file, where the caller is allowed to (Linux only).
+  bool no_atime = false;
+  /// Copy files at least this large from a mapping rather than reading them, 0 to never map.
+  uint64_t mmap_threshold = 0;
+  /// The most bytes requested by a single read() call.
+  size_t max_read_size = size_t{1} << 30;
+};
+
+/**
+ * \brief Read the whole content of a file.
+ *
+ * The size of the file is queried once to allocate the result exactly, and the content is
+ * read into it directly. Files that do not report their size, like those in /proc, are read
+ * until their end all the same.
+ *
+ * \param[in] p The file to read.
+ * \param[in] options How to read the file.
+ * \return The content of the file.
+ * \throws std::system_error if the file cannot be opened or read.
+ */
+RCPPUTILS_PUBLIC std::string read_file(const path & p, const read_options & options = {});
+
+/**
+ * \brief Read the whole content of a file, as bytes.
+ *
+ * \sa read_file()
+ */
+RCPPUTILS_PUBLIC std::vector<std::byte> read_file_bytes(
+  const path & p, const read_options & options = {});
+
+/**
+ * \brief Read the whole content of a file, reporting failures through an error code.
+ *
+ * \param[in] p The file to read.
+ * \param[in] options How to read the file.
+ * \param[out] ec Set to the reason of the failure, or cleared on success.
+ * \return The content of the file, or an empty string on error.
+ */
+RCPPUTILS_PUBLIC std::string read_file(
+  const path & p, const read_options & options, std::error_code & ec);
+
+/**
+ * \brief Read the whole content of a file as bytes, reporting failures through an error code.
+ *
+ * \sa read_file(const path &, const read_options &, std::error_code &)
+ */
+RCPPUTILS_PUBLIC std::vector<std::byte> read_file_bytes(
+  const path & p, const read_options & options, std::error_code & ec);
+
+/**
+ * \brief Replace the whole content of a file, creating it if needed.
+ *
+ * Unlike atomic_write(), readers may see a partially written file.
+ *
+ * \param[in] p The file to write.
+ * \param[in] data The new content of the file.
+ * \throws std::system_error if the file cannot be opened or written.
+ */
+RCPPUTILS_PUBLIC void write_file(const path & p, std::string_view data);
+
+/**
+ * \brief Replace the whole content of a file with bytes, creating it if needed.
+ *
+ * \sa write_file()
+ */
+RCPPUTILS_PUBLIC void write_file(const path & p, const std::vector<std::byte> & data);
+
+/**
+ * \brief Replace the whole content of a file, reporting failures through an error code.
+ *
+ * \param[in] p The file to write.
+ * \param[in] data The new content of the file.
+ * \param[out] ec Set to the reason of the failure, or cleared on success.
+ */
+RCPPUTILS_PUBLIC void write_file(const path & p, std::string_view data, std::error_code & ec);
+
+/**
+ * \brief Replace the whole content of a file with bytes, reporting failures through an error code.
+ *
+ * \sa write_file(const path &, std::string_view, std::error_code &)
+ */
+RCPPUTILS_PUBLIC void write_file(
+  const path & p, const std::vector<std::byte> & data, std::error_code & ec);
+
+/// How much of a write atomic_write() makes sure survives a power loss.
+enum class durability
+{
+  none,  ///< No sync: readers see the old or the new content, but a crash may lose both.
+  data,  ///< The new content is synced with fdatasync() before it replaces the old one.
+  full  ///< The content is synced with fsync(), then the directory once the file is renamed.
+};
+
+/**
+ * \brief Replace the content of a file, so that readers see either the old or the new content.
+ *
+ * The data is written to a temporary file in the same directory, synced as requested, and then
+ * renamed over the file. On Windows, the directory cannot be synced, so durability::full is
+ * the same as durability::data. On POSIX systems, the temporary file is given the permissions of
+ * the file it replaces, and its owner if allowed to.
+ *
+ * \param[in] p The file to write.
+ * \param[in] data The new content of the file.
+ * \param[in] level How much of the write must survive a power loss when this returns.
+ * \throws std::system_error if the file cannot be written, synced or renamed. The temporary
+ * file is removed then, and p is left untouched.
+ */
+RCPPUTILS_PUBLIC void atomic_write(
+  const path & p, std::string_view data, durability level = durability::full);
+
+/**
+ * \brief Replace the content of a file atomically, reporting failures through an error code.
+ *
+ * \param[in] p The file to write.
+ * \param[in] data The new content of the file.
+ * \param[in] level How much of the write must survive a power loss when this returns.
+ * \param[out] ec Set to the reason of the failure, or cleared on success. The temporary file
+ * is removed on failure, and p is left untouched.
+ */
+RCPPUTILS_PUBLIC void atomic_write(
+  const path & p, std::string_view data, durability level, std::error_code & ec);
+
+/**
+ * \brief Several atomic_write() calls committed together, sharing their directory syncs.
+ *
+ * Each file is written to a temporary file and synced when added. Committing renames them all
+ * over their targets, and then syncs each of their directories once, instead of once per file.
+ * Files can be added from several threads. Files that are not committed are discarded.
+ */
+class atomic_write_batch
+{
+public:
+  /**
+   * \brief Construct an empty batch.
+   *
+   * \param[in] level How much of the writes must survive a power loss once committed.
+   */
+  RCPPUTILS_PUBLIC explicit atomic_write_batch(durability level = durability::full);
+
+  /// Discard the files that were not committed.
+  RCPPUTILS_PUBLIC ~atomic_write_batch();
+
+  atomic_write_batch(const atomic_write_batch &) = delete;
+  atomic_write_batch & operator=(const atomic_write_batch &) = delete;
+
+  /**
+   * \brief Write the new content of a file, to replace the old one on commit().
+   *
+   * \param[in] p The file to write.
+   * \param[in] data The new content of the file.
+   * \throws std::system_error if the temporary file cannot be written or synced.
+   */
+  RCPPUTILS_PUBLIC void add(const path & p, std::string_view data);
+
+  /**
+   * \brief Write the new content of a file, reporting failures through an error code.
+   *
+   * \param[in] p The file to write.
+   * \param[in] data The new content of the file.
+   * \param[out] ec Set to the reason of the failure, or cleared on success.
+   */
+  RCPPUTILS_PUBLIC void add(const path & p, std::string_view data, std::error_code & ec);
+
+  /**
+   * \brief Replace all the files added so far, and sync their directories.
+   *
+   * \throws std::system_error if a file cannot be renamed or a directory cannot be synced.
+   * The files added after the failed one are discarded.
+   */
+  RCPPUTILS_PUBLIC void commit();
+
+  /**
+   * \brief Replace all the files added so far, reporting failures through an error code.
+   *
+   * \param[out] ec Set to the reason of the failure, or cleared on success. The files added
+   * after the failed one are discarded.
+   */
+  RCPPUTILS_PUBLIC void commit(std::error_code & ec);
+
+private:
+  struct impl;
+  std::unique_ptr<impl> impl_;
+};
+
+/**
+ * \brief Return current working directory.
+ *
+ * \return The current working directory.
+ *
+ * \throws std::system_error
+ */
+RCPPUTILS_PUBLIC path current_path();
+
+/**
+ * \brief Return current working directory, reporting failures through an error code.
+ *
+ * \param[out] ec Set to the reason of the failure, or cleared on success.
+ * \return The current working directory, or an empty path on error.
+ */
+RCPPUTILS_PUBLIC path current_path(std::error_code & ec);
+
+/**
+ * \brief Create a directory with the given path p.
+ *
+ * This builds directories recursively and will skip directories if they are already created.
+ * \param[in] p The path at which to create the directory.
+ * \return Return true if the directory already exists or is created, false otherwise.
+ */
+RCPPUTILS_PUBLIC bool create_directories(const path & p);
+
+/**
+ * \brief Create a directory with the given path p, telling whether it was created.
+ *
+ * The path is probed backwards from its end, so that a directory that already exists costs a
+ * single stat call. On POSIX systems, the missing directories are created with mkdirat()
+ * relative to their parent, without resolving the path from the root for each of them.
+ *
+ * \param[in] p The path at which to create the directory.
+ * \param[out] ec Set to the reason of the failure, or cleared on success.
+ * \return True if any directory was created, false if p already was a directory or on error.
+ */
+RCPPUTILS_PUBLIC bool create_directories(const path & p, std::error_code & ec);
+
+/**
+ * \brief Remove the file or directory at the path p.
+ *
+ * \param[in] p The path of the object to remove.
+ * \return true if the file exists and it was successfully removed, false otherwise.
+ */
+RCPPUTILS_PUBLIC bool remove(const path & p);
+
+/**
+ * \brief Remove the file or empty directory at the path p, reporting failures through an error
+ * code.
+ *
+ * A path that does not exist is not a failure.
+ *
+ * \param[in] p The path of the object to remove.
+ * \param[out] ec Set to the reason of the failure, or cleared on success.
+ * \return true if the file existed and it was removed, false otherwise.
+ */
+RCPPUTILS_PUBLIC bool remove(const path & p, std::error_code & ec) noexcept;
+
+/**
+ * \brief Remove the directory at the path p and its content.
+ *
+ * Additionally to \sa remove, remove_all removes a directory and its containing files.
+ * Symlinks are removed themselves, without following them.
+ *
+ * \param[in] p The path of the directory to remove.
+ * \return true if the directory exists and it was successfully removed, false otherwise.
+ */
+RCPPUTILS_PUBLIC bool remove_all(const path & p);
+
+/// Statistics about the entries removed by remove_all().
+struct remove_all_stats
+{
+  /// The number of files, directories and other entries removed, including the path itself.
+  uint64_t entries = 0;
+  /// The total size of the regular files removed, in bytes.
+  uint64_t bytes = 0;
+};
+
+/**
+ * \brief Remove the directory at the path p and its content, counting what was removed.
+ *
+ * Unlike remove_all(const path &), this needs a stat call per removed file to sum their sizes.
+ *
+ * \param[in] p The path of the directory to remove.
+ * \param[out] stats The entries removed so far, also on failure.
+ * \return true if the directory exists and it was successfully removed, false otherwise.
+ */
+RCPPUTILS_PUBLIC bool remove_all(const path & p, remove_all_stats & stats);
+
+/**
+ * \brief Remove the directory at the path p and its content, reporting failures through an error
+ * code.
+ *
+ * A path that does not exist is not a failure.
+ *
+ * \param[in] p The path of the directory to remove.
+ * \param[out] ec Set to the reason of the failure, or cleared on success.
+ * \return true if the path existed and it was removed, false otherwise.
+ */
+RCPPUTILS_PUBLIC bool remove_all(const path & p, std::error_code & ec);
+
+/**
+ * \brief Remove the directory at the path p and its content, counting what was removed and
+ * reporting failures through an error code.
+ *
+ * \param[in] p The path of the directory to remove.
+ * \param[out] stats The entries removed so far, also on failure.
+ * \param[out] ec Set to the reason of the failure, or cleared on success.
+ * \return true if the path existed and it was removed, false otherwise.
+ */
+RCPPUTILS_PUBLIC bool remove_all(const path & p, remove_all_stats & stats, std::error_code & ec);
+
+/**
+ * \brief Remove extension(s) from a path.
+ *
+ * An extension is defined as text starting from the end of a path to the first period (.) character
+ * in the filename, as returned by path::extension().
+ *
+ * \param[in] file_path The file path string.
+ * \param[in] n_times The number of extensions to remove if there are multiple extensions.
+ * \return The path object.
+ */
+RCPPUTILS_PUBLIC path remove_extension(const path & file_path, int n_times = 1);
+
+/**
+ * \brief Drop-in replacement for std::filesystem::directory_options.
+ *
+ * See https://en.cppreference.com/w/cpp/filesystem/directory_options
+ */
+enum class directory_options : unsigned
+{
+  none = 0,
+  follow_directory_symlink = 1,  ///< Recurse into symlinks to directories.
+  skip_permission_denied = 2  ///< Skip directories that cannot be opened for lack of permission.
+};
+
+/// \cond
+constexpr directory_options operator&(directory_options a, directory_options b) noexcept
+{
+  return static_cast<directory_options>(static_cast<unsigned>(a) & static_cast<unsigned>(b));
+}
+
+constexpr directory_options operator|(directory_options a, directory_options b) noexcept
+{
+  return static_cast<directory_options>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+}
+/// \endcond
+
+/**
+ * \brief An entry yielded while iterating a directory.
+ *
+ * The type of the entry is taken from the directory listing itself (`d_type` on POSIX), so
+ * most entries can be classified without a stat call. Only symlinks that need to be followed,
+ * and entries on filesystems that do not report a type, require one.
+ */
+class directory_entry
+{
+public:
+  /// Construct an empty entry.
+  directory_entry() noexcept = default;
+
+  /**
+   * \brief Construct an entry for the given path, querying its type with a lstat call.
+   *
+   * \param[in] p The path of the entry.
+   */
+  RCPPUTILS_PUBLIC
+  explicit directory_entry(const rcpputils::fs::path & p);
+
+  /**
+   * \brief Construct an entry whose type is already known, without querying it.
+   *
+   * \param[in] p The path of the entry.
+   * \param[in] type The type of the entry itself, not following symlinks.
+   */
+  directory_entry(rcpputils::fs::path p, file_type type) noexcept
+  : path_(std::move(p)), type_(type)
+  {
+  }
+
+  /// The full path of this entry.
+  const rcpputils::fs::path & path() const noexcept {return path_;}
+
+  /// Conversion to the full path of this entry.
+  operator const rcpputils::fs::path &() const noexcept {return path_;}  // NOLINT
+
+  /**
+   * \brief Get the type of the entry itself, as reported by the directory listing.
+   *
+   * Symlinks are not followed, so a symlink yields file_type::symlink.
+   *
+   * \return The type of this entry.
+   */
+  file_type type() const noexcept {return type_;}
+
+  /// Check if the entry is a directory, following symlinks.
+  RCPPUTILS_PUBLIC bool is_directory() const noexcept;
+
+  /// Check if the entry is a regular file, following symlinks.
+  RCPPUTILS_PUBLIC bool is_regular_file() const noexcept;
+
+  /// Check if the entry itself is a symlink.
+  bool is_symlink() const noexcept {return type_ == file_type::symlink;}
+
+  /**
+   * \brief Query the full status of the entry, following symlinks.
+   *
+   * \throws std::system_error \sa status()
+   */
+  RCPPUTILS_PUBLIC file_status status() const;
+
+  /// Query the full status of the entry, following symlinks, without throwing.
+  RCPPUTILS_PUBLIC file_status status(std::error_code & ec) const noexcept;
+
+  /**
+   * \brief Query the full status of the entry itself.
+   *
+   * \throws std::system_error \sa symlink_status()
+   */
+  RCPPUTILS_PUBLIC file_status symlink_status() const;
+
+  /// Query the full status of the entry itself, without throwing.
+  RCPPUTILS_PUBLIC file_status symlink_status(std::error_code & ec) const noexcept;
+
+private:
+  friend class directory_iterator;
+  friend class recursive_directory_iterator;
+
+  rcpputils::fs::path path_;
+  file_type type_ = file_type::none;
+};
+
+/**
+ * \brief Drop-in replacement for std::filesystem::directory_iterator.
+ *
+ * Iterates over the entries of a directory, skipping "." and "..", in unspecified order.
+ * Copies of an iterator share their position, as it is an input iterator.
+ *
+ * See https://en.cppreference.com/w/cpp/filesystem/directory_iterator
+ */
+class directory_iterator
+{
+public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = directory_entry;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const directory_entry *;
+  using reference = const directory_entry &;
+
+  /// Construct the end iterator.
+  directory_iterator() noexcept = default;
+
+  /**
+   * \brief Open a directory and move to its first entry.
+   *
+   * \param[in] p The directory to iterate.
+   * \param[in] options Options, of which only skip_permission_denied is relevant here.
+   * \throws std::system_error if the directory cannot be opened or read.
+   */
+  RCPPUTILS_PUBLIC
+  explicit directory_iterator(
+    const path & p, directory_options options = directory_options::none);
+
+  /**
+   * \brief Open a directory and move to its first entry, reporting failures through an error code.
+   *
+   * \param[in] p The directory to iterate.
+   * \param[in] options Options, of which only skip_permission_denied is relevant here.
+   * \param[out] ec Set to the reason of the failure, or cleared on success. The iterator is the
+   * end iterator on failure.
+   */
+  RCPPUTILS_PUBLIC
+  directory_iterator(const path & p, directory_options options, std::error_code & ec);
+
+  /// The current entry.
+  RCPPUTILS_PUBLIC const directory_entry & operator*() const;
+
+  /// The current entry.
+  RCPPUTILS_PUBLIC const directory_entry * operator->() const;
+
+  /**
+   * \brief Move to the next entry.
+   *
+   * \throws std::system_error if the directory cannot be read.
+   */
+  RCPPUTILS_PUBLIC directory_iterator & operator++();
+
+  /**
+   * \brief Move to the next entry, reporting failures through an error code.
+   *
+   * \param[out] ec Set to the reason of the failure, or cleared on success. The iterator is the
+   * end iterator on failure.
+   * \return This iterator.
+   */
+  RCPPUTILS_PUBLIC directory_iterator & increment(std::error_code & ec);
+
+  bool operator==(const directory_iterator & other) const noexcept {return impl_ == other.impl_;}
+  bool operator!=(const directory_iterator & other) const noexcept {return impl_ != other.impl_;}
+
+private:
+  struct impl;
+  std::shared_ptr<impl> impl_;
+};
+
+/// Return the iterator itself, to allow use in range-based for loops.
+inline directory_iterator begin(directory_iterator it) noexcept {return it;}
+
+/// Return the end iterator, to allow use in range-based for loops.
+inline directory_iterator end(const directory_iterator &) noexcept {return directory_iterator();}
+
+/**
+ * \brief Drop-in replacement for std::filesystem::recursive_directory_iterator.
+ *
+ * Iterates over the entries of a directory and, depth first, of its subdirectories. Directories
+ * are recognized by the type reported in the directory listing, so recursing needs no stat
+ * call unless directory symlinks are followed.
+ *
+ * See https://en.cppreference.com/w/cpp/filesystem/recursive_directory_iterator
+ */
+class recursive_directory_iterator
+{
+public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = directory_entry;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const directory_entry *;
+  using reference = const directory_entry &;
+
+  /// Construct the end iterator.
+  recursive_directory_iterator() noexcept = default;
+
+  /**
+   * \brief Open a directory and move to its first entry.
+   *
+   * \param[in] p The directory to iterate.
+   * \param[in] options Whether to follow directory symlinks and skip unreadable directories.
+   * \throws std::system_error if the directory cannot be opened or read.
+   */
+  RCPPUTILS_PUBLIC
+  explicit recursive_directory_iterator(
+    const path & p, directory_options options = directory_options::none);
+
+  /**
+   * \brief Open a directory and move to its first entry, reporting failures through an error code.
+   *
+   * \param[in] p The directory to iterate.
+   * \param[in] options Whether to follow directory symlinks and skip unreadable directories.
+   * \param[out] ec Set to the reason of the failure, or cleared on success. The iterator is the
+   * end iterator on failure.
+   */
+  RCPPUTILS_PUBLIC
+  recursive_directory_iterator(const path & p, directory_options options, std::error_code & ec);
+
+  /// The current entry.
+  RCPPUTILS_PUBLIC const directory_entry & operator*() const;
+
+  /// The current entry.
+  RCPPUTILS_PUBLIC const directory_entry * operator->() const;
+
+  /**
+   * \brief Move to the next entry, entering the current one first if it is a directory.
+   *
+   * \throws std::system_error if a directory cannot be opened or read.
+   */
+  RCPPUTILS_PUBLIC recursive_directory_iterator & operator++();
+
+  /**
+   * \brief Move to the next entry like operator++(), reporting failures through an error code.
+   *
+   * \param[out] ec Set to the reason of the failure, or cleared on success. The iterator is the
+   * end iterator on failure.
+   * \return This iterator.
+   */
+  RCPPUTILS_PUBLIC recursive_directory_iterator & increment(std::error_code & ec);
+
+  /// The options this iterator was constructed with.
+  RCPPUTILS_PUBLIC directory_options options() const;
+
+  /// The number of directories entered below the starting one to reach the current entry.
+  RCPPUTILS_PUBLIC int depth() const;
+
+  /// Check if the current entry will be entered on the next increment, if it is a directory.
+  RCPPUTILS_PUBLIC bool recursion_pending() const;
+
+  /// Do not enter the current entry on the next increment.
+  RCPPUTILS_PUBLIC void disable_recursion_pending();
+
+  /**
+   * \brief Leave the current directory and move to the next entry of its parent.
+   *
+   * \throws std::system_error if a directory cannot be read.
+   */
+  RCPPUTILS_PUBLIC void pop();
+
+  /**
+   * \brief Leave the current directory like pop(), reporting failures through an error code.
+   *
+   * \param[out] ec Set to the reason of the failure, or cleared on success. The iterator is the
+   * end iterator on failure.
+   */
+  RCPPUTILS_PUBLIC void pop(std::error_code & ec);
+
+  bool operator==(const recursive_directory_iterator & other) const noexcept
+  {
+    return impl_ == other.impl_;
+  }
+
+  bool operator!=(const recursive_directory_iterator & other) const noexcept
+  {
+    return impl_ != other.impl_;
+  }
+
+private:
+  /// \internal Move to the next entry, leaving the directories that are exhausted.
+  void advance(std::error_code & ec);
+
+  struct impl;
+  std::shared_ptr<impl> impl_;
+};
+
+/// Return the iterator itself, to allow use in range-based for loops.
+inline recursive_directory_iterator begin(recursive_directory_iterator it) noexcept {return it;}
+
+/// Return the end iterator, to allow use in range-based for loops.
+inline recursive_directory_iterator end(const recursive_directory_iterator &) noexcept
+{
+  return recursive_directory_iterator();
+}
+
+/// What parallel_walk() should do after visiting an entry.
+enum class walk_action
+{
+  proceed,  ///< Continue, entering the entry if it is a directory.
+  skip_subtree,  ///< Continue, without entering the entry.
+  stop  ///< Cancel the walk as soon as possible.
+};
+
+/**
+ * \brief Visitor called by parallel_walk() for each entry.
+ *
+ * It is called concurrently from several threads, and must synchronize access to shared state.
+ */
+using walk_visitor = std::function<walk_action(const directory_entry &)>;
+
+/**
+ * \brief Visit all the entries below a directory, reading subdirectories concurrently.
+ *
+ * Subdirectories are spread across a pool of worker threads, which pays off when the walk is
+ * bound by metadata latency, e.g. on a cold cache or a network filesystem. On POSIX systems,
+ * subdirectories are opened relative to their parent with openat(), so paths are not resolved
+ * again from the root.
+ *
+ * Entries are visited in unspecified order, but a directory is always visited before its
+ * content. The visitor can skip subtrees it does not care about and cancel the walk.
+ *
+ * \param[in] root The directory to walk.
+ * \param[in] visitor The function called for each entry below root.
+ * \param[in] num_threads The number of worker threads, or 0 to use the hardware concurrency.
+ * \param[in] options Whether to follow directory symlinks and skip unreadable directories.
+ * \return True if all entries were visited, false if the visitor cancelled the walk.
+ * \throws std::system_error if a directory cannot be opened or read.
+ * Exceptions thrown by the visitor cancel the walk and are rethrown.
+ */
+RCPPUTILS_PUBLIC bool parallel_walk(
+  const path & root, const walk_visitor & visitor, size_t num_threads = 0,
+  directory_options options = directory_options::none);
+
+/**
+ * \brief Visit all the entries below a directory, reporting failures through an error code.
+ *
+ * The first directory that cannot be read cancels the walk. Exceptions thrown by the visitor
+ * are still rethrown.
+ *
+ * \param[in] root The directory to walk.
+ * \param[in] visitor The function called for each entry below root.
+ * \param[in] num_threads The number of worker threads, or 0 to use the hardware concurrency.
+ * \param[in] options Whether to follow directory symlinks and skip unreadable directories.
+ * \param[out] ec Set to the reason of the failure, or cleared on success.
+ * \return True if all entries were visited, false if the visitor cancelled the walk or on error.
+ */
+RCPPUTILS_PUBLIC bool parallel_walk(
+  const path & root, const walk_visitor & visitor, size_t num_threads,
+  directory_options options, std::error_code & ec);
+
+/// Options for the parallel filesystem operations.
+struct parallel_options
+{
+  /// The number of worker threads, or 0 to use the hardware concurrency.
+  size_t num_threads = 0;
+  /// The most file data copy() may have in flight at once, in bytes, or 0 for no limit.
+  uint64_t max_bytes_in_flight = 0;
+};
+
+/// An entry that remove_all(const path &, const parallel_options &) could not remove.
+struct remove_error
+{
+  /// The path of the entry.
+  rcpputils::fs::path target;
+  /// Why it could not be removed, or read for a directory.
+  std::error_code error;
+};
+
+/// The outcome of remove_all(const path &, const parallel_options &).
+struct remove_all_report
+{
+  /// The number of files, directories and other entries removed, including the path itself.
+  uint64_t entries = 0;
+  /// The entries that could not be removed, in unspecified order.
+  std::vector<remove_error> errors;
+
+  /// Whether everything was removed.
+  bool success() const noexcept {return errors.empty();}
+};
+
+/**
+ * \brief Remove the directory at the path p and its content, emptying subtrees concurrently.
+ *
+ * Subdirectories are spread across a pool of worker threads, and each directory is removed as
+ * soon as its content is gone. Unlike remove_all(const path &), an error does not stop the
+ * removal: everything that can be removed is, and the ancestors of what cannot are kept.
+ * Symlinks are removed themselves, without following them. Entries that disappear meanwhile,
+ * removed by someone else, are not errors.
+ *
+ * \param[in] p The path of the directory to remove.
+ * \param[in] options The number of worker threads.
+ * \return The number of entries removed and the errors met, including p not existing.
+ */
+RCPPUTILS_PUBLIC remove_all_report remove_all(const path & p, const parallel_options & options);
+
+/**
+ * \brief Query the status of many paths at once, following symlinks.
+ *
+ * The queries overlap instead of blocking one after the other, which pays off when they wait
+ * for the disk or the network, like on a cold cache. On Linux, they are submitted together
+ * through io_uring when the kernel supports statx() operations. Otherwise, they are spread
+ * across a pool of worker threads.
+ *
+ * Unlike status(), this does not throw when a query fails: the status of a path that does not
+ * exist has the type file_type::not_found, and the status of a path that cannot be queried has
+ * the type file_type::none, see status_known().
+ *
+ * \param[in] paths The paths to query.
+ * \param[in] options The number of worker threads, if threads are used.
+ * \return The status of each path, in the same order.
+ */
+RCPPUTILS_PUBLIC std::vector<file_status> status_many(
+  const std::vector<path> & paths, const parallel_options & options = parallel_options());
+
+/**
+ * \brief Options for copy_file() and copy(), a subset of std::filesystem::copy_options.
+ *
+ * See https://en.cppreference.com/w/cpp/filesystem/copy_options
+ */
+enum class copy_options : unsigned
+{
+  none = 0,  ///< Fail if the destination exists.
+  skip_existing = 1,  ///< Keep the destination if it exists, without reporting an error.
+  overwrite_existing = 2,  ///< Replace the content of the destination if it exists.
+  preserve_last_write_time = 4,  ///< Give the destination the modification time of the source.
+  recursive = 8  ///< Make copy() copy subdirectories and their content.
+};
+
+/// \cond
+constexpr copy_options operator&(copy_options a, copy_options b) noexcept
+{
+  return static_cast<copy_options>(static_cast<unsigned>(a) & static_cast<unsigned>(b));
+}
+
+constexpr copy_options operator|(copy_options a, copy_options b) noexcept
+{
+  return static_cast<copy_options>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+}
+/// \endcond
+
+/// How copy_file() copied the content of a file, from the cheapest to the most expensive.
+enum class copy_strategy
+{
+  none,  ///< Nothing was copied, as the destination was skipped.
+  reflink,  ///< The destination shares the extents of the source, with ioctl(FICLONE).
+  copy_file_range,  ///< The kernel copied the data, possibly offloading it to the storage.
+  sendfile,  ///< The kernel copied the data, without going through user space.
+  read_write  ///< The data was read into a buffer and written back, or copied by CopyFile().
+};
+
+/**
+ * \brief Copy the content of a regular file.
+ *
+ * On Linux, the cheapest available way is used: a reflink where the filesystem supports it,
+ * then copy_file_range(), then sendfile(), and only then a loop of large reads and writes.
+ * A strategy that fails hands over to the next one, at the offset it reached.
+ * On Windows, the copy is done by CopyFile().
+ *
+ * \param[in] from The file to copy.
+ * \param[in] to The path of the copy.
+ * \param[in] options What to do if the destination exists, and whether to keep the mtime.
+ * \param[out] strategy The strategy that completed the copy.
+ * \return True if the file was copied, false if an existing destination was skipped.
+ * \throws std::system_error if from is not a regular file, to exists without an option to
+ * skip or overwrite it, both are the same file, or the copy fails.
+ */
+RCPPUTILS_PUBLIC bool copy_file(
+  const path & from, const path & to, copy_options options, copy_strategy & strategy);
+
+/**
+ * \brief Copy the content of a regular file.
+ *
+ * Same as copy_file(const path &, const path &, copy_options, copy_strategy &), without
+ * reporting the strategy used.
+ */
+RCPPUTILS_PUBLIC bool copy_file(
+  const path & from, const path & to, copy_options options = copy_options::none);
+
+/**
+ * \brief Copy the content of a regular file, reporting failures through an error code.
+ *
+ * \param[in] from The file to copy.
+ * \param[in] to The path of the copy.
+ * \param[in] options What to do if the destination exists, and whether to keep the mtime.
+ * \param[out] strategy The strategy that completed the copy.
+ * \param[out] ec Set to the reason of the failure, or cleared on success.
+ * \return True if the file was copied, false if an existing destination was skipped or on error.
+ */
+RCPPUTILS_PUBLIC bool copy_file(
+  const path & from, const path & to, copy_options options, copy_strategy & strategy,
+  std::error_code & ec);
+
+/**
+ * \brief Copy the content of a regular file, reporting failures through an error code.
+ *
+ * Same as copy_file(const path &, const path &, copy_options, copy_strategy &, std::error_code &),
+ * without reporting the strategy used.
+ */
+RCPPUTILS_PUBLIC bool copy_file(
+  const path & from, const path & to, copy_options options, std::error_code & ec);
+
+/**
+ * \brief Copy a file or a directory, copying files concurrently.
+ *
+ * A regular file is copied with copy_file(), into to if it is a directory.
+ * For a directory, the source tree is read with parallel_walk() and the destination tree is
+ * created at once. The files are then copied with copy_file() by a pool of worker threads.
+ * Without copy_options::recursive, only the files directly in from are copied.
+ * Symlinks are copied as symlinks, without following them, and skipped on Windows.
+ *
+ * Each worker waits before copying a file until the data of the files being copied fits in
+ * parallel.max_bytes_in_flight, so that a large copy leaves I/O bandwidth to other processes.
+ * A file larger than the limit is copied alone.
+ *
+ * \param[in] from The file or directory to copy.
+ * \param[in] to The path of the copy.
+ * \param[in] options The copy_file() options, and whether to copy subdirectories.
+ * \param[in] parallel The number of worker threads and the bytes in flight limit.
+ * \throws std::system_error if from does not exist, is neither a file, a directory nor a
+ * symlink, or any copy fails. The copy stops at the first error.
+ */
+RCPPUTILS_PUBLIC void copy(
+  const path & from, const path & to, copy_options options = copy_options::none,
+  const parallel_options & parallel = parallel_options());
+
+/**
+ * \brief Copy a file or a directory, reporting failures through an error code.
+ *
+ * The copy stops at the first error, as for copy(const path &, const path &, copy_options,
+ * const parallel_options &).
+ *
+ * \param[in] from The file or directory to copy.
+ * \param[in] to The path of the copy.
+ * \param[in] options The copy_file() options, and whether to copy subdirectories.
+ * \param[in] parallel The number of worker threads and the bytes in flight limit.
+ * \param[out] ec Set to the reason of the failure, or cleared on success.
+ */
+RCPPUTILS_PUBLIC void copy(
+  const path & from, const path & to, copy_options options, const parallel_options & parallel,
+  std::error_code & ec);
+
+/**
+ * \brief Compare two paths for equality.
+ *
+ * \return True if both paths are equal as strings.
+ */
+RCPPUTILS_PUBLIC bool operator==(const path & a, const path & b);
+RCPPUTILS_PUBLIC bool operator!=(const path & a, const path & b);
+
+/**
+ * \brief Order two paths component by component.
+ *
+ * \sa path::compare()
+ */
+inline bool operator<(const path & a, const path & b) noexcept {return a.compare(b) < 0;}
+inline bool operator>(const path & a, const path & b) noexcept {return a.compare(b) > 0;}
+inline bool operator<=(const path & a, const path & b) noexcept {return a.compare(b) <= 0;}
+inline bool operator>=(const path & a, const path & b) noexcept {return a.compare(b) >= 0;}
+
+/**
+ * \brief Hash a path, consistently with operator==().
+ *
+ * \param[in] p The path to hash.
+ * \return The hash of the path string.
+ */
+RCPPUTILS_PUBLIC size_t hash_value(const path & p) noexcept;
+
+/**
+* \brief Convert the path to a string for ostream usage, such as in logging or string formatting.
+*
 * \param[in] os The stream to send the path string to
 * \param[in] p The path to stringify
 * \return The ostream, for chaining
@@ -354,4 +1876,19 @@ RCPPUTILS_PUBLIC std::ostream & operator<<(std::ostream & os, const path & p);
 }  // namespace fs
 }  // namespace rcpputils
 
+namespace std
+{
+
+/// Hash of rcpputils::fs::path, so paths can be keys of unordered containers.
+template<>
+struct hash<rcpputils::fs::path>
+{
+  size_t operator()(const rcpputils::fs::path & p) const noexcept
+  {
+    return rcpputils::fs::hash_value(p);
+  }
+};
+
+}  // namespace std
+
 #endif  // RCPPUTILS__FILESYSTEM_HELPER_HPP_
@@ -0,0 +1,150 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file glob.hpp
+ * \brief Matching of paths against shell-style wildcard patterns.
+ */
+
+#ifndef RCPPUTILS__GLOB_HPP_
+#define RCPPUTILS__GLOB_HPP_
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+#include "rcpputils/visibility_control.hpp"
+
+namespace rcpputils
+{
+namespace fs
+{
+
+class glob_pattern;
+
+/**
+ * \brief Find the entries below a directory whose relative path matches a pattern.
+ *
+ * The directory is read one pattern component at a time, so only the directories that can
+ * contain matches are listed, and components without wildcards are looked up directly.
+ * Below a `**` component every entry is considered, without following directory symlinks.
+ * Unreadable directories are skipped.
+ *
+ * \param[in] root The directory the pattern is relative to.
+ * \param[in] pattern The pattern to match.
+ * \return The matching paths, starting with root, sorted.
+ * \throws std::system_error if a directory cannot be read for another reason than permissions.
+ */
+RCPPUTILS_PUBLIC std::vector<path> glob(const path & root, const glob_pattern & pattern);
+
+/**
+ * \brief A wildcard pattern, compiled once to match many paths.
+ *
+ * The pattern is made of components separated by `/`, each matched against one component of
+ * a path, with:
+ *  - `*` matching any run of characters within a component, including none,
+ *  - `?` matching any single character,
+ *  - `[abc]`, `[a-z]` matching one character of a set, and `[!abc]` or `[^abc]` one that is
+ *    not in it, where a leading `]` is part of the set,
+ *  - `**` as a whole component matching any number of components, including none,
+ *  - `\` matching the following character literally, except on Windows where it separates
+ *    components.
+ *
+ * Wildcards match names starting with a dot too. Repeated, leading and trailing separators are
+ * ignored in both the pattern and the matched paths.
+ */
+class glob_pattern
+{
+public:
+  /**
+   * \brief Compile a pattern.
+   *
+   * \param[in] pattern The pattern.
+   * \throws std::invalid_argument if a set is not closed by `]`.
+   */
+  RCPPUTILS_PUBLIC
+  explicit glob_pattern(std::string_view pattern);
+
+  /// The pattern, as given.
+  const std::string & str() const noexcept {return pattern_;}
+
+  /**
+   * \brief Check if a whole path matches the pattern, without allocating.
+   *
+   * \param[in] p The path, as a string.
+   * \return True if it matches.
+   */
+  RCPPUTILS_PUBLIC
+  bool match(std::string_view p) const noexcept;
+
+  /// \copydoc match(std::string_view) const
+  bool match(const path & p) const noexcept {return match(std::string_view(p.native()));}
+
+  /// \copydoc match(std::string_view) const
+  bool match(const std::string & p) const noexcept {return match(std::string_view(p));}
+
+  /// \copydoc match(std::string_view) const
+  bool match(const char * p) const noexcept {return match(std::string_view(p));}
+
+private:
+  friend std::vector<path> glob(const path & root, const glob_pattern & pattern);
+
+  struct token
+  {
+    enum class kind : uint8_t {literal, any_char, any_run, char_set};
+    kind type;
+    // The range of literals_ for a literal, or the index in sets_ for a set
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  struct component
+  {
+    // Matches any number of path components
+    bool globstar;
+    // Made of a single literal, so it can be looked up rather than matched
+    bool literal;
+    uint32_t first_token;
+    uint32_t num_tokens;
+  };
+
+  bool match_component(const component & c, std::string_view name) const noexcept;
+  std::string_view literal_text(const component & c) const noexcept;
+  void walk(const path & dir, size_t c, size_t root_size, std::vector<path> & matches) const;
+
+  std::string pattern_;
+  std::string literals_;
+  std::vector<std::bitset<256>> sets_;
+  std::vector<token> tokens_;
+  std::vector<component> components_;
+};
+
+/**
+ * \brief Find the entries below a directory whose relative path matches a pattern.
+ *
+ * \param[in] root The directory the pattern is relative to.
+ * \param[in] pattern The pattern to compile and match.
+ * \return The matching paths, starting with root, sorted.
+ * \throws std::invalid_argument if the pattern is invalid.
+ * \throws std::system_error if a directory cannot be read for another reason than permissions.
+ */
+RCPPUTILS_PUBLIC std::vector<path> glob(const path & root, std::string_view pattern);
+
+}  // namespace fs
+}  // namespace rcpputils
+
+#endif  // RCPPUTILS__GLOB_HPP_
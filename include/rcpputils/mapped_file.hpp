@@ -0,0 +1,233 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file mapped_file.hpp
+ * \brief Memory-mapped access to the content of files.
+ */
+
+#ifndef RCPPUTILS__MAPPED_FILE_HPP_
+#define RCPPUTILS__MAPPED_FILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rcpputils/filesystem_helper.hpp"
+#include "rcpputils/visibility_control.hpp"
+
+namespace rcpputils
+{
+namespace fs
+{
+
+/// How the content of a mapped_file is going to be accessed, see madvise().
+enum class access_advice
+{
+  normal,  ///< No particular pattern, the default read-ahead.
+  sequential,  ///< In order, so pages can be read ahead aggressively and dropped soon after.
+  random,  ///< In no particular order, so read-ahead would be wasted.
+  willneed,  ///< Soon, so reading the pages can start right away.
+  hugepage  ///< With huge pages where the filesystem supports them, saving TLB misses.
+};
+
+/// Whether a mapped_file can modify the file.
+enum class map_mode
+{
+  read_only,  ///< The content can only be read.
+  read_write  ///< Writes to the content are carried to the file, which can be resized.
+};
+
+/// How mapped_file::sync() waits for the content to be written to the file.
+enum class sync_mode
+{
+  async,  ///< Schedule the write back, without waiting for it (MS_ASYNC).
+  sync  ///< Wait until the content has been written (MS_SYNC).
+};
+
+/**
+ * \brief A file, or a range of it, mapped into memory.
+ *
+ * The content is accessed without copying it: pages are read from the page cache on first
+ * access, and shared with every other process mapping the same file.
+ * The mapping is released on destruction.
+ *
+ * A writable mapping stores data with plain memory writes instead of a write() call per
+ * record. The kernel writes the modified pages back on its own, sync() forces it to.
+ * Growing the mapping allocates the blocks of the file right away with fallocate() where the
+ * filesystem supports it, so running out of space is reported by resize(), not as a SIGBUS
+ * when writing.
+ *
+ * The content must not be truncated by another process while it is mapped, as accessing the
+ * missing pages raises SIGBUS on POSIX systems.
+ */
+class mapped_file
+{
+public:
+  /// Construct an object that maps nothing.
+  mapped_file() noexcept = default;
+
+  /**
+   * \brief Map the whole content of a file.
+   *
+   * \param[in] p The file to map.
+   * \throws std::system_error if the file cannot be opened or mapped.
+   */
+  RCPPUTILS_PUBLIC
+  explicit mapped_file(const path & p);
+
+  /**
+   * \brief Map a range of the content of a file.
+   *
+   * The offset does not need to be aligned to pages, the mapping is extended as needed.
+   *
+   * \param[in] p The file to map.
+   * \param[in] offset The position of the range in the file, in bytes.
+   * \param[in] length The size of the range in bytes, or 0 to map up to the end of the file.
+   * \throws std::system_error if the file cannot be opened or mapped, or the range goes past
+   * the end of the file.
+   */
+  RCPPUTILS_PUBLIC
+  mapped_file(const path & p, uint64_t offset, size_t length);
+
+  /**
+   * \brief Map a range of the content of a file, possibly for writing.
+   *
+   * With map_mode::read_write, the file is created if it does not exist, and grown with its
+   * blocks allocated if the range goes past its end.
+   *
+   * \param[in] p The file to map.
+   * \param[in] mode Whether the mapping can modify the file.
+   * \param[in] offset The position of the range in the file, in bytes.
+   * \param[in] length The size of the range in bytes, or 0 to map up to the end of the file.
+   * \throws std::system_error if the file cannot be opened, grown or mapped, or a read-only
+   * range goes past the end of the file.
+   */
+  RCPPUTILS_PUBLIC
+  mapped_file(const path & p, map_mode mode, uint64_t offset = 0, size_t length = 0);
+
+  RCPPUTILS_PUBLIC
+  ~mapped_file();
+
+  RCPPUTILS_PUBLIC
+  mapped_file(mapped_file && other) noexcept;
+
+  RCPPUTILS_PUBLIC
+  mapped_file & operator=(mapped_file && other) noexcept;
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file & operator=(const mapped_file &) = delete;
+
+  /// The first byte of the mapped range, or nullptr if it is empty.
+  const std::byte * data() const noexcept {return data_;}
+
+  /// The size of the mapped range in bytes.
+  size_t size() const noexcept {return size_;}
+
+  /// Whether the mapped range is empty.
+  bool empty() const noexcept {return size_ == 0;}
+
+  /// The position of the mapped range in the file, in bytes.
+  uint64_t offset() const noexcept {return offset_;}
+
+  const std::byte * begin() const noexcept {return data_;}
+  const std::byte * end() const noexcept {return data_ + size_;}
+
+  /// The first byte of a writable mapped range, or nullptr if it is empty or read-only.
+  std::byte * mutable_data() noexcept {return mode_ == map_mode::read_write ? data_ : nullptr;}
+
+  /// Whether the mapping can modify the file.
+  map_mode mode() const noexcept {return mode_;}
+
+  /**
+   * \brief Resize a writable mapped range, and the file along with it.
+   *
+   * The file is grown with its blocks allocated, or truncated, to end where the range ends.
+   * On Linux the mapping is grown in place with mremap() when possible, and moved otherwise.
+   * Pointers to the content are invalidated.
+   *
+   * \param[in] size The new size of the mapped range in bytes.
+   * \throws std::system_error if the mapping is read-only, or the file cannot be resized or
+   * mapped again.
+   */
+  RCPPUTILS_PUBLIC
+  void resize(size_t size);
+
+  /**
+   * \brief Write the modified content of the whole mapped range back to the file.
+   *
+   * \param[in] mode Whether to wait for the write back to finish.
+   * \throws std::system_error if the write back fails.
+   */
+  RCPPUTILS_PUBLIC
+  void sync(sync_mode mode = sync_mode::sync);
+
+  /**
+   * \brief Write the modified content of part of the mapped range back to the file.
+   *
+   * \param[in] offset The position of the part in the mapped range, in bytes.
+   * \param[in] length The size of the part in bytes.
+   * \param[in] mode Whether to wait for the write back to finish.
+   * \throws std::system_error if the part is not within the mapped range, or the write back
+   * fails.
+   */
+  RCPPUTILS_PUBLIC
+  void sync(size_t offset, size_t length, sync_mode mode = sync_mode::sync);
+
+  /**
+   * \brief Tell the kernel how the whole mapped range is going to be accessed.
+   *
+   * \param[in] advice The access pattern.
+   * \return True if the hint was taken, false if the system does not support it.
+   */
+  RCPPUTILS_PUBLIC
+  bool advise(access_advice advice) const noexcept;
+
+  /**
+   * \brief Tell the kernel how part of the mapped range is going to be accessed.
+   *
+   * \param[in] advice The access pattern.
+   * \param[in] offset The position of the part in the mapped range, in bytes.
+   * \param[in] length The size of the part in bytes.
+   * \return True if the hint was taken, false if the system does not support it or the part
+   * is not within the mapped range.
+   */
+  RCPPUTILS_PUBLIC
+  bool advise(access_advice advice, size_t offset, size_t length) const noexcept;
+
+  /// Release the mapping and the file, leaving the object empty.
+  RCPPUTILS_PUBLIC
+  void unmap() noexcept;
+
+private:
+  void map(size_t size);
+
+#ifdef _WIN32
+  // The HANDLE of a file mapped for writing, kept to resize it
+  void * file_ = nullptr;
+#else
+  // The descriptor of a file mapped for writing, kept to resize it
+  int fd_ = -1;
+#endif
+  map_mode mode_ = map_mode::read_only;
+  // The mapping itself starts at a page boundary, before the requested offset
+  void * mapping_ = nullptr;
+  size_t mapping_size_ = 0;
+  std::byte * data_ = nullptr;
+  size_t size_ = 0;
+  uint64_t offset_ = 0;
+};
+
+}  // namespace fs
+}  // namespace rcpputils
+
+#endif  // RCPPUTILS__MAPPED_FILE_HPP_
@@ -0,0 +1,199 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file path_interner.hpp
+ * \brief Deduplicated storage of many paths sharing their prefixes.
+ */
+
+#ifndef RCPPUTILS__PATH_INTERNER_HPP_
+#define RCPPUTILS__PATH_INTERNER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+#include "rcpputils/visibility_control.hpp"
+
+namespace rcpputils
+{
+namespace fs
+{
+
+/**
+ * \brief Stores each distinct path once, and refers to it with a small handle.
+ *
+ * A path is stored as its last component and a handle to its parent, so paths sharing a prefix
+ * share its storage, and each distinct component is stored once. A handle is 4 bytes, and
+ * comparing two handles of the same interner compares their paths in constant time.
+ *
+ * Interning a path splits it at each separator, so a path is rebuilt exactly as it was given,
+ * and two handles are equal if and only if their paths are equal with operator==().
+ *
+ * Handles stay valid as long as the interner. Interning is not thread-safe, while the const
+ * member functions can be called from several threads when no path is being interned.
+ */
+class path_interner
+{
+public:
+  /// A reference to an interned path, which the default constructed handle refers to "".
+  class handle
+  {
+public:
+    constexpr handle() noexcept = default;
+
+    /// The position of the path in the interner, less than path_interner::size().
+    constexpr uint32_t index() const noexcept {return index_;}
+
+    constexpr bool operator==(handle other) const noexcept {return index_ == other.index_;}
+    constexpr bool operator!=(handle other) const noexcept {return index_ != other.index_;}
+
+    /// Order handles by their index, which is not the order of their paths.
+    constexpr bool operator<(handle other) const noexcept {return index_ < other.index_;}
+
+private:
+    friend class path_interner;
+
+    constexpr explicit handle(uint32_t index) noexcept
+    : index_(index) {}
+
+    uint32_t index_ = 0;
+  };
+
+  /// Construct an interner holding only the empty path.
+  RCPPUTILS_PUBLIC path_interner();
+
+  RCPPUTILS_PUBLIC ~path_interner();
+
+  path_interner(const path_interner &) = delete;
+  path_interner & operator=(const path_interner &) = delete;
+
+  /**
+   * \brief Store a path unless it is stored already.
+   *
+   * \param[in] p The path to store.
+   * \return The handle of the path.
+   * \throws std::length_error if the interner would hold more than 2^32 paths.
+   */
+  RCPPUTILS_PUBLIC handle intern(std::string_view p);
+
+  /// \copydoc intern(std::string_view)
+  handle intern(const path & p) {return intern(std::string_view(p.native()));}
+
+  /// \copydoc intern(std::string_view)
+  handle intern(const std::string & p) {return intern(std::string_view(p));}
+
+  /// \copydoc intern(std::string_view)
+  handle intern(const char * p) {return intern(std::string_view(p));}
+
+  /**
+   * \brief Store the path made of a stored one and one more component.
+   *
+   * \param[in] parent The handle of the leading part of the path.
+   * \param[in] name The last component, without separators.
+   * \return The handle of the path.
+   * \throws std::length_error if the interner would hold more than 2^32 paths.
+   */
+  RCPPUTILS_PUBLIC handle intern(handle parent, std::string_view name);
+
+  /**
+   * \brief Find the handle of a path that is stored, without storing it.
+   *
+   * \param[in] p The path to find.
+   * \return The handle of the path, or nothing if it is not stored.
+   */
+  RCPPUTILS_PUBLIC std::optional<handle> find(std::string_view p) const;
+
+  /// \copydoc find(std::string_view) const
+  std::optional<handle> find(const path & p) const {return find(std::string_view(p.native()));}
+
+  /// \copydoc find(std::string_view) const
+  std::optional<handle> find(const std::string & p) const {return find(std::string_view(p));}
+
+  /// \copydoc find(std::string_view) const
+  std::optional<handle> find(const char * p) const {return find(std::string_view(p));}
+
+  /**
+   * \brief Rebuild a stored path.
+   *
+   * \param[in] h The handle of the path.
+   * \return The path, as it was given.
+   */
+  RCPPUTILS_PUBLIC path get(handle h) const;
+
+  /**
+   * \brief Get the handle of the leading part of a path, without its last component.
+   *
+   * \param[in] h The handle of the path.
+   * \return The handle of the parent, or of "" for the empty path and single components.
+   */
+  RCPPUTILS_PUBLIC handle parent(handle h) const noexcept;
+
+  /**
+   * \brief Get the last component of a stored path without allocating.
+   *
+   * \param[in] h The handle of the path.
+   * \return A view of the component, valid as long as the interner.
+   */
+  RCPPUTILS_PUBLIC std::string_view filename(handle h) const noexcept;
+
+  /// The number of paths stored, including the leading parts of the paths interned.
+  RCPPUTILS_PUBLIC size_t size() const noexcept;
+
+private:
+  struct node
+  {
+    uint32_t parent;
+    uint32_t name;
+  };
+
+  uint32_t intern_name(std::string_view name);
+
+  // nodes_[0] is the empty path, the root of all others
+  std::vector<node> nodes_;
+  // The distinct components, viewing the blocks of storage
+  std::vector<std::string_view> names_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  size_t block_used_ = 0;
+  size_t block_size_ = 0;
+  std::unordered_map<std::string_view, uint32_t> name_index_;
+  // The node of each (parent, name) pair
+  std::unordered_map<uint64_t, uint32_t> children_;
+};
+
+}  // namespace fs
+}  // namespace rcpputils
+
+namespace std
+{
+
+/// Hash of rcpputils::fs::path_interner::handle, for unordered containers.
+template<>
+struct hash<rcpputils::fs::path_interner::handle>
+{
+  size_t operator()(rcpputils::fs::path_interner::handle h) const noexcept
+  {
+    return std::hash<uint32_t>()(h.index());
+  }
+};
+
+}  // namespace std
+
+#endif  // RCPPUTILS__PATH_INTERNER_HPP_
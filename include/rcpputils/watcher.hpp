@@ -0,0 +1,185 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*! \file watcher.hpp
+ * \brief Notification of changes to files and directories.
+ */
+
+#ifndef RCPPUTILS__WATCHER_HPP_
+#define RCPPUTILS__WATCHER_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+#include "rcpputils/visibility_control.hpp"
+
+namespace rcpputils
+{
+namespace fs
+{
+
+/// The changes reported by a watcher, combined as flags.
+enum class watch_change : unsigned
+{
+  none = 0,
+  created = 1,  ///< The entry was created, or moved into a watched directory.
+  modified = 2,  ///< The content of the file was written.
+  removed = 4,  ///< The entry was removed, or moved out of a watched directory.
+  attributes = 8,  ///< The permissions, timestamps or ownership of the entry changed.
+  overflow = 16  ///< Changes below the target were lost, so it needs to be scanned again.
+};
+
+/// \cond
+constexpr watch_change operator&(watch_change a, watch_change b) noexcept
+{
+  return static_cast<watch_change>(static_cast<unsigned>(a) & static_cast<unsigned>(b));
+}
+
+constexpr watch_change operator|(watch_change a, watch_change b) noexcept
+{
+  return static_cast<watch_change>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+}
+/// \endcond
+
+/// The changes to one entry, accumulated since it was last reported.
+struct watch_event
+{
+  /// The entry that changed.
+  path target;
+  /// What changed, which can be several flags, as in created then modified.
+  watch_change changes = watch_change::none;
+  /// Whether the entry is a directory.
+  bool is_directory = false;
+};
+
+/// How a path is watched.
+struct watch_options
+{
+  /// Also watch every subdirectory of a directory, including the ones created later.
+  bool recursive = false;
+
+  /**
+   * Keep a snapshot of the watched entries, so when the kernel drops events, the snapshot is
+   * compared with a fresh scan and the missed changes are reported individually.
+   * Otherwise a single watch_change::overflow event is reported for the watched path.
+   */
+  bool resync = false;
+};
+
+/**
+ * \brief Watch files and directories for changes, instead of polling their status.
+ *
+ * On Linux the changes are reported by inotify. Watching a directory reports changes to its
+ * entries, and watching a file reports changes to that file.
+ *
+ * The changes to an entry read at once are coalesced into a single event, in the order the
+ * entries first changed. When a subdirectory is created below a recursive watch, the entries
+ * created in it before it could be watched are reported as created too.
+ *
+ * Events are read with poll(), either with a timeout or once native_handle() becomes readable
+ * in an event loop. A watcher is not thread-safe.
+ */
+class watcher
+{
+public:
+  /// Receives the events read by poll().
+  using callback = std::function<void (const watch_event &)>;
+
+  /**
+   * \brief Construct a watcher that watches nothing yet.
+   *
+   * \throws std::system_error if the system cannot notify changes.
+   */
+  RCPPUTILS_PUBLIC
+  watcher();
+
+  RCPPUTILS_PUBLIC
+  ~watcher();
+
+  RCPPUTILS_PUBLIC
+  watcher(watcher && other) noexcept;
+
+  RCPPUTILS_PUBLIC
+  watcher & operator=(watcher && other) noexcept;
+
+  watcher(const watcher &) = delete;
+  watcher & operator=(const watcher &) = delete;
+
+  /**
+   * \brief Start watching a file or directory.
+   *
+   * Watching a path again replaces its options.
+   *
+   * \param[in] p The file or directory to watch.
+   * \param[in] options Whether to watch subdirectories, and to resync after dropped events.
+   * \throws std::system_error if the path, or one of its subdirectories, cannot be watched.
+   */
+  RCPPUTILS_PUBLIC
+  void add(const path & p, const watch_options & options = watch_options());
+
+  /**
+   * \brief Stop watching a file or directory, along with its subdirectories.
+   *
+   * \param[in] p A path given to add().
+   * \return True if the path was watched.
+   */
+  RCPPUTILS_PUBLIC
+  bool remove(const path & p);
+
+  /**
+   * \brief The descriptor that becomes readable when events are pending.
+   *
+   * \return The descriptor, to be polled but not read from, or -1 if there is none.
+   */
+  RCPPUTILS_PUBLIC
+  int native_handle() const noexcept;
+
+  /**
+   * \brief Read the pending events.
+   *
+   * \param[in] timeout How long to wait for the first event, if none is pending, or a negative
+   * duration to wait indefinitely.
+   * \return The coalesced events, empty if none arrived in time or the watcher was moved from.
+   * \throws std::system_error if the events cannot be read.
+   */
+  RCPPUTILS_PUBLIC
+  std::vector<watch_event> poll(std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+  /**
+   * \brief Read the pending events, and pass each one to a callback.
+   *
+   * \param[in] on_event The callback to invoke for each coalesced event.
+   * \param[in] timeout How long to wait for the first event, if none is pending, or a negative
+   * duration to wait indefinitely.
+   * \return The number of events passed to the callback.
+   * \throws std::system_error if the events cannot be read.
+   */
+  RCPPUTILS_PUBLIC
+  size_t poll(
+    const callback & on_event,
+    std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+private:
+  struct impl;
+  std::unique_ptr<impl> impl_;
+};
+
+}  // namespace fs
+}  // namespace rcpputils
+
+#endif  // RCPPUTILS__WATCHER_HPP_
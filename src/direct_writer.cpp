@@ -0,0 +1,333 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rcpputils/direct_writer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "rcpputils/file.hpp"
+
+#ifdef __linux__
+#  include <fcntl.h>
+#  include <sys/stat.h>
+#endif
+
+namespace rcpputils
+{
+namespace fs
+{
+
+namespace
+{
+
+/// \internal The alignment assumed when the filesystem cannot be asked, the usual page size.
+constexpr size_t kDefaultAlignment = 4096;
+
+/// \internal The alignment that direct I/O needs for a file, or 0 if unknown.
+size_t query_alignment(const file & output) noexcept
+{
+#if defined(__linux__) && defined(STATX_DIOALIGN)
+  struct statx buffer;
+  if (statx(output.native_handle(), "", AT_EMPTY_PATH, STATX_DIOALIGN, &buffer) == 0 &&
+    (buffer.stx_mask & STATX_DIOALIGN) != 0 && buffer.stx_dio_offset_align != 0)
+  {
+    return std::max<size_t>(buffer.stx_dio_mem_align, buffer.stx_dio_offset_align);
+  }
+#else
+  static_cast<void>(output);
+#endif
+  return 0;
+}
+
+size_t round_up(size_t size, size_t alignment) noexcept
+{
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+
+/// \internal Releases a buffer allocated with an alignment.
+struct aligned_delete
+{
+  void operator()(std::byte * buffer) const noexcept
+  {
+    ::operator delete(buffer, std::align_val_t(alignment));
+  }
+
+  size_t alignment;
+};
+
+}  // namespace
+
+struct direct_writer::impl
+{
+  /// A full buffer, waiting to be written.
+  struct pending
+  {
+    std::byte * data;
+    size_t length;
+    uint64_t offset;
+  };
+
+  impl(const path & p, const direct_writer_options & options)
+  {
+    if (options.num_buffers < 2) {
+      throw std::invalid_argument{"direct_writer needs at least 2 buffers"};
+    }
+    if ((options.alignment & (options.alignment - 1)) != 0) {
+      throw std::invalid_argument{"direct_writer alignment must be a power of 2"};
+    }
+    const auto flags = open_flags::write | open_flags::create | open_flags::truncate;
+    std::error_code ec;
+    output.open(p, flags | open_flags::direct, ec);
+    if (ec == std::errc::invalid_argument) {
+      // The filesystem cannot bypass the page cache, so write through it
+      direct = false;
+      output.open(p, flags, ec);
+    }
+    if (ec) {
+      throw std::system_error{ec, "cannot open file for direct writing"};
+    }
+
+    alignment = options.alignment;
+    if (alignment == 0) {
+      alignment = query_alignment(output);
+    }
+    if (alignment == 0) {
+      alignment = kDefaultAlignment;
+    }
+    buffer_size = round_up(std::max<size_t>(options.buffer_size, 1), alignment);
+
+    buffers.reserve(options.num_buffers);
+    free_buffers.reserve(options.num_buffers);
+    queue.resize(options.num_buffers);
+    for (size_t i = 0; i < options.num_buffers; ++i) {
+      buffers.emplace_back(
+        static_cast<std::byte *>(::operator new(buffer_size, std::align_val_t(alignment))),
+        aligned_delete{alignment});
+      free_buffers.push_back(buffers.back().get());
+    }
+    current = free_buffers.back();
+    free_buffers.pop_back();
+    thread = std::thread([this] {run();});
+  }
+
+  /// Write the full buffers handed over, until stopped.
+  void run()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+      condition.wait(lock, [this] {return queue_count != 0 || stopping;});
+      if (queue_count == 0) {
+        return;
+      }
+      const pending item = queue[queue_head];
+      queue_head = (queue_head + 1) % queue.size();
+      --queue_count;
+      const bool skip = failed.load(std::memory_order_relaxed);
+      lock.unlock();
+
+      std::error_code ec;
+      if (!skip) {
+        output.pwrite(item.data, item.length, item.offset, ec);
+      }
+
+      lock.lock();
+      if (ec && !error) {
+        error = ec;
+        failed.store(true, std::memory_order_relaxed);
+      }
+      free_buffers.push_back(item.data);
+      condition.notify_all();
+    }
+  }
+
+  /// Hand the current buffer over to be written, with its first length bytes.
+  void submit(size_t length)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    queue[(queue_head + queue_count) % queue.size()] = {current, length, next_offset};
+    ++queue_count;
+    next_offset += length;
+    current = nullptr;
+    used = 0;
+    condition.notify_all();
+  }
+
+  /// Take the next free buffer as the current one, waiting for one to be written if needed.
+  void acquire()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this] {return !free_buffers.empty();});
+    current = free_buffers.back();
+    free_buffers.pop_back();
+  }
+
+  std::error_code first_error()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return error;
+  }
+
+  file output;
+  bool direct = true;
+  size_t alignment = 0;
+  size_t buffer_size = 0;
+  // All the buffers of the pool, to release them
+  std::vector<std::unique_ptr<std::byte, aligned_delete>> buffers;
+
+  // Only used by the thread appending data
+  std::byte * current = nullptr;
+  size_t used = 0;
+  uint64_t size = 0;
+  uint64_t next_offset = 0;
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::vector<std::byte *> free_buffers;
+  // A ring of the buffers waiting to be written, as large as the pool
+  std::vector<pending> queue;
+  size_t queue_head = 0;
+  size_t queue_count = 0;
+  bool stopping = false;
+  std::error_code error;
+  // Set along with error, so that appending can check it without locking
+  std::atomic<bool> failed{false};
+  std::thread thread;
+};
+
+direct_writer::direct_writer(const path & p, const direct_writer_options & options)
+: impl_(std::make_unique<impl>(p, options))
+{
+}
+
+direct_writer::~direct_writer()
+{
+  std::error_code ec;
+  close(ec);
+}
+
+direct_writer::direct_writer(direct_writer && other) noexcept = default;
+
+direct_writer & direct_writer::operator=(direct_writer && other) noexcept
+{
+  if (this != &other) {
+    std::error_code ec;
+    close(ec);
+    impl_ = std::move(other.impl_);
+  }
+  return *this;
+}
+
+size_t direct_writer::write(const void * data, size_t size, std::error_code & ec) noexcept
+{
+  if (!is_open()) {
+    ec = std::make_error_code(std::errc::bad_file_descriptor);
+    return 0;
+  }
+  if (impl_->failed.load(std::memory_order_relaxed)) {
+    ec = impl_->first_error();
+    return 0;
+  }
+  ec.clear();
+  const auto * bytes = static_cast<const std::byte *>(data);
+  size_t written = 0;
+  while (written < size) {
+    const size_t count = std::min(size - written, impl_->buffer_size - impl_->used);
+    std::memcpy(impl_->current + impl_->used, bytes + written, count);
+    impl_->used += count;
+    impl_->size += count;
+    written += count;
+    if (impl_->used == impl_->buffer_size) {
+      impl_->submit(impl_->buffer_size);
+      impl_->acquire();
+      if (impl_->failed.load(std::memory_order_relaxed)) {
+        ec = impl_->first_error();
+        return written;
+      }
+    }
+  }
+  return written;
+}
+
+void direct_writer::close()
+{
+  std::error_code ec;
+  close(ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot write file"};
+  }
+}
+
+void direct_writer::close(std::error_code & ec) noexcept
+{
+  ec.clear();
+  if (!is_open()) {
+    return;
+  }
+  if (impl_->used != 0) {
+    // Direct I/O only writes whole blocks, so pad the tail and truncate the file afterwards
+    const size_t padded = round_up(impl_->used, impl_->alignment);
+    std::memset(impl_->current + impl_->used, 0, padded - impl_->used);
+    impl_->submit(padded);
+  }
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->stopping = true;
+    impl_->condition.notify_all();
+  }
+  impl_->thread.join();
+
+  ec = impl_->error;
+  if (!ec && impl_->next_offset != impl_->size) {
+    impl_->output.resize(impl_->size, ec);
+  }
+  std::error_code close_ec;
+  impl_->output.close(close_ec);
+  if (!ec) {
+    ec = close_ec;
+  }
+}
+
+bool direct_writer::is_open() const noexcept
+{
+  return impl_ && impl_->output.is_open();
+}
+
+bool direct_writer::is_direct() const noexcept
+{
+  return impl_ && impl_->direct;
+}
+
+size_t direct_writer::alignment() const noexcept
+{
+  return impl_ ? impl_->alignment : 0;
+}
+
+uint64_t direct_writer::size() const noexcept
+{
+  return impl_ ? impl_->size : 0;
+}
+
+}  // namespace fs
+}  // namespace rcpputils
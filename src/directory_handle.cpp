@@ -0,0 +1,520 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rcpputils/directory_handle.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#  include <dirent.h>
+#  include <fcntl.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace rcpputils
+{
+namespace fs
+{
+
+directory_handle::directory_handle(const rcpputils::fs::path & p)
+{
+  std::error_code ec;
+  *this = directory_handle(p, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot open directory"};
+  }
+}
+
+directory_handle::~directory_handle()
+{
+  close();
+}
+
+directory_handle::directory_handle(directory_handle && other) noexcept
+: path_(std::move(other.path_)), fd_(std::exchange(other.fd_, -1))
+{
+}
+
+directory_handle & directory_handle::operator=(directory_handle && other) noexcept
+{
+  if (this != &other) {
+    close();
+    path_ = std::move(other.path_);
+    fd_ = std::exchange(other.fd_, -1);
+  }
+  return *this;
+}
+
+directory_handle directory_handle::open(std::string_view name) const
+{
+  std::error_code ec;
+  auto handle = open(name, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot open directory"};
+  }
+  return handle;
+}
+
+file_status directory_handle::status(std::string_view name) const
+{
+  std::error_code ec;
+  const auto s = status(name, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot get status"};
+  }
+  return s;
+}
+
+file_status directory_handle::symlink_status(std::string_view name) const
+{
+  std::error_code ec;
+  const auto s = symlink_status(name, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot get status"};
+  }
+  return s;
+}
+
+bool directory_handle::exists(std::string_view name) const noexcept
+{
+  std::error_code ec;
+  return exists(name, ec);
+}
+
+bool directory_handle::create_directory(std::string_view name) const
+{
+  std::error_code ec;
+  const bool created = create_directory(name, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot create directory"};
+  }
+  return created;
+}
+
+bool directory_handle::remove(std::string_view name) const
+{
+  std::error_code ec;
+  const bool removed = remove(name, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot remove"};
+  }
+  return removed;
+}
+
+void directory_handle::rename(std::string_view from, std::string_view to) const
+{
+  rename(from, *this, to);
+}
+
+void directory_handle::rename(
+  std::string_view from, std::string_view to, std::error_code & ec) const noexcept
+{
+  rename(from, *this, to, ec);
+}
+
+void directory_handle::rename(
+  std::string_view from, const directory_handle & to_directory, std::string_view to) const
+{
+  std::error_code ec;
+  rename(from, to_directory, to, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot rename"};
+  }
+}
+
+std::vector<directory_entry> directory_handle::list() const
+{
+  std::error_code ec;
+  auto entries = list(ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot read directory"};
+  }
+  return entries;
+}
+
+#ifndef _WIN32
+
+namespace
+{
+
+/// \internal A null-terminated copy of a name, kept on the stack unless it is long.
+class c_name final
+{
+public:
+  explicit c_name(std::string_view name)
+  {
+    if (name.size() < sizeof(buffer_)) {
+      std::memcpy(buffer_, name.data(), name.size());
+      buffer_[name.size()] = '\0';
+      str_ = buffer_;
+    } else {
+      large_.assign(name.data(), name.size());
+      str_ = large_.c_str();
+    }
+  }
+
+  c_name(const c_name &) = delete;
+  c_name & operator=(const c_name &) = delete;
+
+  const char * c_str() const noexcept {return str_;}
+
+private:
+  // Most names fit, being a single component of at most NAME_MAX bytes
+  char buffer_[256];
+  std::string large_;
+  const char * str_;
+};
+
+/// \internal Store the errno value of a failure in ec, and clear errno.
+void assign_errno(std::error_code & ec) noexcept
+{
+  ec.assign(errno, std::system_category());
+  errno = 0;
+}
+
+file_type type_from_mode(mode_t mode) noexcept
+{
+  switch (mode & S_IFMT) {
+    case S_IFREG: return file_type::regular;
+    case S_IFDIR: return file_type::directory;
+    case S_IFLNK: return file_type::symlink;
+    case S_IFBLK: return file_type::block;
+    case S_IFCHR: return file_type::character;
+    case S_IFIFO: return file_type::fifo;
+    case S_IFSOCK: return file_type::socket;
+    default: return file_type::unknown;
+  }
+}
+
+/// \internal Query the status of an entry, a missing one not being a failure.
+file_status query_status(int fd, std::string_view name, int flags, std::error_code & ec) noexcept
+{
+  if (fd < 0) {
+    ec = std::make_error_code(std::errc::bad_file_descriptor);
+    return file_status();
+  }
+  struct stat stat_buffer;
+  if (fstatat(fd, c_name(name).c_str(), &stat_buffer, flags) != 0) {
+    const bool missing = errno == ENOENT || errno == ENOTDIR;
+    if (missing) {
+      ec.clear();
+      errno = 0;
+      return file_status(file_type::not_found);
+    }
+    assign_errno(ec);
+    return file_status();
+  }
+  ec.clear();
+#  ifdef __APPLE__
+  const auto & mtime = stat_buffer.st_mtimespec;
+#  else
+  const auto & mtime = stat_buffer.st_mtim;
+#  endif
+  return file_status(
+    type_from_mode(stat_buffer.st_mode),
+    static_cast<perms>(stat_buffer.st_mode & static_cast<unsigned>(perms::mask)),
+    static_cast<uint64_t>(stat_buffer.st_size),
+    file_time_type(std::chrono::seconds(mtime.tv_sec) + std::chrono::nanoseconds(mtime.tv_nsec)),
+    static_cast<uint64_t>(stat_buffer.st_ino),
+    static_cast<uint64_t>(stat_buffer.st_dev));
+}
+
+}  // namespace
+
+directory_handle::directory_handle(const rcpputils::fs::path & p, std::error_code & ec)
+{
+#ifdef O_PATH
+  // Only a reference to the directory, which needs no read permission and does no I/O
+  constexpr int kFlags = O_PATH | O_DIRECTORY | O_CLOEXEC;
+#else
+  constexpr int kFlags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+#endif
+  fd_ = ::open(p.native().c_str(), kFlags);
+  if (fd_ < 0) {
+    assign_errno(ec);
+    return;
+  }
+  ec.clear();
+  path_ = p;
+}
+
+void directory_handle::close() noexcept
+{
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
+
+directory_handle directory_handle::open(std::string_view name, std::error_code & ec) const
+{
+  directory_handle handle;
+  if (fd_ < 0) {
+    ec = std::make_error_code(std::errc::bad_file_descriptor);
+    return handle;
+  }
+#ifdef O_PATH
+  constexpr int kFlags = O_PATH | O_DIRECTORY | O_CLOEXEC;
+#else
+  constexpr int kFlags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+#endif
+  handle.fd_ = openat(fd_, c_name(name).c_str(), kFlags);
+  if (handle.fd_ < 0) {
+    assign_errno(ec);
+    return handle;
+  }
+  ec.clear();
+  handle.path_ = path_ / std::string(name);
+  return handle;
+}
+
+file_status directory_handle::status(std::string_view name, std::error_code & ec) const noexcept
+{
+  return query_status(fd_, name, 0, ec);
+}
+
+file_status directory_handle::symlink_status(
+  std::string_view name, std::error_code & ec) const noexcept
+{
+  return query_status(fd_, name, AT_SYMLINK_NOFOLLOW, ec);
+}
+
+bool directory_handle::exists(std::string_view name, std::error_code & ec) const noexcept
+{
+  if (fd_ < 0) {
+    ec = std::make_error_code(std::errc::bad_file_descriptor);
+    return false;
+  }
+  if (faccessat(fd_, c_name(name).c_str(), F_OK, 0) == 0) {
+    ec.clear();
+    return true;
+  }
+  if (errno == ENOENT || errno == ENOTDIR) {
+    ec.clear();
+    errno = 0;
+  } else {
+    assign_errno(ec);
+  }
+  return false;
+}
+
+bool directory_handle::create_directory(std::string_view name, std::error_code & ec) const noexcept
+{
+  if (fd_ < 0) {
+    ec = std::make_error_code(std::errc::bad_file_descriptor);
+    return false;
+  }
+  const c_name c_str(name);
+  if (mkdirat(fd_, c_str.c_str(), S_IRWXU | S_IRWXG | S_IRWXO) == 0) {
+    ec.clear();
+    return true;
+  }
+  if (errno != EEXIST) {
+    assign_errno(ec);
+    return false;
+  }
+  errno = 0;
+  // Something is in the way, which is only fine if it is a directory
+  struct stat stat_buffer;
+  if (fstatat(fd_, c_str.c_str(), &stat_buffer, 0) != 0) {
+    assign_errno(ec);
+  } else if (!S_ISDIR(stat_buffer.st_mode)) {
+    ec = std::make_error_code(std::errc::not_a_directory);
+  } else {
+    ec.clear();
+  }
+  return false;
+}
+
+bool directory_handle::remove(std::string_view name, std::error_code & ec) const noexcept
+{
+  if (fd_ < 0) {
+    ec = std::make_error_code(std::errc::bad_file_descriptor);
+    return false;
+  }
+  const c_name c_str(name);
+  // Most entries are files, so try that first and only retry directories
+  int rc = unlinkat(fd_, c_str.c_str(), 0);
+  if (rc != 0 && (errno == EISDIR || errno == EPERM)) {
+    rc = unlinkat(fd_, c_str.c_str(), AT_REMOVEDIR);
+    if (rc != 0 && errno == ENOTDIR) {
+      // Not a directory after all, so the first error stands
+      errno = EPERM;
+    }
+  }
+  if (rc == 0) {
+    ec.clear();
+    return true;
+  }
+  if (errno == ENOENT) {
+    ec.clear();
+    errno = 0;
+  } else {
+    assign_errno(ec);
+  }
+  return false;
+}
+
+void directory_handle::rename(
+  std::string_view from, const directory_handle & to_directory, std::string_view to,
+  std::error_code & ec) const noexcept
+{
+  if (fd_ < 0 || to_directory.fd_ < 0) {
+    ec = std::make_error_code(std::errc::bad_file_descriptor);
+    return;
+  }
+  if (renameat(fd_, c_name(from).c_str(), to_directory.fd_, c_name(to).c_str()) != 0) {
+    assign_errno(ec);
+    return;
+  }
+  ec.clear();
+}
+
+std::vector<directory_entry> directory_handle::list(std::error_code & ec) const
+{
+  std::vector<directory_entry> entries;
+  if (fd_ < 0) {
+    ec = std::make_error_code(std::errc::bad_file_descriptor);
+    return entries;
+  }
+  // A descriptor opened with O_PATH cannot be read, so open the directory again from it
+  const int read_fd = openat(fd_, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  DIR * dir = read_fd < 0 ? nullptr : fdopendir(read_fd);
+  if (dir == nullptr) {
+    assign_errno(ec);
+    if (read_fd >= 0) {
+      ::close(read_fd);
+    }
+    return entries;
+  }
+  const auto & directory = path_.native();
+  const bool needs_separator = !directory.empty() && directory.back() != kPreferredSeparator;
+  errno = 0;
+  while (const struct dirent * entry = readdir(dir)) {
+    const char * name = entry->d_name;
+    if (std::strcmp(name, ".") == 0 || std::strcmp(name, "..") == 0) {
+      continue;
+    }
+    file_type type = file_type::none;
+#  ifdef DT_UNKNOWN
+    switch (entry->d_type) {
+      case DT_REG: type = file_type::regular; break;
+      case DT_DIR: type = file_type::directory; break;
+      case DT_LNK: type = file_type::symlink; break;
+      case DT_BLK: type = file_type::block; break;
+      case DT_CHR: type = file_type::character; break;
+      case DT_FIFO: type = file_type::fifo; break;
+      case DT_SOCK: type = file_type::socket; break;
+      default: break;
+    }
+#  endif
+    if (type == file_type::none) {
+      struct stat stat_buffer;
+      if (fstatat(dirfd(dir), name, &stat_buffer, AT_SYMLINK_NOFOLLOW) == 0) {
+        type = type_from_mode(stat_buffer.st_mode);
+      }
+    }
+    std::string entry_path;
+    entry_path.reserve(directory.size() + 1 + std::strlen(name));
+    entry_path = directory;
+    if (needs_separator) {
+      entry_path += kPreferredSeparator;
+    }
+    entry_path += name;
+    entries.emplace_back(rcpputils::fs::path(std::move(entry_path), deferred_parse), type);
+    errno = 0;
+  }
+  if (errno != 0) {
+    assign_errno(ec);
+    entries.clear();
+  } else {
+    ec.clear();
+  }
+  closedir(dir);
+  return entries;
+}
+
+#else
+
+directory_handle::directory_handle(const rcpputils::fs::path &, std::error_code & ec)
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+}
+
+void directory_handle::close() noexcept
+{
+}
+
+directory_handle directory_handle::open(std::string_view, std::error_code & ec) const
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+  return directory_handle();
+}
+
+file_status directory_handle::status(std::string_view, std::error_code & ec) const noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+  return file_status();
+}
+
+file_status directory_handle::symlink_status(
+  std::string_view, std::error_code & ec) const noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+  return file_status();
+}
+
+bool directory_handle::exists(std::string_view, std::error_code & ec) const noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+  return false;
+}
+
+bool directory_handle::create_directory(std::string_view, std::error_code & ec) const noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+  return false;
+}
+
+bool directory_handle::remove(std::string_view, std::error_code & ec) const noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+  return false;
+}
+
+void directory_handle::rename(
+  std::string_view, const directory_handle &, std::string_view,
+  std::error_code & ec) const noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+}
+
+std::vector<directory_entry> directory_handle::list(std::error_code & ec) const
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+  return std::vector<directory_entry>();
+}
+
+#endif
+
+}  // namespace fs
+}  // namespace rcpputils
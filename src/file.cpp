@@ -0,0 +1,477 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rcpputils/file.hpp"
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/stat.h>
+#  include <sys/uio.h>
+#  include <unistd.h>
+#endif
+
+namespace rcpputils
+{
+namespace fs
+{
+
+file::file(const path & p, open_flags flags)
+{
+  open(p, flags);
+}
+
+file::~file()
+{
+  close();
+}
+
+file::file(file && other) noexcept
+: fd_(std::exchange(other.fd_, -1))
+{
+}
+
+file & file::operator=(file && other) noexcept
+{
+  if (this != &other) {
+    close();
+    fd_ = std::exchange(other.fd_, -1);
+  }
+  return *this;
+}
+
+void file::open(const path & p, open_flags flags)
+{
+  std::error_code ec;
+  open(p, flags, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot open file"};
+  }
+}
+
+void file::close() noexcept
+{
+  std::error_code ec;
+  close(ec);
+}
+
+#ifndef _WIN32
+
+namespace
+{
+
+static_assert(
+  sizeof(const_buffer) == sizeof(struct iovec) && sizeof(mutable_buffer) == sizeof(struct iovec),
+  "buffers are expected to have the layout of struct iovec");
+
+/// \internal The number of buffers passed to a single vectored call, well below IOV_MAX.
+constexpr int kMaxVectors = 64;
+
+/// \internal Store the errno value of a failure in ec, and clear errno.
+void assign_errno(std::error_code & ec) noexcept
+{
+  ec.assign(errno, std::system_category());
+  errno = 0;
+}
+
+/**
+ * \internal Transfer buffers in turn with calls of a vectored function, until all bytes are
+ * transferred, the end of the file is reached, or a call fails.
+ *
+ * The function is called with the vectors left to transfer, their number, and the number of
+ * bytes transferred so far, to offset positional calls.
+ */
+template<typename BufferT, typename FunctionT>
+size_t transfer_all(
+  const BufferT * buffers, size_t count, bool reading, FunctionT && function,
+  std::error_code & ec) noexcept
+{
+  ec.clear();
+  struct iovec vectors[kMaxVectors];
+  size_t total = 0;
+  size_t index = 0;
+  // The bytes of buffers[index] transferred already
+  size_t skip = 0;
+  while (index < count) {
+    int num_vectors = 0;
+    size_t requested = 0;
+    for (size_t i = index; i < count && num_vectors < kMaxVectors; ++i, ++num_vectors) {
+      auto * data = static_cast<char *>(const_cast<void *>(buffers[i].data));
+      const size_t skipped = i == index ? skip : 0;
+      vectors[num_vectors].iov_base = skipped != 0 ? data + skipped : data;
+      vectors[num_vectors].iov_len = buffers[i].size - skipped;
+      requested += vectors[num_vectors].iov_len;
+    }
+    if (requested == 0) {
+      index += static_cast<size_t>(num_vectors);
+      skip = 0;
+      continue;
+    }
+    const ssize_t result = function(vectors, num_vectors, total);
+    if (result < 0) {
+      if (errno == EINTR) {
+        errno = 0;
+        continue;
+      }
+      assign_errno(ec);
+      return total;
+    }
+    if (result == 0) {
+      if (!reading) {
+        ec = std::make_error_code(std::errc::io_error);
+      }
+      return total;
+    }
+    total += static_cast<size_t>(result);
+    size_t done = skip + static_cast<size_t>(result);
+    while (index < count && done >= buffers[index].size) {
+      done -= buffers[index].size;
+      ++index;
+    }
+    skip = done;
+  }
+  return total;
+}
+
+}  // namespace
+
+void file::open(const path & p, open_flags flags, std::error_code & ec) noexcept
+{
+  close();
+  const bool reading = (flags & open_flags::read) == open_flags::read;
+  const bool writing = (flags & open_flags::write) == open_flags::write;
+  if (!reading && !writing) {
+    ec = std::make_error_code(std::errc::invalid_argument);
+    return;
+  }
+  int native_flags = O_CLOEXEC | (reading && writing ? O_RDWR : (writing ? O_WRONLY : O_RDONLY));
+  if ((flags & open_flags::create) == open_flags::create) {
+    native_flags |= O_CREAT;
+  }
+  if ((flags & open_flags::truncate) == open_flags::truncate) {
+    native_flags |= O_TRUNC;
+  }
+  if ((flags & open_flags::append) == open_flags::append) {
+    native_flags |= O_APPEND;
+  }
+  if ((flags & open_flags::exclusive) == open_flags::exclusive) {
+    native_flags |= O_EXCL;
+  }
+#ifdef O_DIRECT
+  if ((flags & open_flags::direct) == open_flags::direct) {
+    native_flags |= O_DIRECT;
+  }
+#endif
+  do {
+    fd_ = ::open(p.native().c_str(), native_flags, 0666);
+  } while (fd_ < 0 && errno == EINTR);
+  if (fd_ < 0) {
+    assign_errno(ec);
+    return;
+  }
+#ifdef __APPLE__
+  if ((flags & open_flags::direct) == open_flags::direct && fcntl(fd_, F_NOCACHE, 1) != 0) {
+    assign_errno(ec);
+    close();
+    return;
+  }
+#endif
+  ec.clear();
+}
+
+void file::close(std::error_code & ec) noexcept
+{
+  ec.clear();
+  if (fd_ < 0) {
+    return;
+  }
+  // The descriptor is released even if close() fails, so it must not be retried
+  if (::close(std::exchange(fd_, -1)) != 0) {
+    assign_errno(ec);
+  }
+}
+
+size_t file::read(void * data, size_t size, std::error_code & ec) noexcept
+{
+  const mutable_buffer buffer{data, size};
+  return readv(&buffer, 1, ec);
+}
+
+size_t file::write(const void * data, size_t size, std::error_code & ec) noexcept
+{
+  const const_buffer buffer{data, size};
+  return writev(&buffer, 1, ec);
+}
+
+size_t file::pread(void * data, size_t size, uint64_t offset, std::error_code & ec) const noexcept
+{
+  const mutable_buffer buffer{data, size};
+  return transfer_all(
+    &buffer, 1, true, [this, offset](const struct iovec * vectors, int, size_t done) {
+      return ::pread(
+        fd_, vectors[0].iov_base, vectors[0].iov_len, static_cast<off_t>(offset + done));
+    }, ec);
+}
+
+size_t file::pwrite(
+  const void * data, size_t size, uint64_t offset, std::error_code & ec) const noexcept
+{
+  const const_buffer buffer{data, size};
+  return transfer_all(
+    &buffer, 1, false, [this, offset](const struct iovec * vectors, int, size_t done) {
+      return ::pwrite(
+        fd_, vectors[0].iov_base, vectors[0].iov_len, static_cast<off_t>(offset + done));
+    }, ec);
+}
+
+size_t file::readv(const mutable_buffer * buffers, size_t count, std::error_code & ec) noexcept
+{
+  return transfer_all(
+    buffers, count, true, [this](const struct iovec * vectors, int num_vectors, size_t) {
+      return ::readv(fd_, vectors, num_vectors);
+    }, ec);
+}
+
+size_t file::writev(const const_buffer * buffers, size_t count, std::error_code & ec) noexcept
+{
+  return transfer_all(
+    buffers, count, false, [this](const struct iovec * vectors, int num_vectors, size_t) {
+      return ::writev(fd_, vectors, num_vectors);
+    }, ec);
+}
+
+size_t file::preadv(
+  const mutable_buffer * buffers, size_t count, uint64_t offset,
+  std::error_code & ec) const noexcept
+{
+  return transfer_all(
+    buffers, count, true,
+    [this, offset](const struct iovec * vectors, int num_vectors, size_t done) {
+#ifdef __linux__
+      return ::preadv(fd_, vectors, num_vectors, static_cast<off_t>(offset + done));
+#else
+      // One buffer at a time, the loop calling again for the next ones
+      static_cast<void>(num_vectors);
+      return ::pread(
+        fd_, vectors[0].iov_base, vectors[0].iov_len, static_cast<off_t>(offset + done));
+#endif
+    }, ec);
+}
+
+size_t file::pwritev(
+  const const_buffer * buffers, size_t count, uint64_t offset,
+  std::error_code & ec) const noexcept
+{
+  return transfer_all(
+    buffers, count, false,
+    [this, offset](const struct iovec * vectors, int num_vectors, size_t done) {
+#ifdef __linux__
+      return ::pwritev(fd_, vectors, num_vectors, static_cast<off_t>(offset + done));
+#else
+      static_cast<void>(num_vectors);
+      return ::pwrite(
+        fd_, vectors[0].iov_base, vectors[0].iov_len, static_cast<off_t>(offset + done));
+#endif
+    }, ec);
+}
+
+void file::allocate(uint64_t offset, uint64_t length, std::error_code & ec) const noexcept
+{
+  ec.clear();
+#ifdef __linux__
+  if (fallocate(fd_, 0, static_cast<off_t>(offset), static_cast<off_t>(length)) == 0) {
+    return;
+  }
+  if (errno != EOPNOTSUPP && errno != ENOSYS) {
+    assign_errno(ec);
+    return;
+  }
+  // Not all filesystems can allocate blocks ahead, let the C library write them instead
+  errno = 0;
+#endif
+#ifdef __APPLE__
+  static_cast<void>(offset);
+  static_cast<void>(length);
+  ec = std::make_error_code(std::errc::function_not_supported);
+#else
+  // Returns the error instead of setting errno
+  const int error = posix_fallocate(fd_, static_cast<off_t>(offset), static_cast<off_t>(length));
+  if (error != 0) {
+    ec.assign(error, std::system_category());
+  }
+#endif
+}
+
+void file::resize(uint64_t size, std::error_code & ec) const noexcept
+{
+  ec.clear();
+  if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+    assign_errno(ec);
+  }
+}
+
+uint64_t file::size(std::error_code & ec) const noexcept
+{
+  struct stat stat_buffer;
+  if (fstat(fd_, &stat_buffer) != 0) {
+    assign_errno(ec);
+    return static_cast<uint64_t>(-1);
+  }
+  ec.clear();
+  return static_cast<uint64_t>(stat_buffer.st_size);
+}
+
+void file::sync_data(std::error_code & ec) const noexcept
+{
+  ec.clear();
+#ifdef __APPLE__
+  const bool synced = fsync(fd_) == 0;
+#else
+  const bool synced = fdatasync(fd_) == 0;
+#endif
+  if (!synced) {
+    assign_errno(ec);
+  }
+}
+
+void file::sync(std::error_code & ec) const noexcept
+{
+  ec.clear();
+  if (fsync(fd_) != 0) {
+    assign_errno(ec);
+  }
+}
+
+bool file::advise(file_advice advice, uint64_t offset, uint64_t length) const noexcept
+{
+#ifdef __APPLE__
+  static_cast<void>(advice);
+  static_cast<void>(offset);
+  static_cast<void>(length);
+  return false;
+#else
+  int native_advice = POSIX_FADV_NORMAL;
+  switch (advice) {
+    case file_advice::normal: native_advice = POSIX_FADV_NORMAL; break;
+    case file_advice::sequential: native_advice = POSIX_FADV_SEQUENTIAL; break;
+    case file_advice::random: native_advice = POSIX_FADV_RANDOM; break;
+    case file_advice::willneed: native_advice = POSIX_FADV_WILLNEED; break;
+    case file_advice::dontneed: native_advice = POSIX_FADV_DONTNEED; break;
+    case file_advice::noreuse: native_advice = POSIX_FADV_NOREUSE; break;
+  }
+  return posix_fadvise(
+    fd_, static_cast<off_t>(offset), static_cast<off_t>(length), native_advice) == 0;
+#endif
+}
+
+#else
+
+void file::open(const path &, open_flags, std::error_code & ec) noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+}
+
+void file::close(std::error_code & ec) noexcept
+{
+  ec.clear();
+}
+
+size_t file::read(void *, size_t, std::error_code & ec) noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+  return 0;
+}
+
+size_t file::write(const void *, size_t, std::error_code & ec) noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+  return 0;
+}
+
+size_t file::pread(void *, size_t, uint64_t, std::error_code & ec) const noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+  return 0;
+}
+
+size_t file::pwrite(const void *, size_t, uint64_t, std::error_code & ec) const noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+  return 0;
+}
+
+size_t file::readv(const mutable_buffer *, size_t, std::error_code & ec) noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+  return 0;
+}
+
+size_t file::writev(const const_buffer *, size_t, std::error_code & ec) noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+  return 0;
+}
+
+size_t file::preadv(
+  const mutable_buffer *, size_t, uint64_t, std::error_code & ec) const noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+  return 0;
+}
+
+size_t file::pwritev(
+  const const_buffer *, size_t, uint64_t, std::error_code & ec) const noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+  return 0;
+}
+
+void file::allocate(uint64_t, uint64_t, std::error_code & ec) const noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+}
+
+void file::resize(uint64_t, std::error_code & ec) const noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+}
+
+uint64_t file::size(std::error_code & ec) const noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+  return static_cast<uint64_t>(-1);
+}
+
+void file::sync_data(std::error_code & ec) const noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+}
+
+void file::sync(std::error_code & ec) const noexcept
+{
+  ec = std::make_error_code(std::errc::function_not_supported);
+}
+
+bool file::advise(file_advice, uint64_t, uint64_t) const noexcept
+{
+  return false;
+}
+
+#endif
+
+}  // namespace fs
+}  // namespace rcpputils
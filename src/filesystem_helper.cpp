@@ -41,9 +41,23 @@
 #include <sys/stat.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #ifdef _WIN32
@@ -52,16 +66,30 @@
 #  include <windows.h>
 #  include <direct.h>
 #  include <fileapi.h>
+#  include <fcntl.h>
 #  include <io.h>
+#  include <process.h>
 #  define access _access_s
 #else
 #  include <dirent.h>
+#  include <fcntl.h>
+#  include <sys/ioctl.h>
+#  include <sys/mman.h>
 #  include <sys/types.h>
 #  include <unistd.h>
+#  ifdef __linux__
+#    include <linux/fs.h>
+#    include <sys/sendfile.h>
+#    include <sys/syscall.h>
+#    include <sys/sysmacros.h>
+#    if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup) && defined(STATX_TYPE)
+#      include <linux/io_uring.h>
+#      define RCPPUTILS_HAS_IO_URING
+#    endif
+#  endif
 #endif
 
 #include "rcutils/env.h"
-#include "rcpputils/split.hpp"
 
 namespace rcpputils
 {
@@ -69,408 +97,3465 @@ namespace fs
 {
 
 /// \internal Returns true if the path is an absolute path with a drive letter on Windows.
-static bool is_absolute_with_drive_letter(const std::string & path);
+static bool is_absolute_with_drive_letter(std::string_view path);
 
-path::path(const std::string & p)  // NOLINT(runtime/explicit): this is a conversion constructor
-: path_(p)
-{
-  std::replace(path_.begin(), path_.end(), '\\', kPreferredSeparator);
-  std::replace(path_.begin(), path_.end(), '/', kPreferredSeparator);
-  path_as_vector_ = split(path_, kPreferredSeparator);
-}
+/// \internal Returns true if a path that is not normalized yet would be absolute once it is.
+static bool is_absolute_before_normalization(std::string_view path);
 
-std::string path::string() const
+/// \internal Replace the separator that is not preferred on this platform with the preferred one.
+static void normalize_separators(std::string & p, size_t from = 0)
 {
-  return path_;
+  constexpr char kOtherSeparator = kPreferredSeparator == '/' ? '\\' : '/';
+  std::replace(p.begin() + from, p.end(), kOtherSeparator, kPreferredSeparator);
 }
 
-bool path::exists() const
+/// \internal Returns the file type encoded in the st_mode field of a stat result.
+static file_type type_from_mode(unsigned mode) noexcept
 {
-  return access(path_.c_str(), 0) == 0;
+#ifdef _WIN32
+  switch (mode & S_IFMT) {
+    case S_IFREG: return file_type::regular;
+    case S_IFDIR: return file_type::directory;
+    case S_IFCHR: return file_type::character;
+    default: return file_type::unknown;
+  }
+#else
+  if (S_ISREG(mode)) {
+    return file_type::regular;
+  } else if (S_ISDIR(mode)) {
+    return file_type::directory;
+  } else if (S_ISLNK(mode)) {
+    return file_type::symlink;
+  } else if (S_ISBLK(mode)) {
+    return file_type::block;
+  } else if (S_ISCHR(mode)) {
+    return file_type::character;
+  } else if (S_ISFIFO(mode)) {
+    return file_type::fifo;
+  } else if (S_ISSOCK(mode)) {
+    return file_type::socket;
+  }
+  return file_type::unknown;
+#endif
 }
 
-bool path::is_directory() const noexcept
+/// \internal Query the status of a path, storing the errno value of a failure in `error`.
+static file_status query_status(const char * p, bool follow_symlinks, int & error) noexcept
 {
   struct stat stat_buffer;
-  const auto rc = stat(path_.c_str(), &stat_buffer);
-
+#ifdef _WIN32
+  (void)follow_symlinks;  // Windows stat() does not report symbolic links
+  const auto rc = stat(p, &stat_buffer);
+#else
+  const auto rc = follow_symlinks ? stat(p, &stat_buffer) : lstat(p, &stat_buffer);
+#endif
   if (rc != 0) {
-    return false;
+    error = errno;
+    if (error == ENOENT || error == ENOTDIR) {
+      return file_status(file_type::not_found);
+    }
+    return file_status();
   }
+  error = 0;
 
+  const auto type = type_from_mode(stat_buffer.st_mode);
 #ifdef _WIN32
-  return (stat_buffer.st_mode & S_IFDIR) == S_IFDIR;
+  const auto last_write_time = file_time_type(std::chrono::seconds(stat_buffer.st_mtime));
 #else
-  return S_ISDIR(stat_buffer.st_mode);
+#  ifdef __APPLE__
+  const auto & mtime = stat_buffer.st_mtimespec;
+#  else
+  const auto & mtime = stat_buffer.st_mtim;
+#  endif
+  const auto last_write_time = file_time_type(
+    std::chrono::seconds(mtime.tv_sec) + std::chrono::nanoseconds(mtime.tv_nsec));
 #endif
+  return file_status(
+    type,
+    static_cast<perms>(stat_buffer.st_mode & static_cast<unsigned>(perms::mask)),
+    static_cast<uint64_t>(stat_buffer.st_size),
+    last_write_time,
+    static_cast<uint64_t>(stat_buffer.st_ino),
+    static_cast<uint64_t>(stat_buffer.st_dev));
 }
 
-bool path::is_regular_file() const noexcept
+path::path(const std::string & p)  // NOLINT(runtime/explicit): this is a conversion constructor
+: path_(p)
 {
-  struct stat stat_buffer;
-  const auto rc = stat(path_.c_str(), &stat_buffer);
+  normalize_separators(path_);
+  parse_components(0);
+}
 
-  if (rc != 0) {
-    return false;
-  }
+path::path(std::string && p)  // NOLINT(runtime/explicit): this is a conversion constructor
+: path_(std::move(p))
+{
+  normalize_separators(path_);
+  parse_components(0);
+}
 
-#ifdef _WIN32
-  return (stat_buffer.st_mode & S_IFREG) == S_IFREG;
-#else
-  return S_ISREG(stat_buffer.st_mode);
-#endif
+path::path(std::string_view p)  // NOLINT(runtime/explicit): this is a conversion constructor
+: path_(p)
+{
+  normalize_separators(path_);
+  parse_components(0);
 }
 
-uint64_t path::file_size() const
+path::path(const char * p)  // NOLINT(runtime/explicit): this is a conversion constructor
+: path_(p)
 {
-  if (this->is_directory()) {
-    auto ec = std::make_error_code(std::errc::is_a_directory);
-    throw std::system_error{ec, "cannot get file size"};
-  }
+  normalize_separators(path_);
+  parse_components(0);
+}
 
-  struct stat stat_buffer;
-  const auto rc = stat(path_.c_str(), &stat_buffer);
+path::path(std::string p, deferred_parse_t)
+: path_(std::move(p)), parse_state_(parse_state::unparsed)
+{
+  normalize_separators(path_);
+}
 
-  if (rc != 0) {
-    std::error_code ec{errno, std::system_category()};
-    errno = 0;
-    throw std::system_error{ec, "cannot get file size"};
+path::path(const path & p)
+: path_(p.path_)
+{
+  // The components of a path that another thread may be parsing are only read once published
+  if (p.is_parsed()) {
+    components_ = p.components_;
   } else {
-    return static_cast<uint64_t>(stat_buffer.st_size);
+    parse_state_.store(parse_state::unparsed, std::memory_order_relaxed);
   }
 }
 
-bool path::empty() const
+path & path::operator=(const path & p)
 {
-  return path_.empty();
+  if (this != &p) {
+    path_ = p.path_;
+    if (p.is_parsed()) {
+      components_ = p.components_;
+      parse_state_.store(parse_state::parsed, std::memory_order_relaxed);
+    } else {
+      components_.clear();
+      parse_state_.store(parse_state::unparsed, std::memory_order_relaxed);
+    }
+  }
+  return *this;
 }
 
-bool path::is_absolute() const
+path::path(path && p) noexcept
+: path_(std::move(p.path_)), components_(std::move(p.components_)),
+  parse_state_(p.parse_state_.load(std::memory_order_relaxed))
 {
-  return path_.size() > 0 &&
-         (path_[0] == kPreferredSeparator ||
-         is_absolute_with_drive_letter(path_));
 }
 
-std::vector<std::string>::const_iterator path::cbegin() const
+path & path::operator=(path && p) noexcept
 {
-  return path_as_vector_.cbegin();
+  path_ = std::move(p.path_);
+  components_ = std::move(p.components_);
+  parse_state_.store(p.parse_state_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  return *this;
 }
 
-std::vector<std::string>::const_iterator path::cend() const
+bool path::is_parsed() const noexcept
 {
-  return path_as_vector_.cend();
+  return parse_state_.load(std::memory_order_acquire) == parse_state::parsed;
 }
 
-path path::parent_path() const
+void path::ensure_parsed() const
 {
-  // Edge case: empty path
-  if (this->empty()) {
-    return path("");
+  if (is_parsed()) {
+    return;
   }
-
-  // Edge case: if path only consists of one part, then return '.' or '/'
-  //            depending if the path is absolute or not
-  if (1u == path_as_vector_.size()) {
-    if (this->is_absolute()) {
-      // Windows is tricky, since an absolute path may start with 'C:\\' or '\\'
-      if (is_absolute_with_drive_letter(path_)) {
-        return path(path_as_vector_[0] + kPreferredSeparator);
-      }
-      return path(std::string(1, kPreferredSeparator));
+  auto expected = parse_state::unparsed;
+  if (parse_state_.compare_exchange_strong(expected, parse_state::parsing)) {
+    try {
+      components_.clear();
+      parse_components(0);
+    } catch (...) {
+      parse_state_.store(parse_state::unparsed, std::memory_order_release);
+      throw;
     }
-    return path(".");
+    parse_state_.store(parse_state::parsed, std::memory_order_release);
+    return;
   }
-
-  // Edge case: with a path 'C:\\foo' we want to return 'C:\\' not 'C:'
-  // Don't drop the root directory from an absolute path on Windows starting with a letter drive
-  if (2u == path_as_vector_.size() && is_absolute_with_drive_letter(path_)) {
-    return path(path_as_vector_[0] + kPreferredSeparator);
+  // Another thread is parsing, which takes no longer than scanning the string once
+  while (!is_parsed()) {
+    if (parse_state_.load(std::memory_order_acquire) == parse_state::unparsed) {
+      // That thread failed, so try again
+      ensure_parsed();
+      return;
+    }
+    std::this_thread::yield();
   }
+}
 
-  path parent;
-  for (auto it = this->cbegin(); it != --this->cend(); ++it) {
-    if (parent.empty() && (!this->is_absolute() || is_absolute_with_drive_letter(path_))) {
-      // This handles the case where we are dealing with a relative path or
-      // the Windows drive letter; in both cases we don't want a separator at
-      // the beginning, so just copy the piece directly.
-      parent = *it;
-    } else {
-      parent /= *it;
+void path::parse_components(size_t from) const
+{
+  // Mirror the tokenization of rcpputils::split(): an empty path has no components, a leading
+  // separator yields an empty first component and a trailing separator does not add one.
+  components_.reserve(
+    components_.size() + 1 +
+    static_cast<size_t>(std::count(path_.begin() + from, path_.end(), kPreferredSeparator)));
+  while (from < path_.size()) {
+    auto end = path_.find(kPreferredSeparator, from);
+    if (end == std::string::npos) {
+      end = path_.size();
     }
+    components_.push_back({static_cast<uint32_t>(from), static_cast<uint32_t>(end - from)});
+    from = end + 1;
   }
-  return parent;
 }
 
-path path::filename() const
+std::string path::string() const
 {
-  return path_.empty() ? path() : *--this->cend();
+  return path_;
 }
 
-path path::extension() const
+const std::string & path::native() const noexcept
 {
-  const char * delimiter = ".";
-  auto split_fname = rcpputils::split(this->string(), *delimiter);
-  return split_fname.size() == 1 ? path("") : path("." + split_fname.back());
+  return path_;
 }
 
-path path::operator/(const std::string & other) const
+bool path::exists() const
 {
-  return this->operator/(path(other));
+  return access(path_.c_str(), 0) == 0;
 }
 
-path & path::operator/=(const std::string & other)
+bool path::is_directory() const noexcept
 {
-  this->operator/=(path(other));
-  return *this;
+  int error = 0;
+  return rcpputils::fs::is_directory(query_status(path_.c_str(), true, error));
 }
 
-path path::operator/(const path & other) const
+bool path::is_regular_file() const noexcept
 {
-  return path(*this).operator/=(other);
+  int error = 0;
+  return rcpputils::fs::is_regular_file(query_status(path_.c_str(), true, error));
 }
 
-path & path::operator/=(const path & other)
+uint64_t path::file_size() const
 {
-  if (other.is_absolute()) {
-    this->path_ = other.path_;
-    this->path_as_vector_ = other.path_as_vector_;
-  } else {
-    if (this->path_.empty() || this->path_[this->path_.length() - 1] != kPreferredSeparator) {
-      // This ensures that we don't put duplicate separators into the path;
-      // this can happen, for instance, on absolute paths where the first
-      // item in the vector is the empty string.
-      this->path_ += kPreferredSeparator;
-    }
-    this->path_ += other.string();
-    this->path_as_vector_.insert(
-      std::end(this->path_as_vector_),
-      std::begin(other.path_as_vector_), std::end(other.path_as_vector_));
+  std::error_code ec;
+  const auto size = file_size(ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot get file size"};
   }
-  return *this;
+  return size;
 }
 
-static bool is_absolute_with_drive_letter(const std::string & path)
+uint64_t path::file_size(std::error_code & ec) const noexcept
 {
-  (void)path;  // Maybe unused
-#ifdef _WIN32
-  if (path.empty()) {
-    return false;
+  int error = 0;
+  const auto s = query_status(path_.c_str(), true, error);
+  if (error != 0) {
+    ec.assign(error, std::system_category());
+    errno = 0;
+    return static_cast<uint64_t>(-1);
   }
-  return 0 == path.compare(1, 2, ":\\");
-#else
-  return false;  // only Windows contains absolute paths starting with drive letters
-#endif
+  return rcpputils::fs::file_size(s, ec);
 }
 
-bool is_regular_file(const path & p) noexcept
+bool path::empty() const
 {
-  return p.is_regular_file();
+  return path_.empty();
 }
 
-bool is_directory(const path & p) noexcept
+bool path::is_absolute() const
 {
-  return p.is_directory();
+  return path_.size() > 0 &&
+         (path_[0] == kPreferredSeparator ||
+         is_absolute_with_drive_letter(path_));
 }
 
-uint64_t file_size(const path & p)
+int path::compare(const path & other) const noexcept
 {
-  return p.file_size();
+  // Ordering the separator before any other character orders the components themselves
+  const auto mismatch = std::mismatch(
+    path_.begin(), path_.end(), other.path_.begin(), other.path_.end());
+  if (mismatch.first == path_.end()) {
+    return mismatch.second == other.path_.end() ? 0 : -1;
+  }
+  if (mismatch.second == other.path_.end()) {
+    return 1;
+  }
+  auto rank = [](char c) {
+      return c == kPreferredSeparator ? 0 : static_cast<int>(static_cast<unsigned char>(c)) + 1;
+    };
+  return rank(*mismatch.first) - rank(*mismatch.second);
 }
 
-bool exists(const path & path_to_check)
+path::const_iterator path::cbegin() const
 {
-  return path_to_check.exists();
+  ensure_parsed();
+  return const_iterator(this, components_.data());
 }
 
-path temp_directory_path()
+path::const_iterator path::cend() const
 {
-#ifdef _WIN32
-#ifdef UNICODE
-#error "rcpputils::fs does not support Unicode paths"
-#endif
-  TCHAR temp_path[MAX_PATH];
-  DWORD size = GetTempPathA(MAX_PATH, temp_path);
-  if (size > MAX_PATH || size == 0) {
-    std::error_code ec(static_cast<int>(GetLastError()), std::system_category());
-    throw std::system_error(ec, "cannot get temporary directory path");
+  ensure_parsed();
+  return const_iterator(this, components_.data() + components_.size());
+}
+
+path path::parent_path() const
+{
+  // Edge case: empty path
+  if (this->empty()) {
+    return path("");
   }
-  temp_path[size] = '\0';
-#else
-  const char * temp_path = NULL;
-  const char * ret_str = rcutils_get_env("TMPDIR", &temp_path);
-  if (NULL != ret_str || *temp_path == '\0') {
-    temp_path = "/tmp";
+
+  const auto parent = this->parent_path_view();
+  // Edge case: a relative path with only one part has '.' as its parent
+  if (parent.empty()) {
+    return path(".");
   }
-#endif
-  return path(temp_path);
+  return path(parent);
 }
 
-path create_temp_directory(const std::string & base_name, const path & parent_path)
+std::string_view path::parent_path_view() const noexcept
 {
-  const auto template_path = base_name + "XXXXXX";
-  std::string full_template_str = (parent_path / template_path).string();
-  if (!create_directories(parent_path)) {
-    std::error_code ec{errno, std::system_category()};
-    errno = 0;
-    throw std::system_error(ec, "could not create the parent directory");
+  const std::string_view p(path_);
+  // A trailing separator does not start a new component, so skip it
+  auto end = p.size();
+  if (end > 0 && p[end - 1] == kPreferredSeparator) {
+    --end;
   }
 
-#ifdef _WIN32
-  errno_t errcode = _mktemp_s(&full_template_str[0], full_template_str.size() + 1);
-  if (errcode) {
-    std::error_code ec(static_cast<int>(errcode), std::system_category());
-    throw std::system_error(ec, "could not format the temp directory name template");
+  // Windows is tricky, since an absolute path may start with 'C:\\' or '\\'
+  size_t root_size = 0;
+  if (is_absolute_with_drive_letter(p)) {
+    root_size = 3;
+  } else if (this->is_absolute()) {
+    root_size = 1;
   }
-  const path final_path{full_template_str};
-  if (!create_directories(final_path)) {
-    std::error_code ec(static_cast<int>(GetLastError()), std::system_category());
-    throw std::system_error(ec, "could not create the temp directory");
+
+  const auto last_separator =
+    end > 0 ? p.rfind(kPreferredSeparator, end - 1) : std::string_view::npos;
+  if (last_separator == std::string_view::npos) {
+    // A single component is either the root itself, or a relative name without parent
+    return p.substr(0, root_size);
   }
-#else
-  const char * dir_name = mkdtemp(&full_template_str[0]);
-  if (dir_name == nullptr) {
-    std::error_code ec{errno, std::system_category()};
-    errno = 0;
-    throw std::system_error(ec, "could not format or create the temp directory");
+  // Don't drop the root directory, e.g. with '/foo' or 'C:\\foo' return '/' or 'C:\\'
+  if (last_separator + 1 <= root_size) {
+    return p.substr(0, root_size);
   }
-  const path final_path{dir_name};
-#endif
+  return p.substr(0, last_separator);
+}
 
-  return final_path;
+/// \internal Returns the last component of a path, as yielded by path::cend().
+static std::string_view filename_of(std::string_view p) noexcept
+{
+  if (!p.empty() && p.back() == kPreferredSeparator) {
+    p.remove_suffix(1);
+  }
+  const auto last_separator = p.rfind(kPreferredSeparator);
+  return last_separator == std::string_view::npos ? p : p.substr(last_separator + 1);
 }
 
-path current_path()
+/// \internal Returns the extension of a filename, including the leading '.'.
+static std::string_view extension_of(std::string_view filename) noexcept
 {
-#ifdef _WIN32
-#ifdef UNICODE
-#error "rcpputils::fs does not support Unicode paths"
-#endif
-  char cwd[MAX_PATH];
-  if (nullptr == _getcwd(cwd, MAX_PATH)) {
-#else
-  char cwd[PATH_MAX];
-  if (nullptr == getcwd(cwd, PATH_MAX)) {
-#endif
-    std::error_code ec{errno, std::system_category()};
-    errno = 0;
-    throw std::system_error{ec, "cannot get current working directory"};
+  if (filename == "." || filename == "..") {
+    return {};
+  }
+  const auto last_dot = filename.rfind('.');
+  if (last_dot == std::string_view::npos || last_dot == 0) {
+    return {};
   }
+  return filename.substr(last_dot);
+}
 
-  return path(cwd);
+path path::filename() const
+{
+  return path_.empty() ? path() : path(this->filename_view());
 }
 
-bool create_directories(const path & p)
+std::string_view path::filename_view() const noexcept
 {
-  path p_built;
-  int status = 0;
+  return filename_of(path_);
+}
 
-  for (auto it = p.cbegin(); it != p.cend() && status == 0; ++it) {
-    if (!p_built.empty() || it->empty()) {
-      p_built /= *it;
-    } else {
-      p_built = *it;
-    }
-    if (!p_built.exists()) {
-#ifdef _WIN32
-      status = _mkdir(p_built.string().c_str());
-#else
-      status = mkdir(p_built.string().c_str(), S_IRWXU | S_IRWXG | S_IRWXO);
-#endif
-      if (status == -1 && errno == EEXIST) {
-        status = 0;
-      }
-    }
+path path::stem() const
+{
+  return path(this->stem_view());
+}
+
+std::string_view path::stem_view() const noexcept
+{
+  const auto filename = this->filename_view();
+  return filename.substr(0, filename.size() - extension_of(filename).size());
+}
+
+path path::extension() const
+{
+  return path(this->extension_view());
+}
+
+std::string_view path::extension_view() const noexcept
+{
+  return extension_of(this->filename_view());
+}
+
+/// \internal The size of the root of an absolute path, "/", or "C:\\" or "\\" on Windows.
+static size_t root_size_of(std::string_view p)
+{
+  if (is_absolute_with_drive_letter(p)) {
+    return 3;
   }
-  return status == 0 && p_built.is_directory();
+  return !p.empty() && p[0] == kPreferredSeparator ? 1 : 0;
 }
 
-bool remove(const path & p)
+/// \internal Split the components following the root, skipping empty ones.
+static std::vector<std::string_view> split_after_root(std::string_view p, size_t root_size)
 {
-#ifdef _WIN32
-  struct _stat s;
-  if (_stat(p.string().c_str(), &s) == 0) {
-    if (s.st_mode & S_IFDIR) {
-      return _rmdir(p.string().c_str()) == 0;
+  std::vector<std::string_view> names;
+  for (size_t from = root_size; from < p.size(); ) {
+    auto end = p.find(kPreferredSeparator, from);
+    if (end == std::string_view::npos) {
+      end = p.size();
     }
-    if (s.st_mode & S_IFREG) {
-      return ::remove(p.string().c_str()) == 0;
+    if (end > from) {
+      names.push_back(p.substr(from, end - from));
     }
+    from = end + 1;
   }
-  return false;
-#else
-  return ::remove(p.string().c_str()) == 0;
-#endif
+  return names;
 }
 
-bool remove_all(const path & p)
+path path::lexically_normal() const
 {
-  if (!is_directory(p)) {
-    return rcpputils::fs::remove(p);
+  if (path_.empty()) {
+    return path();
+  }
+  const std::string_view p(path_);
+  const size_t root_size = root_size_of(p);
+  std::vector<std::string_view> kept;
+  // Whether the last component named a directory, as with ".", ".." or a trailing separator
+  bool ends_with_directory = p.size() > root_size && p.back() == kPreferredSeparator;
+  for (const auto name : split_after_root(p, root_size)) {
+    ends_with_directory = false;
+    if (name == ".") {
+      ends_with_directory = true;
+    } else if (name == ".." && !kept.empty() && kept.back() != "..") {
+      kept.pop_back();
+      ends_with_directory = true;
+    } else if (name == ".." && root_size > 0) {
+      // The parent of the root is the root itself
+      ends_with_directory = true;
+    } else {
+      kept.push_back(name);
+    }
+  }
+  if (p.size() > root_size && p.back() == kPreferredSeparator) {
+    ends_with_directory = true;
   }
 
-#ifdef _WIN32
-  // We need a string of type PCZZTSTR, which is a double null terminated char ptr
-  size_t length = p.string().size();
-  TCHAR * temp_dir = new TCHAR[length + 2];
-  memcpy(temp_dir, p.string().c_str(), length);
-  temp_dir[length] = '\0';
-  temp_dir[length + 1] = '\0';  // double null terminated
-
-  SHFILEOPSTRUCT file_options;
-  file_options.hwnd = nullptr;
-  file_options.wFunc = FO_DELETE;  // delete (recursively)
-  file_options.pFrom = temp_dir;
-  file_options.pTo = nullptr;
-  file_options.fFlags = FOF_NOCONFIRMATION | FOF_SILENT;  // do not prompt user
-  file_options.fAnyOperationsAborted = FALSE;
-  file_options.lpszProgressTitle = nullptr;
-  file_options.hNameMappings = nullptr;
-
-  auto ret = SHFileOperation(&file_options);
-  delete[] temp_dir;
-
-  return 0 == ret && false == file_options.fAnyOperationsAborted;
-#else
-  DIR * dir = opendir(p.string().c_str());
-  struct dirent * directory_entry;
-  while ((directory_entry = readdir(dir)) != nullptr) {
-    // Make sure to not call ".." or "." entries in directory (might delete everything)
-    if (strcmp(directory_entry->d_name, ".") != 0 && strcmp(directory_entry->d_name, "..") != 0) {
-      auto sub_path = rcpputils::fs::path(p) / directory_entry->d_name;
-      // if directory, call recursively
-      if (sub_path.is_directory() && !rcpputils::fs::remove_all(sub_path)) {
-        return false;
-        // if not, call regular remove
-      } else if (!rcpputils::fs::remove(sub_path)) {
-        return false;
-      }
+  std::string result(p.substr(0, root_size));
+  result.reserve(p.size());
+  for (size_t i = 0; i < kept.size(); ++i) {
+    if (i > 0) {
+      result += kPreferredSeparator;
     }
+    result.append(kept[i].data(), kept[i].size());
   }
-  closedir(dir);
-  // directory is empty now, call remove
-  rcpputils::fs::remove(p);
-  return !rcpputils::fs::exists(p);
-#endif
+  if (kept.empty()) {
+    return root_size > 0 ? path(std::move(result)) : path(".");
+  }
+  if (ends_with_directory && kept.back() != "..") {
+    result += kPreferredSeparator;
+  }
+  return path(std::move(result));
 }
 
-path remove_extension(const path & file_path, int n_times)
+path path::lexically_relative(const path & base) const
 {
-  path new_path(file_path);
-  for (int i = 0; i < n_times; i++) {
-    const auto new_path_str = new_path.string();
-    const auto last_dot = new_path_str.find_last_of('.');
-    if (last_dot == std::string::npos) {
-      return new_path;
+  const std::string_view p(path_);
+  const std::string_view b(base.path_);
+  const size_t root_size = root_size_of(p);
+  if (p.substr(0, root_size) != b.substr(0, root_size_of(b))) {
+    return path();
+  }
+  const auto names = split_after_root(p, root_size);
+  const auto base_names = split_after_root(b, root_size);
+  const auto mismatch = std::mismatch(
+    names.begin(), names.end(), base_names.begin(), base_names.end());
+  if (mismatch.first == names.end() && mismatch.second == base_names.end()) {
+    return path(".");
+  }
+  // The number of directories to go up from the base before going down again
+  ptrdiff_t up = 0;
+  for (auto it = mismatch.second; it != base_names.end(); ++it) {
+    if (*it == "..") {
+      --up;
+    } else if (*it != ".") {
+      ++up;
+    }
+  }
+  if (up < 0) {
+    return path();
+  }
+  if (up == 0 && mismatch.first == names.end()) {
+    return path(".");
+  }
+  std::string result;
+  result.reserve(static_cast<size_t>(up) * 3 + p.size());
+  for (ptrdiff_t i = 0; i < up; ++i) {
+    if (!result.empty()) {
+      result += kPreferredSeparator;
+    }
+    result += "..";
+  }
+  for (auto it = mismatch.first; it != names.end(); ++it) {
+    if (!result.empty()) {
+      result += kPreferredSeparator;
     }
-    new_path = path(new_path_str.substr(0, last_dot));
+    result.append(it->data(), it->size());
   }
-  return new_path;
+  return path(std::move(result));
+}
+
+path path::lexically_proximate(const path & base) const
+{
+  auto result = this->lexically_relative(base);
+  return result.empty() ? *this : result;
+}
+
+path path::copy_with_capacity(size_t extra) const
+{
+  path result;
+  result.path_.reserve(path_.size() + extra);
+  result.path_ = path_;
+  if (is_parsed()) {
+    result.components_ = components_;
+  } else {
+    result.parse_state_.store(parse_state::unparsed, std::memory_order_relaxed);
+  }
+  return result;
+}
+
+path path::operator/(const std::string & other) const &
+{
+  path result = copy_with_capacity(other.size() + 1);
+  result.append(other);
+  return result;
+}
+
+path path::operator/(const std::string & other) &&
+{
+  append(other);
+  return std::move(*this);
+}
+
+path path::operator/(const char * other) const &
+{
+  const std::string_view other_view(other);
+  path result = copy_with_capacity(other_view.size() + 1);
+  result.append(other_view);
+  return result;
+}
+
+path path::operator/(const char * other) &&
+{
+  append(other);
+  return std::move(*this);
+}
+
+path & path::operator/=(const std::string & other)
+{
+  append(other);
+  return *this;
+}
+
+path & path::operator/=(const char * other)
+{
+  append(other);
+  return *this;
+}
+
+path path::operator/(const path & other) const &
+{
+  path result = copy_with_capacity(other.path_.size() + 1);
+  result /= other;
+  return result;
+}
+
+path path::operator/(const path & other) &&
+{
+  *this /= other;
+  return std::move(*this);
+}
+
+void path::append(std::string_view other)
+{
+  if (is_absolute_before_normalization(other)) {
+    this->path_.assign(other.data(), other.size());
+    normalize_separators(this->path_);
+    this->components_.clear();
+    if (this->is_parsed()) {
+      this->parse_components(0);
+    }
+    return;
+  }
+
+  const bool was_empty = this->path_.empty();
+  if (was_empty || this->path_[this->path_.length() - 1] != kPreferredSeparator) {
+    // This ensures that we don't put duplicate separators into the path;
+    // this can happen, for instance, on absolute paths where the first
+    // component is the empty string.
+    this->path_ += kPreferredSeparator;
+  }
+  const auto offset = this->path_.length();
+  this->path_.append(other.data(), other.size());
+  normalize_separators(this->path_, offset);
+  if (this->is_parsed()) {
+    // Appending to an empty path adds an empty leading component as well.
+    this->parse_components(was_empty ? 0 : offset);
+  }
+}
+
+path & path::operator/=(const path & other)
+{
+  if (other.is_absolute()) {
+    *this = other;
+  } else {
+    if (this->path_.empty()) {
+      // The leading separator adds an empty first component, so simply
+      // parse the result from scratch.
+      this->path_ += kPreferredSeparator;
+      this->path_ += other.path_;
+      this->components_.clear();
+      if (this->is_parsed()) {
+        this->parse_components(0);
+      }
+      return *this;
+    }
+    if (this->path_[this->path_.length() - 1] != kPreferredSeparator) {
+      this->path_ += kPreferredSeparator;
+    }
+    const auto offset = static_cast<uint32_t>(this->path_.length());
+    this->path_ += other.path_;
+    if (!this->is_parsed()) {
+      // Everything gets parsed at once on first use.
+    } else if (other.is_parsed()) {
+      this->components_.reserve(this->components_.size() + other.components_.size());
+      for (const auto & c : other.components_) {
+        this->components_.push_back({c.offset + offset, c.length});
+      }
+    } else {
+      this->parse_components(offset);
+    }
+  }
+  return *this;
+}
+
+static bool is_absolute_with_drive_letter(std::string_view path)
+{
+  (void)path;  // Maybe unused
+#ifdef _WIN32
+  if (path.empty()) {
+    return false;
+  }
+  return 0 == path.compare(1, 2, ":\\");
+#else
+  return false;  // only Windows contains absolute paths starting with drive letters
+#endif
+}
+
+static bool is_absolute_before_normalization(std::string_view path)
+{
+  if (path.empty()) {
+    return false;
+  }
+  if (path[0] == '/' || path[0] == '\\') {
+    return true;
+  }
+#ifdef _WIN32
+  return path.size() >= 3 && path[1] == ':' && (path[2] == '\\' || path[2] == '/');
+#else
+  return false;  // only Windows contains absolute paths starting with drive letters
+#endif
+}
+/// \internal Query the status of a path, a missing one not being a failure.
+static file_status query_status(
+  const path & p, bool follow_symlinks, std::error_code & ec) noexcept
+{
+  int error = 0;
+  const auto s = query_status(p.native().c_str(), follow_symlinks, error);
+  if (status_known(s)) {
+    ec.clear();
+  } else {
+    ec.assign(error, std::system_category());
+    errno = 0;
+  }
+  return s;
+}
+
+file_status status(const path & p)
+{
+  std::error_code ec;
+  const auto s = status(p, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot get status"};
+  }
+  return s;
+}
+
+file_status status(const path & p, std::error_code & ec) noexcept
+{
+  return query_status(p, true, ec);
+}
+
+file_status symlink_status(const path & p)
+{
+  std::error_code ec;
+  const auto s = symlink_status(p, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot get status"};
+  }
+  return s;
+}
+
+file_status symlink_status(const path & p, std::error_code & ec) noexcept
+{
+  return query_status(p, false, ec);
+}
+
+path canonical(const path & p)
+{
+  std::error_code ec;
+  auto resolved = canonical(p, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot resolve path"};
+  }
+  return resolved;
+}
+
+path canonical(const path & p, std::error_code & ec)
+{
+  ec.clear();
+#ifdef _WIN32
+  HANDLE handle = CreateFileA(
+    p.native().c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+    OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    ec.assign(static_cast<int>(GetLastError()), std::system_category());
+    return path();
+  }
+  char resolved[MAX_PATH];
+  const DWORD length = GetFinalPathNameByHandleA(handle, resolved, MAX_PATH, FILE_NAME_NORMALIZED);
+  const DWORD error = GetLastError();
+  CloseHandle(handle);
+  if (length == 0 || length >= MAX_PATH) {
+    ec.assign(static_cast<int>(error), std::system_category());
+    return path();
+  }
+  // Drop the "\\?\" prefix of the final path name
+  std::string_view result(resolved, length);
+  if (result.substr(0, 4) == "\\\\?\\") {
+    result.remove_prefix(4);
+  }
+  return path(result);
+#else
+  std::unique_ptr<char, decltype(&std::free)> resolved(
+    realpath(p.native().c_str(), nullptr), &std::free);
+  if (!resolved) {
+    ec.assign(errno, std::system_category());
+    errno = 0;
+    return path();
+  }
+  return path(resolved.get());
+#endif
+}
+
+struct canonical_cache::impl
+{
+  /// Resolve an absolute directory, from its resolved parent unless it was resolved already.
+  std::string resolve_directory(std::string_view dir, std::error_code & ec)
+  {
+    std::string key(dir);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      const auto found = directories.find(key);
+      if (found != directories.end()) {
+        return found->second;
+      }
+    }
+    // Resolved without the lock, so that other threads keep using the cache meanwhile
+    const size_t root_size = root_size_of(dir);
+    std::string resolved;
+    if (dir.size() <= root_size) {
+      resolved = rcpputils::fs::canonical(path(key, deferred_parse), ec).native();
+    } else {
+      const auto last = dir.rfind(kPreferredSeparator);
+      const auto parent = resolve_directory(dir.substr(0, std::max(last, root_size)), ec);
+      if (!ec) {
+        resolved = resolve_child(parent, dir.substr(last + 1), true, ec);
+      }
+    }
+    if (ec) {
+      return std::string();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    // Another thread may have resolved it too, to the same directory
+    directories.emplace(std::move(key), resolved);
+    return resolved;
+  }
+
+  /// Resolve an entry of a resolved directory, with a single lstat call unless it is a symlink.
+  static std::string resolve_child(
+    const std::string & dir, std::string_view name, bool must_be_directory, std::error_code & ec)
+  {
+    const size_t root_size = root_size_of(dir);
+    if (name.empty() || name == ".") {
+      return dir;
+    }
+    if (name == "..") {
+      // The directory has no symlink left, so its parent is found lexically
+      const auto last = dir.rfind(kPreferredSeparator);
+      return dir.substr(0, std::max(last, root_size));
+    }
+    std::string candidate = dir;
+    if (candidate.size() > root_size) {
+      candidate += kPreferredSeparator;
+    }
+    candidate.append(name.data(), name.size());
+    int error = 0;
+    const auto s = query_status(candidate.c_str(), false, error);
+    if (error != 0) {
+      // Missing or not below a directory, reported as realpath() does
+      ec.assign(error, std::system_category());
+      errno = 0;
+      return std::string();
+    }
+    if (s.type() == file_type::symlink) {
+      if (must_be_directory) {
+        // Then realpath() fails with ENOTDIR unless the target is a directory
+        candidate += kPreferredSeparator;
+      }
+      return rcpputils::fs::canonical(path(candidate, deferred_parse), ec).native();
+    }
+    if (must_be_directory && s.type() != file_type::directory) {
+      ec = std::make_error_code(std::errc::not_a_directory);
+      return std::string();
+    }
+    return candidate;
+  }
+
+  mutable std::mutex mutex;
+  // The resolved directories, keyed by their absolute path as given
+  std::unordered_map<std::string, std::string> directories;
+};
+
+canonical_cache::canonical_cache()
+: impl_(std::make_unique<impl>())
+{
+}
+
+canonical_cache::~canonical_cache() = default;
+
+path canonical_cache::canonical(const path & p)
+{
+  std::error_code ec;
+  auto resolved = canonical(p, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot resolve path"};
+  }
+  return resolved;
+}
+
+path canonical_cache::canonical(const path & p, std::error_code & ec)
+{
+  ec.clear();
+  path absolute_path = p;
+  if (!p.is_absolute()) {
+    absolute_path = current_path(ec);
+    if (ec) {
+      return path();
+    }
+    absolute_path /= p;
+  }
+  std::string_view full(absolute_path.native());
+  const size_t root_size = root_size_of(full);
+  // Like with realpath(), a trailing separator requires a directory
+  const bool trailing_separator = full.size() > root_size && full.back() == kPreferredSeparator;
+  while (full.size() > root_size && full.back() == kPreferredSeparator) {
+    full.remove_suffix(1);
+  }
+  if (full.size() <= root_size) {
+    return path(impl_->resolve_directory(full, ec));
+  }
+  const auto last = full.rfind(kPreferredSeparator);
+  const auto directory = impl_->resolve_directory(full.substr(0, std::max(last, root_size)), ec);
+  if (ec) {
+    return path();
+  }
+  return path(impl::resolve_child(directory, full.substr(last + 1), trailing_separator, ec));
+}
+
+size_t canonical_cache::size() const
+{
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  return impl_->directories.size();
+}
+
+void canonical_cache::clear()
+{
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  impl_->directories.clear();
+}
+
+bool status_known(const file_status & s) noexcept
+{
+  return s.type() != file_type::none;
+}
+
+bool is_regular_file(const path & p) noexcept
+{
+  return p.is_regular_file();
+}
+
+bool is_regular_file(const path & p, std::error_code & ec) noexcept
+{
+  return is_regular_file(status(p, ec));
+}
+
+bool is_regular_file(const file_status & s) noexcept
+{
+  return s.type() == file_type::regular;
+}
+
+bool is_directory(const path & p) noexcept
+{
+  return p.is_directory();
+}
+
+bool is_directory(const path & p, std::error_code & ec) noexcept
+{
+  return is_directory(status(p, ec));
+}
+
+bool is_directory(const file_status & s) noexcept
+{
+  return s.type() == file_type::directory;
+}
+
+bool is_symlink(const path & p) noexcept
+{
+  int error = 0;
+  return is_symlink(query_status(p.native().c_str(), false, error));
+}
+
+bool is_symlink(const path & p, std::error_code & ec) noexcept
+{
+  return is_symlink(symlink_status(p, ec));
+}
+
+bool is_symlink(const file_status & s) noexcept
+{
+  return s.type() == file_type::symlink;
+}
+
+uint64_t file_size(const path & p)
+{
+  return p.file_size();
+}
+
+uint64_t file_size(const path & p, std::error_code & ec) noexcept
+{
+  return p.file_size(ec);
+}
+
+uint64_t file_size(const file_status & s)
+{
+  std::error_code ec;
+  const auto size = file_size(s, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot get file size"};
+  }
+  return size;
+}
+
+uint64_t file_size(const file_status & s, std::error_code & ec) noexcept
+{
+  if (is_directory(s)) {
+    ec = std::make_error_code(std::errc::is_a_directory);
+    return static_cast<uint64_t>(-1);
+  }
+  if (!exists(s)) {
+    ec = std::make_error_code(std::errc::no_such_file_or_directory);
+    return static_cast<uint64_t>(-1);
+  }
+  ec.clear();
+  return s.size();
+}
+
+bool exists(const path & path_to_check)
+{
+  return path_to_check.exists();
+}
+
+bool exists(const path & path_to_check, std::error_code & ec) noexcept
+{
+  if (access(path_to_check.native().c_str(), 0) == 0) {
+    ec.clear();
+    return true;
+  }
+  const int error = errno;
+  errno = 0;
+  if (error == ENOENT || error == ENOTDIR) {
+    ec.clear();
+  } else {
+    ec.assign(error, std::system_category());
+  }
+  return false;
+}
+
+bool exists(const file_status & s) noexcept
+{
+  return status_known(s) && s.type() != file_type::not_found;
+}
+
+path temp_directory_path()
+{
+  std::error_code ec;
+  auto temp_path = temp_directory_path(ec);
+  if (ec) {
+    throw std::system_error(ec, "cannot get temporary directory path");
+  }
+  return temp_path;
+}
+
+path temp_directory_path(std::error_code & ec)
+{
+  ec.clear();
+#ifdef _WIN32
+#ifdef UNICODE
+#error "rcpputils::fs does not support Unicode paths"
+#endif
+  TCHAR temp_path[MAX_PATH];
+  DWORD size = GetTempPathA(MAX_PATH, temp_path);
+  if (size > MAX_PATH || size == 0) {
+    ec.assign(static_cast<int>(GetLastError()), std::system_category());
+    return path();
+  }
+  temp_path[size] = '\0';
+#else
+  const char * temp_path = NULL;
+  const char * ret_str = rcutils_get_env("TMPDIR", &temp_path);
+  if (NULL != ret_str || *temp_path == '\0') {
+    temp_path = "/tmp";
+  }
+#endif
+  return path(temp_path);
+}
+
+path create_temp_directory(const std::string & base_name, const path & parent_path)
+{
+  std::error_code ec;
+  auto final_path = create_temp_directory(base_name, parent_path, ec);
+  if (ec) {
+    throw std::system_error(ec, "could not create the temp directory");
+  }
+  return final_path;
+}
+
+path create_temp_directory(
+  const std::string & base_name, const path & parent_path, std::error_code & ec)
+{
+  const auto template_path = base_name + "XXXXXX";
+  std::string full_template_str = (parent_path / template_path).string();
+  create_directories(parent_path, ec);
+  if (ec) {
+    return path();
+  }
+
+#ifdef _WIN32
+  errno_t errcode = _mktemp_s(&full_template_str[0], full_template_str.size() + 1);
+  if (errcode) {
+    ec.assign(static_cast<int>(errcode), std::system_category());
+    return path();
+  }
+  const path final_path{full_template_str};
+  create_directories(final_path, ec);
+  if (ec) {
+    return path();
+  }
+#else
+  const char * dir_name = mkdtemp(&full_template_str[0]);
+  if (dir_name == nullptr) {
+    ec.assign(errno, std::system_category());
+    errno = 0;
+    return path();
+  }
+  const path final_path{dir_name};
+#endif
+
+  return final_path;
+}
+
+namespace
+{
+
+/// \internal Write all the data to a file, retrying on short writes.
+bool write_all(int fd, const void * data, size_t size)
+{
+  const auto * bytes = static_cast<const char *>(data);
+  for (size_t written = 0; written < size; ) {
+#ifdef _WIN32
+    const auto chunk = static_cast<unsigned>(std::min<size_t>(size - written, 1u << 30));
+    const auto n = _write(fd, bytes + written, chunk);
+#else
+    const auto n = write(fd, bytes + written, size - written);
+#endif
+    if (n >= 0) {
+      written += static_cast<size_t>(n);
+    } else if (errno != EINTR) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// \internal Read a whole file into a string or a vector of bytes.
+template<typename ContainerT>
+ContainerT read_whole_file(const path & p, const read_options & options, std::error_code & ec)
+{
+  ec.clear();
+#ifdef _WIN32
+  const int fd = _open(
+    p.string().c_str(), _O_RDONLY | _O_BINARY | (options.sequential ? _O_SEQUENTIAL : 0));
+#else
+  int flags = O_RDONLY | O_CLOEXEC;
+#  ifdef O_NOATIME
+  if (options.no_atime) {
+    flags |= O_NOATIME;
+  }
+#  endif
+  int fd = open(p.native().c_str(), flags);
+#  ifdef O_NOATIME
+  // Only the owner of the file may leave its access time alone
+  if (fd < 0 && errno == EPERM && options.no_atime) {
+    fd = open(p.native().c_str(), flags & ~O_NOATIME);
+  }
+#  endif
+#endif
+  if (fd < 0) {
+    ec.assign(errno, std::system_category());
+    errno = 0;
+    return ContainerT();
+  }
+  struct stat stat_buffer;
+  const bool sized = fstat(fd, &stat_buffer) == 0 &&
+    type_from_mode(stat_buffer.st_mode) == file_type::regular;
+  const auto size = sized ? static_cast<size_t>(stat_buffer.st_size) : 0;
+
+  ContainerT content;
+#ifndef _WIN32
+  if (options.mmap_threshold != 0 && size >= options.mmap_threshold) {
+    void * mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping != MAP_FAILED) {
+      madvise(mapping, size, MADV_SEQUENTIAL);
+      const auto * begin = static_cast<const typename ContainerT::value_type *>(mapping);
+      content.assign(begin, begin + size);
+      munmap(mapping, size);
+      close(fd);
+      return content;
+    }
+    // Read the file instead
+    errno = 0;
+  }
+#  ifdef POSIX_FADV_SEQUENTIAL
+  if (options.sequential) {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  }
+#  endif
+#endif
+
+  // One byte more than the size, so that a single short read finds the end of a regular file
+  content.resize(size + 1);
+  size_t total = 0;
+  int error = 0;
+  while (true) {
+    const size_t count =
+      std::min<size_t>(content.size() - total, std::max<size_t>(options.max_read_size, 1));
+#ifdef _WIN32
+    const auto n = _read(fd, &content[total], static_cast<unsigned>(count));
+#else
+    const auto n = read(fd, &content[total], count);
+#endif
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      error = errno;
+      break;
+    }
+    total += static_cast<size_t>(n);
+    // Reads may be capped or cut short, so only a short read past the size is the end
+    if (n == 0 || (sized && static_cast<size_t>(n) < count && total >= size)) {
+      break;
+    }
+    if (total == content.size()) {
+      // The file grew, or did not report its size
+      content.resize(content.size() + std::max<size_t>(content.size(), 4096));
+    }
+  }
+#ifdef _WIN32
+  _close(fd);
+#else
+  close(fd);
+#endif
+  if (error != 0) {
+    ec.assign(error, std::system_category());
+    errno = 0;
+    return ContainerT();
+  }
+  content.resize(total);
+  return content;
+}
+
+/// \internal Write data to a new temporary file next to p, synced as requested.
+path write_temp_file(
+  const path & p, std::string_view data, durability level, std::error_code & ec)
+{
+  static std::atomic<unsigned> counter{0};
+#ifdef _WIN32
+  const auto pid = _getpid();
+#else
+  const auto pid = getpid();
+#endif
+  const auto directory = p.parent_path_view();
+  const bool needs_separator = !directory.empty() && directory.back() != kPreferredSeparator;
+  std::string prefix(directory);
+  if (needs_separator) {
+    prefix += kPreferredSeparator;
+  }
+  prefix += '.';
+  prefix += p.filename_view();
+  prefix += '.';
+  prefix += std::to_string(pid);
+  prefix += '.';
+  path temp;
+  int fd = -1;
+  // Retry with another name if a stale file is in the way
+  for (int attempt = 0; fd < 0 && attempt < 100; ++attempt) {
+    temp = path(prefix + std::to_string(counter++) + ".tmp");
+#ifdef _WIN32
+    fd = _open(
+      temp.string().c_str(), _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    fd = open(
+      temp.native().c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+      S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+#endif
+    if (fd < 0 && errno != EEXIST) {
+      break;
+    }
+  }
+  if (fd < 0) {
+    ec.assign(errno, std::system_category());
+    errno = 0;
+    return path();
+  }
+
+  bool failed = false;
+#ifndef _WIN32
+  // Replacing a file keeps its permissions and ownership, only a new one gets the default mode
+  struct stat target_stat;
+  if (stat(p.native().c_str(), &target_stat) == 0) {
+    // Only root may give the file away, otherwise it stays owned by the current user. The owner
+    // goes first, since changing it clears the set-user-ID and set-group-ID bits.
+    if (fchown(fd, target_stat.st_uid, target_stat.st_gid) != 0) {
+      errno = 0;
+    }
+    failed = fchmod(fd, target_stat.st_mode & 07777) != 0;
+  } else {
+    errno = 0;
+  }
+#endif
+  failed = failed || !write_all(fd, data.data(), data.size());
+  if (!failed && level != durability::none) {
+#if defined(_WIN32)
+    const bool synced = _commit(fd) == 0;
+#elif defined(__APPLE__)
+    const bool synced = fsync(fd) == 0;
+#else
+    const bool synced = (level == durability::data ? fdatasync(fd) : fsync(fd)) == 0;
+#endif
+    failed = !synced;
+  }
+  const int error = errno;
+#ifdef _WIN32
+  const bool closed = _close(fd) == 0;
+#else
+  const bool closed = close(fd) == 0;
+#endif
+  if (failed || !closed) {
+    ec.assign(failed ? error : errno, std::system_category());
+    errno = 0;
+    ::remove(temp.string().c_str());
+    return path();
+  }
+  return temp;
+}
+
+/// \internal Rename a temporary file over its target, removing it on failure.
+void replace_with(const path & temp, const path & target, std::error_code & ec)
+{
+#ifdef _WIN32
+  if (!MoveFileExA(
+      temp.string().c_str(), target.string().c_str(),
+      MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+  {
+    ec.assign(static_cast<int>(GetLastError()), std::system_category());
+    ::remove(temp.string().c_str());
+  }
+#else
+  if (rename(temp.native().c_str(), target.native().c_str()) != 0) {
+    ec.assign(errno, std::system_category());
+    errno = 0;
+    unlink(temp.native().c_str());
+  }
+#endif
+}
+
+/// \internal Make the entries of a directory durable, which Windows does not support.
+void sync_directory(const path & directory, std::error_code & ec)
+{
+#ifdef _WIN32
+  (void)directory;
+  (void)ec;
+#else
+  const int fd = open(directory.native().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0 || fsync(fd) != 0) {
+    ec.assign(errno, std::system_category());
+    errno = 0;
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+#endif
+}
+
+}  // namespace
+
+std::string read_file(const path & p, const read_options & options)
+{
+  std::error_code ec;
+  auto content = read_file(p, options, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot read the file"};
+  }
+  return content;
+}
+
+std::vector<std::byte> read_file_bytes(const path & p, const read_options & options)
+{
+  std::error_code ec;
+  auto content = read_file_bytes(p, options, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot read the file"};
+  }
+  return content;
+}
+
+std::string read_file(const path & p, const read_options & options, std::error_code & ec)
+{
+  return read_whole_file<std::string>(p, options, ec);
+}
+
+std::vector<std::byte> read_file_bytes(
+  const path & p, const read_options & options, std::error_code & ec)
+{
+  return read_whole_file<std::vector<std::byte>>(p, options, ec);
+}
+
+void write_file(const path & p, std::string_view data)
+{
+  std::error_code ec;
+  write_file(p, data, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot write the file"};
+  }
+}
+
+void write_file(const path & p, const std::vector<std::byte> & data)
+{
+  write_file(p, std::string_view(reinterpret_cast<const char *>(data.data()), data.size()));
+}
+
+void write_file(const path & p, std::string_view data, std::error_code & ec)
+{
+  ec.clear();
+#ifdef _WIN32
+  const int fd = _open(
+    p.string().c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+  const int fd = open(
+    p.native().c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+    S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+#endif
+  if (fd < 0) {
+    ec.assign(errno, std::system_category());
+    errno = 0;
+    return;
+  }
+  const bool written = write_all(fd, data.data(), data.size());
+  const int error = errno;
+#ifdef _WIN32
+  const bool closed = _close(fd) == 0;
+#else
+  const bool closed = close(fd) == 0;
+#endif
+  if (!written || !closed) {
+    ec.assign(written ? errno : error, std::system_category());
+    errno = 0;
+  }
+}
+
+void write_file(const path & p, const std::vector<std::byte> & data, std::error_code & ec)
+{
+  write_file(
+    p, std::string_view(reinterpret_cast<const char *>(data.data()), data.size()), ec);
+}
+
+void atomic_write(const path & p, std::string_view data, durability level)
+{
+  std::error_code ec;
+  atomic_write(p, data, level, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot write the file atomically"};
+  }
+}
+
+void atomic_write(const path & p, std::string_view data, durability level, std::error_code & ec)
+{
+  ec.clear();
+  const auto temp = write_temp_file(p, data, level, ec);
+  if (ec) {
+    return;
+  }
+  replace_with(temp, p, ec);
+  if (!ec && level == durability::full) {
+    sync_directory(p.parent_path(), ec);
+  }
+}
+
+struct atomic_write_batch::impl
+{
+  durability level;
+  std::mutex mutex;
+  // The temporary files, with the files they replace
+  std::vector<std::pair<path, path>> pending;
+};
+
+atomic_write_batch::atomic_write_batch(durability level)
+: impl_(std::make_unique<impl>())
+{
+  impl_->level = level;
+}
+
+atomic_write_batch::~atomic_write_batch()
+{
+  for (const auto & entry : impl_->pending) {
+    ::remove(entry.first.string().c_str());
+  }
+}
+
+void atomic_write_batch::add(const path & p, std::string_view data)
+{
+  std::error_code ec;
+  add(p, data, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot write the temporary file"};
+  }
+}
+
+void atomic_write_batch::add(const path & p, std::string_view data, std::error_code & ec)
+{
+  ec.clear();
+  // Write and sync outside of the lock, so that files are added concurrently
+  auto temp = write_temp_file(p, data, impl_->level, ec);
+  if (ec) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  impl_->pending.emplace_back(std::move(temp), p);
+}
+
+void atomic_write_batch::commit()
+{
+  std::error_code ec;
+  commit(ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot commit the files"};
+  }
+}
+
+void atomic_write_batch::commit(std::error_code & ec)
+{
+  ec.clear();
+  std::vector<std::pair<path, path>> pending;
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    pending.swap(impl_->pending);
+  }
+  std::vector<path> directories;
+  for (size_t i = 0; i < pending.size(); ++i) {
+    replace_with(pending[i].first, pending[i].second, ec);
+    if (ec) {
+      for (size_t j = i + 1; j < pending.size(); ++j) {
+        ::remove(pending[j].first.string().c_str());
+      }
+      break;
+    }
+    auto directory = pending[i].second.parent_path();
+    if (std::find(directories.begin(), directories.end(), directory) == directories.end()) {
+      directories.push_back(std::move(directory));
+    }
+  }
+  if (impl_->level == durability::full) {
+    // Even after a failure, the files already replaced are made durable, keeping the first error
+    for (const auto & directory : directories) {
+      std::error_code sync_ec;
+      sync_directory(directory, sync_ec);
+      if (sync_ec && !ec) {
+        ec = sync_ec;
+      }
+    }
+  }
+}
+
+path current_path()
+{
+  std::error_code ec;
+  auto cwd = current_path(ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot get current working directory"};
+  }
+  return cwd;
+}
+
+path current_path(std::error_code & ec)
+{
+  ec.clear();
+#ifdef _WIN32
+#ifdef UNICODE
+#error "rcpputils::fs does not support Unicode paths"
+#endif
+  char cwd[MAX_PATH];
+  if (nullptr == _getcwd(cwd, MAX_PATH)) {
+#else
+  char cwd[PATH_MAX];
+  if (nullptr == getcwd(cwd, PATH_MAX)) {
+#endif
+    ec.assign(errno, std::system_category());
+    errno = 0;
+    return path();
+  }
+
+  return path(cwd);
+}
+
+bool create_directories(const path & p)
+{
+  std::error_code ec;
+  create_directories(p, ec);
+  return !ec;
+}
+
+bool create_directories(const path & p, std::error_code & ec)
+{
+  ec.clear();
+  if (p.empty()) {
+    ec = std::make_error_code(std::errc::no_such_file_or_directory);
+    return false;
+  }
+  // A single copy, in which prefixes and components are null-terminated in place
+  std::string buffer = p.native();
+  const size_t root_size = is_absolute_with_drive_letter(buffer) ? 3 : p.is_absolute() ? 1 : 0;
+
+  // Walk backwards from the full path, as the deepest ancestors usually exist already
+  int error = 0;
+  size_t existing = buffer.size();
+  auto s = query_status(buffer.c_str(), true, error);
+  while (s.type() == file_type::not_found) {
+    size_t cut = existing;
+    while (cut > 0 && buffer[cut - 1] == kPreferredSeparator) {
+      --cut;
+    }
+    while (cut > 0 && buffer[cut - 1] != kPreferredSeparator) {
+      --cut;
+    }
+    existing = cut;
+    while (existing > 0 && buffer[existing - 1] == kPreferredSeparator) {
+      --existing;
+    }
+    if (existing <= root_size) {
+      // Only the root, or the current directory, is left
+      existing = root_size;
+      s = file_status(file_type::directory);
+      break;
+    }
+    const char separator = buffer[existing];
+    buffer[existing] = '\0';
+    s = query_status(buffer.c_str(), true, error);
+    buffer[existing] = separator;
+  }
+  if (s.type() != file_type::directory) {
+    ec.assign(s.type() == file_type::none ? error : ENOTDIR, std::system_category());
+    errno = 0;
+    return false;
+  }
+  if (existing == buffer.size()) {
+    return false;
+  }
+
+#ifndef _WIN32
+  // Create the missing components relative to their parent, without resolving it again
+  int dir_fd = AT_FDCWD;
+  if (existing > 0) {
+    const char separator = buffer[existing];
+    buffer[existing] = '\0';
+    dir_fd = open(buffer.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    buffer[existing] = separator;
+    if (dir_fd < 0) {
+      ec.assign(errno, std::system_category());
+      errno = 0;
+      return false;
+    }
+  }
+#endif
+  bool created = false;
+  size_t begin = existing;
+  while (!ec) {
+    while (begin < buffer.size() && buffer[begin] == kPreferredSeparator) {
+      ++begin;
+    }
+    if (begin == buffer.size()) {
+      break;
+    }
+    const size_t end = std::min(buffer.find(kPreferredSeparator, begin), buffer.size());
+    size_t next = end;
+    while (next < buffer.size() && buffer[next] == kPreferredSeparator) {
+      ++next;
+    }
+    const bool last = next == buffer.size();
+    if (end < buffer.size()) {
+      buffer[end] = '\0';
+    }
+#ifdef _WIN32
+    // Windows has no *at() functions, so create the prefix by path
+    const bool made = _mkdir(buffer.c_str()) == 0;
+    if (made) {
+      created = true;
+    } else if (errno != EEXIST) {
+      ec.assign(errno, std::system_category());
+    } else if (last && !rcpputils::fs::is_directory(query_status(buffer.c_str(), true, error))) {
+      ec.assign(ENOTDIR, std::system_category());
+    }
+#else
+    const char * name = buffer.c_str() + begin;
+    const bool made = mkdirat(dir_fd, name, S_IRWXU | S_IRWXG | S_IRWXO) == 0;
+    if (made) {
+      created = true;
+    } else if (errno != EEXIST) {
+      ec.assign(errno, std::system_category());
+    }
+    // Open the new directory for the next component, or make sure an existing one is one
+    if (!ec && (!last || !made)) {
+      const int child_fd = openat(dir_fd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+      if (child_fd < 0) {
+        ec.assign(errno, std::system_category());
+      }
+      if (dir_fd != AT_FDCWD) {
+        close(dir_fd);
+      }
+      dir_fd = child_fd < 0 ? AT_FDCWD : child_fd;
+    }
+#endif
+    if (end < buffer.size()) {
+      buffer[end] = kPreferredSeparator;
+    }
+    begin = next;
+  }
+#ifndef _WIN32
+  if (dir_fd != AT_FDCWD) {
+    close(dir_fd);
+  }
+#endif
+  errno = 0;
+  return created && !ec;
+}
+
+bool remove(const path & p)
+{
+  std::error_code ec;
+  return remove(p, ec);
+}
+
+bool remove(const path & p, std::error_code & ec) noexcept
+{
+  ec.clear();
+#ifdef _WIN32
+  struct _stat s;
+  bool removed = false;
+  if (_stat(p.string().c_str(), &s) == 0) {
+    if (s.st_mode & S_IFDIR) {
+      removed = _rmdir(p.string().c_str()) == 0;
+    } else if (s.st_mode & S_IFREG) {
+      removed = ::remove(p.string().c_str()) == 0;
+    } else {
+      ec = std::make_error_code(std::errc::not_supported);
+      return false;
+    }
+  }
+#else
+  const bool removed = ::remove(p.native().c_str()) == 0;
+#endif
+  if (!removed && errno != ENOENT) {
+    ec.assign(errno, std::system_category());
+  }
+  errno = 0;
+  return removed;
+}
+
+#ifndef _WIN32
+/// \internal Remove the content of the directory open as `fd`, taking ownership of it.
+/**
+ * Entries are removed relative to the directory with unlinkat(), using the type from the
+ * directory listing, so no path is built and no lookup starts from the root.
+ * The errno value of the first failure is stored in `error`.
+ */
+static bool remove_directory_content(int fd, remove_all_stats * stats, int & error)
+{
+  DIR * dir = fdopendir(fd);
+  if (dir == nullptr) {
+    error = errno;
+    close(fd);
+    return false;
+  }
+  errno = 0;
+  const struct dirent * entry;
+  while (error == 0 && (entry = readdir(dir)) != nullptr) {
+    // Make sure to not call ".." or "." entries in directory (might delete everything)
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+      continue;
+    }
+    bool is_dir = false;
+    bool type_known = false;
+#  ifdef DT_UNKNOWN
+    type_known = entry->d_type != DT_UNKNOWN;
+    is_dir = entry->d_type == DT_DIR;
+#  endif
+    struct stat stat_buffer;
+    if (!type_known || (stats != nullptr && !is_dir)) {
+      if (fstatat(dirfd(dir), entry->d_name, &stat_buffer, AT_SYMLINK_NOFOLLOW) != 0) {
+        error = errno;
+        break;
+      }
+      is_dir = S_ISDIR(stat_buffer.st_mode);
+    }
+
+    if (is_dir) {
+      const int child_fd = openat(
+        dirfd(dir), entry->d_name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+      if (child_fd < 0) {
+        error = errno;
+      } else if (remove_directory_content(child_fd, stats, error) &&
+        unlinkat(dirfd(dir), entry->d_name, AT_REMOVEDIR) != 0)
+      {
+        error = errno;
+      }
+    } else if (unlinkat(dirfd(dir), entry->d_name, 0) != 0) {
+      error = errno;
+    } else if (stats != nullptr && S_ISREG(stat_buffer.st_mode)) {
+      stats->bytes += static_cast<uint64_t>(stat_buffer.st_size);
+    }
+    if (error == 0 && stats != nullptr) {
+      ++stats->entries;
+    }
+    errno = 0;
+  }
+  if (error == 0 && errno != 0) {
+    // readdir failed
+    error = errno;
+  }
+  closedir(dir);
+  errno = 0;
+  return error == 0;
+}
+#endif
+
+/// \internal Shared implementation of the remove_all() overloads, `stats` may be null.
+static bool remove_all_impl(const path & p, remove_all_stats * stats, std::error_code & ec)
+{
+  int error = 0;
+  const auto s = query_status(p.native().c_str(), false, error);
+  if (!is_directory(s)) {
+    // Symlinks to directories are removed themselves, not followed
+    const bool success = rcpputils::fs::remove(p, ec);
+    if (success && stats != nullptr) {
+      ++stats->entries;
+      stats->bytes += is_regular_file(s) ? s.size() : 0;
+    }
+    return success;
+  }
+
+#ifdef _WIN32
+  if (stats != nullptr) {
+    // The shell operation below reports nothing, so tally the tree before removing it
+    remove_all_stats tree_stats;
+    tree_stats.entries = 1;
+    for (const auto & entry : recursive_directory_iterator(p)) {
+      ++tree_stats.entries;
+      tree_stats.bytes += entry.is_regular_file() ? entry.status().size() : 0;
+    }
+    stats->entries += tree_stats.entries;
+    stats->bytes += tree_stats.bytes;
+  }
+
+  // We need a string of type PCZZTSTR, which is a double null terminated char ptr
+  size_t length = p.string().size();
+  TCHAR * temp_dir = new TCHAR[length + 2];
+  memcpy(temp_dir, p.string().c_str(), length);
+  temp_dir[length] = '\0';
+  temp_dir[length + 1] = '\0';  // double null terminated
+
+  SHFILEOPSTRUCT file_options;
+  file_options.hwnd = nullptr;
+  file_options.wFunc = FO_DELETE;  // delete (recursively)
+  file_options.pFrom = temp_dir;
+  file_options.pTo = nullptr;
+  file_options.fFlags = FOF_NOCONFIRMATION | FOF_SILENT;  // do not prompt user
+  file_options.fAnyOperationsAborted = FALSE;
+  file_options.lpszProgressTitle = nullptr;
+  file_options.hNameMappings = nullptr;
+
+  auto ret = SHFileOperation(&file_options);
+  delete[] temp_dir;
+
+  if (0 != ret || false != file_options.fAnyOperationsAborted) {
+    ec = std::make_error_code(std::errc::io_error);
+    return false;
+  }
+  ec.clear();
+  return true;
+#else
+  error = 0;
+  const int fd = open(p.native().c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+  if (fd < 0) {
+    error = errno;
+  } else if (remove_directory_content(fd, stats, error) && rmdir(p.native().c_str()) != 0) {
+    // The directory is empty now, yet could not be removed
+    error = errno;
+  }
+  if (error != 0) {
+    ec.assign(error, std::system_category());
+    errno = 0;
+    return false;
+  }
+  ec.clear();
+  if (stats != nullptr) {
+    ++stats->entries;
+  }
+  return true;
+#endif
+}
+
+bool remove_all(const path & p)
+{
+  std::error_code ec;
+  return remove_all_impl(p, nullptr, ec);
+}
+
+bool remove_all(const path & p, remove_all_stats & stats)
+{
+  std::error_code ec;
+  return remove_all_impl(p, &stats, ec);
+}
+
+bool remove_all(const path & p, std::error_code & ec)
+{
+  return remove_all_impl(p, nullptr, ec);
+}
+
+bool remove_all(const path & p, remove_all_stats & stats, std::error_code & ec)
+{
+  return remove_all_impl(p, &stats, ec);
+}
+
+path remove_extension(const path & file_path, int n_times)
+{
+  std::string_view remaining(file_path.native());
+  for (int i = 0; i < n_times; i++) {
+    const auto extension = extension_of(filename_of(remaining));
+    if (extension.empty()) {
+      break;
+    }
+    remaining = remaining.substr(0, static_cast<size_t>(extension.data() - remaining.data()));
+  }
+  return path(remaining);
+}
+
+namespace
+{
+
+/// \internal Reads the entries of a single directory, skipping "." and "..".
+class directory_stream final
+{
+public:
+  directory_stream(const path & p, std::error_code & ec)
+  : directory_(p)
+  {
+#ifdef _WIN32
+    handle_ = FindFirstFileA((p.string() + "\\*").c_str(), &find_data_);
+    if (handle_ == INVALID_HANDLE_VALUE) {
+      ec.assign(static_cast<int>(GetLastError()), std::system_category());
+    }
+#else
+    dir_ = opendir(p.native().c_str());
+    if (dir_ == nullptr) {
+      ec.assign(errno, std::system_category());
+      errno = 0;
+    }
+#endif
+  }
+
+#ifndef _WIN32
+  /// Read the directory opened as `fd`, taking ownership of the descriptor.
+  directory_stream(const path & p, int fd, std::error_code & ec)
+  : directory_(p)
+  {
+    dir_ = fdopendir(fd);
+    if (dir_ == nullptr) {
+      ec.assign(errno, std::system_category());
+      errno = 0;
+      close(fd);
+    }
+  }
+
+  /// The descriptor of the directory, for use with the *at() syscalls.
+  int fd() const {return dirfd(dir_);}
+#endif
+
+  ~directory_stream()
+  {
+#ifdef _WIN32
+    if (handle_ != INVALID_HANDLE_VALUE) {
+      FindClose(handle_);
+    }
+#else
+    if (dir_ != nullptr) {
+      closedir(dir_);
+    }
+#endif
+  }
+
+  directory_stream(const directory_stream &) = delete;
+  directory_stream & operator=(const directory_stream &) = delete;
+
+  /// Read the next entry, returning false at the end of the directory or on error.
+  /**
+   * The type is file_type::none when the listing does not report it.
+   * The name is valid until the next call.
+   */
+  bool next(std::string_view & name, file_type & type, std::error_code & ec)
+  {
+    while (true) {
+#ifdef _WIN32
+      if (!first_ && !FindNextFileA(handle_, &find_data_)) {
+        const auto error = GetLastError();
+        if (error != ERROR_NO_MORE_FILES) {
+          ec.assign(static_cast<int>(error), std::system_category());
+        }
+        return false;
+      }
+      first_ = false;
+      const char * entry_name = find_data_.cFileName;
+      if (find_data_.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) {
+        type = file_type::symlink;
+      } else if (find_data_.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+        type = file_type::directory;
+      } else {
+        type = file_type::regular;
+      }
+#else
+      errno = 0;
+      const struct dirent * entry = readdir(dir_);
+      if (entry == nullptr) {
+        if (errno != 0) {
+          ec.assign(errno, std::system_category());
+          errno = 0;
+        }
+        return false;
+      }
+      const char * entry_name = entry->d_name;
+      type = file_type::none;
+#  ifdef DT_UNKNOWN
+      switch (entry->d_type) {
+        case DT_REG: type = file_type::regular; break;
+        case DT_DIR: type = file_type::directory; break;
+        case DT_LNK: type = file_type::symlink; break;
+        case DT_BLK: type = file_type::block; break;
+        case DT_CHR: type = file_type::character; break;
+        case DT_FIFO: type = file_type::fifo; break;
+        case DT_SOCK: type = file_type::socket; break;
+        default: break;
+      }
+#  endif
+#endif
+      // Make sure to not return ".." or "." entries, iterating them would never end
+      if (strcmp(entry_name, ".") != 0 && strcmp(entry_name, "..") != 0) {
+        name = entry_name;
+        return true;
+      }
+    }
+  }
+
+  /// The directory being read.
+  const path & directory() const {return directory_;}
+
+private:
+  path directory_;
+#ifdef _WIN32
+  HANDLE handle_ = INVALID_HANDLE_VALUE;
+  WIN32_FIND_DATAA find_data_;
+  bool first_ = true;
+#else
+  DIR * dir_ = nullptr;
+#endif
+};
+
+/// \internal Build the path of an entry of a directory with a single allocation.
+path entry_path(const path & directory, std::string_view name)
+{
+  std::string p;
+  p.reserve(directory.native().size() + 1 + name.size());
+  p = directory.native();
+  if (!p.empty() && p.back() != kPreferredSeparator) {
+    p += kPreferredSeparator;
+  }
+  p.append(name.data(), name.size());
+  return path(std::move(p), deferred_parse);
+}
+
+/// \internal Complete the type of an entry when the directory listing did not report it.
+file_type entry_type(const path & entry, file_type listed_type)
+{
+  if (listed_type != file_type::none) {
+    return listed_type;
+  }
+  int error = 0;
+  return query_status(entry.native().c_str(), false, error).type();
+}
+
+bool skips_permission_denied(directory_options options, const std::error_code & ec)
+{
+  return ec == std::errc::permission_denied &&
+         (options & directory_options::skip_permission_denied) != directory_options::none;
+}
+
+/// \internal Owns a file descriptor, closing it on destruction.
+class unique_fd final
+{
+public:
+  unique_fd() = default;
+
+  explicit unique_fd(int fd)
+  : fd_(fd)
+  {
+  }
+
+  unique_fd(unique_fd && other) noexcept
+  : fd_(other.release())
+  {
+  }
+
+  unique_fd & operator=(unique_fd && other) noexcept
+  {
+    reset(other.release());
+    return *this;
+  }
+
+  ~unique_fd()
+  {
+    reset();
+  }
+
+  int get() const {return fd_;}
+
+  int release()
+  {
+    const int fd = fd_;
+    fd_ = -1;
+    return fd;
+  }
+
+  void reset(int fd = -1)
+  {
+#ifndef _WIN32
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+#endif
+    fd_ = fd;
+  }
+
+private:
+  int fd_ = -1;
+};
+
+/// \internal Processes items on a pool of threads until none is left, handlers may push more.
+template<typename ItemT>
+class work_queue final
+{
+public:
+  void push(ItemT item)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    items_.push_back(std::move(item));
+    ++pending_;
+    condition_.notify_one();
+  }
+
+  /// Stop handing out items, recording the first error to rethrow from run().
+  void cancel(std::exception_ptr error = nullptr)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (error && !error_) {
+      error_ = error;
+    }
+    cancelled_ = true;
+    condition_.notify_all();
+  }
+
+  bool cancelled() const {return cancelled_;}
+
+  /// Handle all items, on the calling thread and num_threads - 1 additional ones.
+  template<typename HandlerT>
+  void run(size_t num_threads, HandlerT handler)
+  {
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (size_t i = 1; i < num_threads; ++i) {
+      threads.emplace_back([this, &handler]() {work(handler);});
+    }
+    work(handler);
+    for (auto & thread : threads) {
+      thread.join();
+    }
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+private:
+  template<typename HandlerT>
+  void work(HandlerT & handler)
+  {
+    while (true) {
+      ItemT item;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(
+          lock, [this]() {return cancelled_ || pending_ == 0 || !items_.empty();});
+        if (cancelled_ || items_.empty()) {
+          return;
+        }
+        // Depth first keeps the queue, and the resources its items hold, small
+        item = std::move(items_.back());
+        items_.pop_back();
+      }
+      try {
+        handler(item);
+      } catch (...) {
+        cancel(std::current_exception());
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--pending_ == 0) {
+        condition_.notify_all();
+      }
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::vector<ItemT> items_;
+  // Items queued or being handled
+  size_t pending_ = 0;
+  std::atomic<bool> cancelled_{false};
+  std::exception_ptr error_;
+};
+
+size_t resolve_num_threads(size_t num_threads)
+{
+  return num_threads != 0 ? num_threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+/// \internal Opens subdirectories relative to their parent for the parallel helpers.
+class subdirectory_opener final
+{
+public:
+  /// Open a subdirectory, or return an invalid descriptor to open it by path later.
+  unique_fd open(const directory_stream & parent, std::string_view name, bool follow)
+  {
+#ifndef _WIN32
+    if (open_descriptors_ < kMaxOpenDescriptors) {
+      const int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC | (follow ? 0 : O_NOFOLLOW);
+      // The name is null-terminated, as it comes from the directory entry
+      const int fd = openat(parent.fd(), name.data(), flags);
+      if (fd >= 0) {
+        ++open_descriptors_;
+        return unique_fd(fd);
+      }
+      // Let opening by path report the error, if it persists
+      errno = 0;
+    }
+#else
+    (void)parent;
+    (void)name;
+    (void)follow;
+#endif
+    return unique_fd();
+  }
+
+  /// Read a directory from the descriptor returned by open(), or by path.
+  std::unique_ptr<directory_stream> read(
+    const path & directory, unique_fd fd, std::error_code & ec)
+  {
+#ifndef _WIN32
+    if (fd.get() >= 0) {
+      --open_descriptors_;
+      return std::make_unique<directory_stream>(directory, fd.release(), ec);
+    }
+#endif
+    return std::make_unique<directory_stream>(directory, ec);
+  }
+
+private:
+  // Limit the descriptors held by queued directories, beyond which they are opened by path
+  static constexpr size_t kMaxOpenDescriptors = 256;
+
+  std::atomic<size_t> open_descriptors_{0};
+};
+
+/// \internal Complete the type of an entry read from a stream without stat'ing it by path.
+file_type complete_entry_type(
+  const directory_stream & stream, std::string_view name, file_type listed_type)
+{
+#ifndef _WIN32
+  struct stat stat_buffer;
+  if (listed_type == file_type::none &&
+    fstatat(stream.fd(), name.data(), &stat_buffer, AT_SYMLINK_NOFOLLOW) == 0)
+  {
+    return type_from_mode(stat_buffer.st_mode);
+  }
+#else
+  (void)stream;
+  (void)name;
+#endif
+  return listed_type;
+}
+
+/// \internal A directory waiting to be read by parallel_walk().
+struct walk_item
+{
+  path directory;
+  unique_fd fd;
+};
+
+/// \internal Reads directories for parallel_walk(), pushing the subdirectories to visit.
+class parallel_walker final
+{
+public:
+  parallel_walker(const walk_visitor & visitor, directory_options options)
+  : visitor_(visitor), options_(options)
+  {
+  }
+
+  /// Walk the tree, storing the first directory that cannot be read in `ec`.
+  bool run(const path & root, size_t num_threads, std::error_code & ec)
+  {
+    queue_.push({root, unique_fd()});
+    queue_.run(num_threads, [this](walk_item & item) {read(item);});
+    ec = error_;
+    return !queue_.cancelled();
+  }
+
+private:
+  /// Cancel the walk, keeping the first error for run() to report without unwinding.
+  void fail(const std::error_code & ec)
+  {
+    {
+      std::lock_guard<std::mutex> lock(error_mutex_);
+      if (!error_) {
+        error_ = ec;
+      }
+    }
+    queue_.cancel();
+  }
+
+  void read(walk_item & item)
+  {
+    std::error_code ec;
+    const auto stream = opener_.read(item.directory, std::move(item.fd), ec);
+    if (ec) {
+      if (!skips_permission_denied(options_, ec)) {
+        fail(ec);
+      }
+      return;
+    }
+    const bool follow =
+      (options_ & directory_options::follow_directory_symlink) != directory_options::none;
+    std::string_view name;
+    file_type type = file_type::none;
+    while (!queue_.cancelled() && stream->next(name, type, ec)) {
+      type = complete_entry_type(*stream, name, type);
+      const directory_entry entry(entry_path(stream->directory(), name), type);
+      const auto action = visitor_(entry);
+      if (action == walk_action::stop) {
+        queue_.cancel();
+        return;
+      }
+      if (action == walk_action::skip_subtree) {
+        continue;
+      }
+      if (type == file_type::directory || (follow && entry.is_directory())) {
+        queue_.push({entry.path(), opener_.open(*stream, name, follow)});
+      }
+    }
+    if (ec) {
+      fail(ec);
+    }
+  }
+
+  const walk_visitor & visitor_;
+  const directory_options options_;
+  work_queue<walk_item> queue_;
+  subdirectory_opener opener_;
+  std::mutex error_mutex_;
+  std::error_code error_;
+};
+
+/// \internal A directory being emptied by the parallel remove_all().
+struct removal_node
+{
+  removal_node(path d, std::shared_ptr<removal_node> p)
+  : directory(std::move(d)), parent(std::move(p))
+  {
+  }
+
+  path directory;
+  std::shared_ptr<removal_node> parent;
+  // Reading this directory, plus its subdirectories that are not removed yet
+  std::atomic<size_t> pending{1};
+  // Something inside could not be removed, so this directory cannot be either
+  std::atomic<bool> failed{false};
+};
+
+/// \internal A directory waiting to be emptied by the parallel remove_all().
+struct removal_item
+{
+  std::shared_ptr<removal_node> node;
+  unique_fd fd;
+};
+
+/// \internal Empties directories on several threads, removing each once its content is gone.
+class parallel_remover final
+{
+public:
+  remove_all_report run(const path & root, size_t num_threads)
+  {
+    queue_.push({std::make_shared<removal_node>(root, nullptr), unique_fd()});
+    queue_.run(num_threads, [this](removal_item & item) {empty(item);});
+    report_.entries = entries_;
+    return std::move(report_);
+  }
+
+private:
+  void empty(removal_item & item)
+  {
+    const auto & node = item.node;
+    std::error_code ec;
+    const auto stream = opener_.read(node->directory, std::move(item.fd), ec);
+    if (ec) {
+      // A directory that is already gone, removed concurrently, is not a failure
+      if (ec != std::errc::no_such_file_or_directory) {
+        fail(node->directory, ec);
+        node->failed = true;
+      }
+      finish(node);
+      return;
+    }
+    std::string_view name;
+    file_type type = file_type::none;
+    while (stream->next(name, type, ec)) {
+      type = complete_entry_type(*stream, name, type);
+      if (type == file_type::directory) {
+        ++node->pending;
+        queue_.push(
+          {std::make_shared<removal_node>(entry_path(stream->directory(), name), node),
+            opener_.open(*stream, name, false)});
+        continue;
+      }
+      std::error_code entry_ec;
+#ifdef _WIN32
+      const bool removed = rcpputils::fs::remove(entry_path(stream->directory(), name), entry_ec);
+#else
+      const bool removed = unlinkat(stream->fd(), name.data(), 0) == 0;
+      if (!removed && errno != ENOENT) {
+        entry_ec.assign(errno, std::system_category());
+      }
+      errno = 0;
+#endif
+      if (removed) {
+        ++entries_;
+      } else if (entry_ec) {
+        fail(entry_path(stream->directory(), name), entry_ec);
+        node->failed = true;
+      }
+    }
+    if (ec) {
+      fail(node->directory, ec);
+      node->failed = true;
+    }
+    finish(node);
+  }
+
+  /// Release one hold on a directory, removing it and moving up once nothing is left inside.
+  void finish(std::shared_ptr<removal_node> node)
+  {
+    while (node && --node->pending == 0) {
+      std::error_code remove_ec;
+      if (node->failed) {
+        // The error inside has been reported already
+      } else if (rcpputils::fs::remove(node->directory, remove_ec)) {
+        ++entries_;
+      } else if (remove_ec) {
+        fail(node->directory, remove_ec);
+        node->failed = true;
+      }
+      if (node->failed && node->parent) {
+        node->parent->failed = true;
+      }
+      node = node->parent;
+    }
+  }
+
+  void fail(const path & p, std::error_code ec)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    report_.errors.push_back({p, ec});
+  }
+
+  work_queue<removal_item> queue_;
+  subdirectory_opener opener_;
+  std::atomic<uint64_t> entries_{0};
+  std::mutex mutex_;
+  remove_all_report report_;
+};
+
+}  // namespace
+
+directory_entry::directory_entry(const rcpputils::fs::path & p)
+: path_(p), type_(entry_type(p, file_type::none))
+{
+}
+
+bool directory_entry::is_directory() const noexcept
+{
+  return type_ == file_type::symlink ? path_.is_directory() : type_ == file_type::directory;
+}
+
+bool directory_entry::is_regular_file() const noexcept
+{
+  return type_ == file_type::symlink ? path_.is_regular_file() : type_ == file_type::regular;
+}
+
+file_status directory_entry::status() const
+{
+  return rcpputils::fs::status(path_);
+}
+
+file_status directory_entry::status(std::error_code & ec) const noexcept
+{
+  return rcpputils::fs::status(path_, ec);
+}
+
+file_status directory_entry::symlink_status() const
+{
+  return rcpputils::fs::symlink_status(path_);
+}
+
+file_status directory_entry::symlink_status(std::error_code & ec) const noexcept
+{
+  return rcpputils::fs::symlink_status(path_, ec);
+}
+
+struct directory_iterator::impl
+{
+  impl(const path & p, std::error_code & ec)
+  : stream(p, ec)
+  {
+  }
+
+  directory_stream stream;
+  directory_entry entry;
+};
+
+directory_iterator::directory_iterator(const path & p, directory_options options)
+{
+  std::error_code ec;
+  auto state = std::make_shared<impl>(p, ec);
+  if (ec) {
+    if (skips_permission_denied(options, ec)) {
+      return;
+    }
+    throw std::system_error{ec, "cannot open directory"};
+  }
+  impl_ = std::move(state);
+  ++*this;
+}
+
+directory_iterator::directory_iterator(
+  const path & p, directory_options options, std::error_code & ec)
+{
+  ec.clear();
+  auto state = std::make_shared<impl>(p, ec);
+  if (ec) {
+    if (skips_permission_denied(options, ec)) {
+      ec.clear();
+    }
+    return;
+  }
+  impl_ = std::move(state);
+  increment(ec);
+}
+
+const directory_entry & directory_iterator::operator*() const
+{
+  return impl_->entry;
+}
+
+const directory_entry * directory_iterator::operator->() const
+{
+  return &impl_->entry;
+}
+
+directory_iterator & directory_iterator::operator++()
+{
+  std::error_code ec;
+  increment(ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot read directory"};
+  }
+  return *this;
+}
+
+directory_iterator & directory_iterator::increment(std::error_code & ec)
+{
+  std::string_view name;
+  file_type type = file_type::none;
+  ec.clear();
+  if (!impl_->stream.next(name, type, ec)) {
+    impl_.reset();
+    return *this;
+  }
+  impl_->entry.path_ = entry_path(impl_->stream.directory(), name);
+  impl_->entry.type_ = entry_type(impl_->entry.path_, type);
+  return *this;
+}
+
+struct recursive_directory_iterator::impl
+{
+  directory_options options = directory_options::none;
+  std::vector<std::unique_ptr<directory_stream>> stack;
+  directory_entry entry;
+  bool recursion_pending = false;
+};
+
+recursive_directory_iterator::recursive_directory_iterator(
+  const path & p, directory_options options)
+{
+  std::error_code ec;
+  auto stream = std::make_unique<directory_stream>(p, ec);
+  if (ec) {
+    if (skips_permission_denied(options, ec)) {
+      return;
+    }
+    throw std::system_error{ec, "cannot open directory"};
+  }
+  impl_ = std::make_shared<impl>();
+  impl_->options = options;
+  impl_->stack.push_back(std::move(stream));
+  advance(ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot read directory"};
+  }
+}
+
+recursive_directory_iterator::recursive_directory_iterator(
+  const path & p, directory_options options, std::error_code & ec)
+{
+  ec.clear();
+  auto stream = std::make_unique<directory_stream>(p, ec);
+  if (ec) {
+    if (skips_permission_denied(options, ec)) {
+      ec.clear();
+    }
+    return;
+  }
+  impl_ = std::make_shared<impl>();
+  impl_->options = options;
+  impl_->stack.push_back(std::move(stream));
+  advance(ec);
+}
+
+const directory_entry & recursive_directory_iterator::operator*() const
+{
+  return impl_->entry;
+}
+
+const directory_entry * recursive_directory_iterator::operator->() const
+{
+  return &impl_->entry;
+}
+
+recursive_directory_iterator & recursive_directory_iterator::operator++()
+{
+  std::error_code ec;
+  increment(ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot read directory"};
+  }
+  return *this;
+}
+
+recursive_directory_iterator & recursive_directory_iterator::increment(std::error_code & ec)
+{
+  ec.clear();
+  const auto & entry = impl_->entry;
+  const bool follow =
+    (impl_->options & directory_options::follow_directory_symlink) != directory_options::none;
+  // The type from the listing tells directories apart, only symlinks need a stat to be followed
+  if (impl_->recursion_pending &&
+    (entry.type_ == file_type::directory || (follow && entry.is_directory())))
+  {
+    auto stream = std::make_unique<directory_stream>(entry.path_, ec);
+    if (!ec) {
+      impl_->stack.push_back(std::move(stream));
+    } else if (skips_permission_denied(impl_->options, ec)) {
+      ec.clear();
+    } else {
+      impl_.reset();
+      return *this;
+    }
+  }
+  advance(ec);
+  return *this;
+}
+
+void recursive_directory_iterator::advance(std::error_code & ec)
+{
+  std::string_view name;
+  file_type type = file_type::none;
+  while (!impl_->stack.empty()) {
+    auto & stream = *impl_->stack.back();
+    if (stream.next(name, type, ec)) {
+      impl_->entry.path_ = entry_path(stream.directory(), name);
+      impl_->entry.type_ = entry_type(impl_->entry.path_, type);
+      impl_->recursion_pending = true;
+      return;
+    }
+    if (ec) {
+      impl_.reset();
+      return;
+    }
+    impl_->stack.pop_back();
+  }
+  impl_.reset();
+}
+
+directory_options recursive_directory_iterator::options() const
+{
+  return impl_->options;
+}
+
+int recursive_directory_iterator::depth() const
+{
+  return static_cast<int>(impl_->stack.size()) - 1;
+}
+
+bool recursive_directory_iterator::recursion_pending() const
+{
+  return impl_->recursion_pending;
+}
+
+void recursive_directory_iterator::disable_recursion_pending()
+{
+  impl_->recursion_pending = false;
+}
+
+void recursive_directory_iterator::pop()
+{
+  std::error_code ec;
+  pop(ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot read directory"};
+  }
+}
+
+void recursive_directory_iterator::pop(std::error_code & ec)
+{
+  ec.clear();
+  impl_->stack.pop_back();
+  advance(ec);
+}
+
+bool parallel_walk(
+  const path & root, const walk_visitor & visitor, size_t num_threads,
+  directory_options options)
+{
+  std::error_code ec;
+  const bool completed = parallel_walk(root, visitor, num_threads, options, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot read directory"};
+  }
+  return completed;
+}
+
+bool parallel_walk(
+  const path & root, const walk_visitor & visitor, size_t num_threads,
+  directory_options options, std::error_code & ec)
+{
+  parallel_walker walker(visitor, options);
+  return walker.run(root, resolve_num_threads(num_threads), ec);
+}
+
+remove_all_report remove_all(const path & p, const parallel_options & options)
+{
+  int error = 0;
+  const auto s = query_status(p.native().c_str(), false, error);
+  if (!is_directory(s)) {
+    remove_all_report report;
+    std::error_code ec;
+    if (rcpputils::fs::remove(p, ec)) {
+      report.entries = 1;
+    } else if (ec) {
+      report.errors.push_back({p, ec});
+    } else {
+      // Missing, which remove() does not count as a failure
+      report.errors.push_back({p, {error != 0 ? error : ENOENT, std::system_category()}});
+    }
+    return report;
+  }
+  parallel_remover remover;
+  return remover.run(p, resolve_num_threads(options.num_threads));
+}
+
+namespace
+{
+
+#ifdef RCPPUTILS_HAS_IO_URING
+/// \internal A minimal io_uring instance, submitting statx() operations.
+class statx_ring final
+{
+public:
+  explicit statx_ring(unsigned entries)
+  {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (fd_ < 0) {
+      errno = 0;
+      return;
+    }
+    entries_ = params.sq_entries;
+    sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    // Both rings share one mapping on the kernels that can run statx() operations anyway
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) == 0) {
+      return;
+    }
+    sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+    rings_ = mmap(
+      nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+      IORING_OFF_SQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void * sqes = mmap(
+      nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+      IORING_OFF_SQES);
+    if (rings_ == MAP_FAILED || sqes == MAP_FAILED) {
+      errno = 0;
+      if (sqes != MAP_FAILED) {
+        munmap(sqes, sqes_size_);
+      }
+      return;
+    }
+    sqes_ = static_cast<io_uring_sqe *>(sqes);
+    auto * rings = static_cast<char *>(rings_);
+    sq_tail_ = reinterpret_cast<unsigned *>(rings + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned *>(rings + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(rings + params.sq_off.array);
+    cq_head_ = reinterpret_cast<unsigned *>(rings + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(rings + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned *>(rings + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(rings + params.cq_off.cqes);
+  }
+
+  ~statx_ring()
+  {
+    if (sqes_ != nullptr) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (rings_ != nullptr && rings_ != MAP_FAILED) {
+      munmap(rings_, sq_size_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  statx_ring(const statx_ring &) = delete;
+  statx_ring & operator=(const statx_ring &) = delete;
+
+  bool valid() const {return sqes_ != nullptr;}
+
+  /// Query all the paths, returning false if the kernel cannot run statx() operations.
+  bool run(const std::vector<path> & paths, std::vector<file_status> & results)
+  {
+    std::vector<struct statx> buffers(paths.size());
+    size_t submitted = 0;
+    size_t completed = 0;
+    // Queued operations that the kernel did not consume yet
+    unsigned to_submit = 0;
+    while (completed < paths.size()) {
+      // The completion queue is twice as large, so it cannot overflow
+      unsigned tail = *sq_tail_;
+      while (submitted < paths.size() && submitted - completed < entries_) {
+        io_uring_sqe & sqe = sqes_[tail & sq_mask_];
+        memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_STATX;
+        sqe.fd = AT_FDCWD;
+        sqe.addr = reinterpret_cast<uintptr_t>(paths[submitted].native().c_str());
+        sqe.len = STATX_BASIC_STATS;
+        sqe.off = reinterpret_cast<uintptr_t>(&buffers[submitted]);
+        sqe.user_data = submitted;
+        sq_array_[tail & sq_mask_] = tail & sq_mask_;
+        ++tail;
+        ++submitted;
+        ++to_submit;
+      }
+      __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+      const long rc = syscall(
+        __NR_io_uring_enter, fd_, to_submit, 1u, IORING_ENTER_GETEVENTS, nullptr, 0);
+      if (rc >= 0) {
+        to_submit -= static_cast<unsigned>(rc);
+      } else if (errno != EINTR) {
+        errno = 0;
+        drain(submitted - completed - to_submit);
+        return false;
+      }
+      unsigned head = *cq_head_;
+      const unsigned cq_tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+      for (; head != cq_tail; ++head) {
+        const io_uring_cqe & cqe = cqes_[head & cq_mask_];
+        if (cqe.res == -EINVAL) {
+          // Kernels before 5.6 do not know the operation
+          __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+          drain(submitted - completed - to_submit - 1);
+          return false;
+        }
+        const auto index = static_cast<size_t>(cqe.user_data);
+        if (cqe.res == 0) {
+          results[index] = to_status(buffers[index]);
+        } else if (cqe.res == -ENOENT || cqe.res == -ENOTDIR) {
+          results[index] = file_status(file_type::not_found);
+        }
+        ++completed;
+      }
+      __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+    errno = 0;
+    return true;
+  }
+
+private:
+  /// Wait for operations still in flight, which refer to buffers about to be released.
+  void drain(size_t in_flight)
+  {
+    while (in_flight > 0) {
+      if (syscall(__NR_io_uring_enter, fd_, 0u, 1u, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+        errno != EINTR)
+      {
+        break;
+      }
+      unsigned head = *cq_head_;
+      const unsigned cq_tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+      in_flight -= std::min<size_t>(in_flight, cq_tail - head);
+      __atomic_store_n(cq_head_, cq_tail, __ATOMIC_RELEASE);
+    }
+    errno = 0;
+  }
+
+  static file_status to_status(const struct statx & buffer)
+  {
+    return file_status(
+      type_from_mode(buffer.stx_mode),
+      static_cast<perms>(buffer.stx_mode & static_cast<unsigned>(perms::mask)),
+      buffer.stx_size,
+      file_time_type(
+        std::chrono::seconds(buffer.stx_mtime.tv_sec) +
+        std::chrono::nanoseconds(buffer.stx_mtime.tv_nsec)),
+      buffer.stx_ino,
+      makedev(buffer.stx_dev_major, buffer.stx_dev_minor));
+  }
+
+  int fd_ = -1;
+  unsigned entries_ = 0;
+  void * rings_ = nullptr;
+  size_t sq_size_ = 0;
+  size_t cq_size_ = 0;
+  io_uring_sqe * sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+  unsigned * sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned * sq_array_ = nullptr;
+  unsigned * cq_head_ = nullptr;
+  unsigned * cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  io_uring_cqe * cqes_ = nullptr;
+};
+#endif
+
+}  // namespace
+
+std::vector<file_status> status_many(
+  const std::vector<path> & paths, const parallel_options & options)
+{
+  std::vector<file_status> results(paths.size());
+  // Below this, setting up a ring or threads costs more than it saves
+  constexpr size_t kMinBatchSize = 8;
+  int error = 0;
+  if (paths.size() < kMinBatchSize) {
+    for (size_t i = 0; i < paths.size(); ++i) {
+      results[i] = query_status(paths[i].native().c_str(), true, error);
+    }
+    return results;
+  }
+
+#ifdef RCPPUTILS_HAS_IO_URING
+  statx_ring ring(static_cast<unsigned>(std::min<size_t>(paths.size(), 256)));
+  if (ring.valid() && ring.run(paths, results)) {
+    return results;
+  }
+#endif
+
+  // Each thread claims the next path, there is no point in a queue for a flat list
+  std::atomic<size_t> next{0};
+  auto query = [&paths, &results, &next]() {
+      int error = 0;
+      for (size_t i = next++; i < paths.size(); i = next++) {
+        results[i] = query_status(paths[i].native().c_str(), true, error);
+      }
+    };
+  const size_t num_threads =
+    std::min(resolve_num_threads(options.num_threads), paths.size());
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(query);
+  }
+  query();
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  return results;
+}
+
+#ifndef _WIN32
+namespace
+{
+
+/// \internal Report the errno value of a failure in ec, returning false for convenience.
+bool fail_errno(std::error_code & ec)
+{
+  ec.assign(errno, std::system_category());
+  errno = 0;
+  return false;
+}
+
+/// \internal Copy the data past offset with the kernel, returning false to fall back.
+bool copy_in_kernel(
+  int in, int out, uint64_t size, uint64_t & offset, copy_strategy strategy)
+{
+  while (offset < size) {
+    const size_t count = static_cast<size_t>(std::min<uint64_t>(size - offset, 1ull << 30));
+    ssize_t copied = -1;
+#if defined(__linux__) && defined(SYS_copy_file_range)
+    if (strategy == copy_strategy::copy_file_range) {
+      loff_t in_offset = static_cast<loff_t>(offset);
+      loff_t out_offset = static_cast<loff_t>(offset);
+      copied = syscall(SYS_copy_file_range, in, &in_offset, out, &out_offset, count, 0u);
+    }
+#endif
+#ifdef __linux__
+    if (strategy == copy_strategy::sendfile) {
+      // sendfile() writes at the file offset of the output
+      off_t in_offset = static_cast<off_t>(offset);
+      if (lseek(out, static_cast<off_t>(offset), SEEK_SET) >= 0) {
+        copied = ::sendfile(out, in, &in_offset, count);
+      }
+    }
+#else
+    (void)in;
+    (void)out;
+    (void)count;
+    (void)strategy;
+#endif
+    if (copied <= 0) {
+      // Unsupported across these files, or failing: the next strategy reports a real error
+      errno = 0;
+      return false;
+    }
+    offset += static_cast<uint64_t>(copied);
+  }
+  return true;
+}
+
+/// \internal Copy the data past offset through a buffer aligned for the page cache.
+bool copy_with_buffer(int in, int out, uint64_t size, uint64_t offset, std::error_code & ec)
+{
+  constexpr size_t kBufferSize = 1 << 20;
+  constexpr size_t kAlignment = 4096;
+  void * memory = nullptr;
+  if (posix_memalign(&memory, kAlignment, kBufferSize) != 0) {
+    ec = std::make_error_code(std::errc::not_enough_memory);
+    return false;
+  }
+  const std::unique_ptr<char, decltype(& free)> buffer(static_cast<char *>(memory), &free);
+  while (offset < size) {
+    const ssize_t count = pread(in, buffer.get(), kBufferSize, static_cast<off_t>(offset));
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return fail_errno(ec);
+    }
+    if (count == 0) {
+      // The source shrank while copying
+      break;
+    }
+    for (ssize_t written = 0; written < count; ) {
+      const ssize_t n = pwrite(
+        out, buffer.get() + written, static_cast<size_t>(count - written),
+        static_cast<off_t>(offset) + written);
+      if (n < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return fail_errno(ec);
+      }
+      written += n;
+    }
+    offset += static_cast<uint64_t>(count);
+  }
+  return true;
+}
+
+}  // namespace
+#endif
+
+bool copy_file(
+  const path & from, const path & to, copy_options options, copy_strategy & strategy)
+{
+  std::error_code ec;
+  const bool copied = copy_file(from, to, options, strategy, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot copy the file"};
+  }
+  return copied;
+}
+
+bool copy_file(
+  const path & from, const path & to, copy_options options, copy_strategy & strategy,
+  std::error_code & ec)
+{
+  ec.clear();
+  strategy = copy_strategy::none;
+  const bool skip = (options & copy_options::skip_existing) != copy_options::none;
+  const bool overwrite = (options & copy_options::overwrite_existing) != copy_options::none;
+  const bool preserve_time =
+    (options & copy_options::preserve_last_write_time) != copy_options::none;
+
+#ifdef _WIN32
+  const auto from_status = status(from, ec);
+  if (ec) {
+    return false;
+  }
+  if (!is_regular_file(from_status)) {
+    ec = std::make_error_code(std::errc::invalid_argument);
+    return false;
+  }
+  // CopyFile() fails on its own when copying a file onto itself
+  const auto to_status = status(to, ec);
+  if (ec) {
+    return false;
+  }
+  if (exists(to_status)) {
+    if (skip) {
+      return false;
+    }
+    if (!overwrite) {
+      ec = std::make_error_code(std::errc::file_exists);
+      return false;
+    }
+  }
+  // CopyFile() always preserves the modification time
+  (void)preserve_time;
+  if (!CopyFileA(from.string().c_str(), to.string().c_str(), FALSE)) {
+    ec.assign(static_cast<int>(GetLastError()), std::system_category());
+    return false;
+  }
+  strategy = copy_strategy::read_write;
+  return true;
+#else
+  const unique_fd in(open(from.native().c_str(), O_RDONLY | O_CLOEXEC));
+  if (in.get() < 0) {
+    return fail_errno(ec);
+  }
+  struct stat in_stat;
+  if (fstat(in.get(), &in_stat) != 0) {
+    return fail_errno(ec);
+  }
+  if (!S_ISREG(in_stat.st_mode)) {
+    ec = std::make_error_code(std::errc::invalid_argument);
+    return false;
+  }
+
+  // Don't truncate when opening, the destination may be the source itself
+  const int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (overwrite ? 0 : O_EXCL);
+  unique_fd out(open(to.native().c_str(), flags, in_stat.st_mode & 0777));
+  if (out.get() < 0) {
+    if (errno == EEXIST && skip) {
+      errno = 0;
+      return false;
+    }
+    return fail_errno(ec);
+  }
+  struct stat out_stat;
+  if (fstat(out.get(), &out_stat) != 0) {
+    return fail_errno(ec);
+  }
+  if (in_stat.st_dev == out_stat.st_dev && in_stat.st_ino == out_stat.st_ino) {
+    // Copying a file onto itself would truncate it
+    ec = std::make_error_code(std::errc::file_exists);
+    return false;
+  }
+  if (out_stat.st_size != 0 && ftruncate(out.get(), 0) != 0) {
+    return fail_errno(ec);
+  }
+
+  const uint64_t size = static_cast<uint64_t>(in_stat.st_size);
+  uint64_t offset = 0;
+#ifdef FICLONE
+  if (ioctl(out.get(), FICLONE, in.get()) == 0) {
+    strategy = copy_strategy::reflink;
+    offset = size;
+  }
+  errno = 0;
+#endif
+  if (strategy == copy_strategy::none) {
+    strategy = copy_strategy::copy_file_range;
+    if (!copy_in_kernel(in.get(), out.get(), size, offset, strategy)) {
+      strategy = copy_strategy::sendfile;
+      if (!copy_in_kernel(in.get(), out.get(), size, offset, strategy)) {
+        strategy = copy_strategy::read_write;
+        if (!copy_with_buffer(in.get(), out.get(), size, offset, ec)) {
+          return false;
+        }
+      }
+    }
+  }
+
+  if (preserve_time) {
+#ifdef __APPLE__
+    const struct timespec times[2] = {{0, UTIME_OMIT}, in_stat.st_mtimespec};
+#else
+    const struct timespec times[2] = {{0, UTIME_OMIT}, in_stat.st_mtim};
+#endif
+    if (futimens(out.get(), times) != 0) {
+      return fail_errno(ec);
+    }
+  }
+  if (close(out.release()) != 0) {
+    return fail_errno(ec);
+  }
+  return true;
+#endif
+}
+
+bool copy_file(const path & from, const path & to, copy_options options)
+{
+  copy_strategy strategy;
+  return copy_file(from, to, options, strategy);
+}
+
+bool copy_file(const path & from, const path & to, copy_options options, std::error_code & ec)
+{
+  copy_strategy strategy;
+  return copy_file(from, to, options, strategy, ec);
+}
+
+namespace
+{
+
+/// \internal Limits the data of the files being copied at once.
+class byte_budget final
+{
+public:
+  /// Bytes taken from the budget, given back on destruction.
+  class lease final
+  {
+public:
+    lease(byte_budget & budget, uint64_t bytes)
+    : budget_(budget), bytes_(bytes)
+    {
+    }
+
+    ~lease()
+    {
+      budget_.release(bytes_);
+    }
+
+    lease(const lease &) = delete;
+    lease & operator=(const lease &) = delete;
+
+private:
+    byte_budget & budget_;
+    uint64_t bytes_;
+  };
+
+  explicit byte_budget(uint64_t limit)
+  : limit_(limit)
+  {
+  }
+
+  /// Wait until the bytes fit in the budget, a file larger than the limit waits for all others.
+  lease acquire(uint64_t bytes)
+  {
+    if (limit_ == 0) {
+      return lease(*this, 0);
+    }
+    bytes = std::min(bytes, limit_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [this, bytes]() {return in_flight_ + bytes <= limit_;});
+    in_flight_ += bytes;
+    return lease(*this, bytes);
+  }
+
+private:
+  void release(uint64_t bytes)
+  {
+    if (bytes == 0) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    in_flight_ -= bytes;
+    condition_.notify_all();
+  }
+
+  const uint64_t limit_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  uint64_t in_flight_ = 0;
+};
+
+/// \internal A file or symlink waiting to be copied by copy().
+struct copy_item
+{
+  path from;
+  path to;
+  file_type type;
+  uint64_t size;
+};
+
+/// \internal Recreate a symlink, with the same handling of an existing destination as copy_file().
+void copy_symlink(
+  const path & from, const path & to, copy_options options, std::error_code & ec)
+{
+  ec.clear();
+#ifdef _WIN32
+  (void)from;
+  (void)to;
+  (void)options;
+#else
+  std::string target(256, '\0');
+  while (true) {
+    const ssize_t length = readlink(from.native().c_str(), &target[0], target.size());
+    if (length < 0) {
+      fail_errno(ec);
+      return;
+    }
+    if (static_cast<size_t>(length) < target.size()) {
+      target.resize(static_cast<size_t>(length));
+      break;
+    }
+    // The target may have been truncated
+    target.resize(target.size() * 2);
+  }
+  while (symlink(target.c_str(), to.native().c_str()) != 0) {
+    if (errno != EEXIST || (options & copy_options::overwrite_existing) == copy_options::none) {
+      if (errno == EEXIST && (options & copy_options::skip_existing) != copy_options::none) {
+        errno = 0;
+        return;
+      }
+      fail_errno(ec);
+      return;
+    }
+    if (unlink(to.native().c_str()) != 0) {
+      fail_errno(ec);
+      return;
+    }
+  }
+#endif
+}
+
+}  // namespace
+
+void copy(
+  const path & from, const path & to, copy_options options, const parallel_options & parallel)
+{
+  std::error_code ec;
+  copy(from, to, options, parallel, ec);
+  if (ec) {
+    throw std::system_error{ec, "cannot copy"};
+  }
+}
+
+void copy(
+  const path & from, const path & to, copy_options options, const parallel_options & parallel,
+  std::error_code & ec)
+{
+  const auto file_options = options &
+    (copy_options::skip_existing | copy_options::overwrite_existing |
+    copy_options::preserve_last_write_time);
+  const auto from_status = symlink_status(from, ec);
+  if (ec) {
+    return;
+  }
+  if (!exists(from_status)) {
+    ec = std::make_error_code(std::errc::no_such_file_or_directory);
+    return;
+  }
+  if (is_symlink(from_status)) {
+    copy_symlink(from, to, file_options, ec);
+    return;
+  }
+  if (is_regular_file(from_status)) {
+    const auto to_status = status(to, ec);
+    if (!ec) {
+      copy_file(from, is_directory(to_status) ? to / from.filename() : to, file_options, ec);
+    }
+    return;
+  }
+  if (!is_directory(from_status)) {
+    // Special files are not copied
+    ec = std::make_error_code(std::errc::not_supported);
+    return;
+  }
+
+  // Read the source tree first, so that the destination tree can be created at once
+  const size_t num_threads = resolve_num_threads(parallel.num_threads);
+  const bool recursive = (options & copy_options::recursive) != copy_options::none;
+  const auto & from_native = from.native();
+  const size_t prefix_size = from_native.size() +
+    (from_native.empty() || from_native.back() == kPreferredSeparator ? 0 : 1);
+  std::mutex mutex;
+  std::vector<path> directories;
+  std::vector<copy_item> items;
+  const bool completed = parallel_walk(
+    from, [&](const directory_entry & entry) {
+      const auto relative = std::string_view(entry.path().native()).substr(prefix_size);
+      switch (entry.type()) {
+        case file_type::directory:
+          if (!recursive) {
+            return walk_action::skip_subtree;
+          }
+          {
+            // A directory is visited before its content, so parents are listed first
+            std::lock_guard<std::mutex> lock(mutex);
+            directories.push_back(entry_path(to, relative));
+          }
+          return walk_action::proceed;
+        case file_type::regular:
+        case file_type::symlink:
+          {
+            // Only used to budget the copy, which reports the file if it cannot be read
+            std::error_code status_ec;
+            const uint64_t size =
+            entry.type() == file_type::regular ? entry.symlink_status(status_ec).size() : 0;
+            std::lock_guard<std::mutex> lock(mutex);
+            items.push_back({entry.path(), entry_path(to, relative), entry.type(), size});
+          }
+          return walk_action::proceed;
+        default:
+          return walk_action::stop;
+      }
+    }, num_threads, directory_options::none, ec);
+  if (ec) {
+    return;
+  }
+  if (!completed) {
+    // The walk only stops early on special files
+    ec = std::make_error_code(std::errc::not_supported);
+    return;
+  }
+
+  create_directories(to, ec);
+  if (ec) {
+    return;
+  }
+  for (const auto & directory : directories) {
+#ifdef _WIN32
+    const int rc = _mkdir(directory.native().c_str());
+#else
+    const int rc = mkdir(directory.native().c_str(), S_IRWXU | S_IRWXG | S_IRWXO);
+#endif
+    const int error = rc != 0 ? errno : 0;
+    if (error != 0 && (error != EEXIST || !directory.is_directory())) {
+      ec.assign(error != EEXIST ? error : ENOTDIR, std::system_category());
+      errno = 0;
+      return;
+    }
+    errno = 0;
+  }
+
+  byte_budget budget(parallel.max_bytes_in_flight);
+  work_queue<copy_item> queue;
+  for (auto & item : items) {
+    queue.push(std::move(item));
+  }
+  queue.run(
+    num_threads, [&](copy_item & item) {
+      const auto lease = budget.acquire(item.size);
+      std::error_code item_ec;
+      if (item.type == file_type::symlink) {
+        copy_symlink(item.from, item.to, file_options, item_ec);
+      } else {
+        copy_file(item.from, item.to, file_options, item_ec);
+      }
+      if (item_ec) {
+        // Stop at the first error, without unwinding through the queue
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!ec) {
+          ec = item_ec;
+        }
+        queue.cancel();
+      }
+    });
 }
 
 bool operator==(const path & a, const path & b)
 {
-  return a.string() == b.string();
+  return a.native() == b.native();
 }
 
 bool operator!=(const path & a, const path & b)
@@ -478,6 +3563,11 @@ bool operator!=(const path & a, const path & b)
   return !(a == b);
 }
 
+size_t hash_value(const path & p) noexcept
+{
+  return std::hash<std::string_view>()(p.native());
+}
+
 std::ostream & operator<<(std::ostream & os, const path & p)
 {
   os << p.string();
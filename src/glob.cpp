@@ -0,0 +1,300 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rcpputils/glob.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rcpputils
+{
+namespace fs
+{
+
+namespace
+{
+
+constexpr bool is_separator(char c) noexcept
+{
+#ifdef _WIN32
+  return c == '/' || c == '\\';
+#else
+  return c == '/';
+#endif
+}
+
+/// \internal Move to the next component at or after pos, returning false if there is none.
+bool next_component(std::string_view text, size_t & pos, std::string_view & component) noexcept
+{
+  while (pos < text.size() && is_separator(text[pos])) {
+    ++pos;
+  }
+  if (pos == text.size()) {
+    return false;
+  }
+  const size_t start = pos;
+  while (pos < text.size() && !is_separator(text[pos])) {
+    ++pos;
+  }
+  component = text.substr(start, pos - start);
+  return true;
+}
+
+}  // namespace
+
+glob_pattern::glob_pattern(std::string_view pattern)
+: pattern_(pattern)
+{
+  size_t pos = 0;
+  std::string_view text;
+  while (next_component(pattern, pos, text)) {
+    component c{false, false, static_cast<uint32_t>(tokens_.size()), 0};
+    if (text == "**") {
+      c.globstar = true;
+      components_.push_back(c);
+      continue;
+    }
+    auto add_literal = [this, &c](char ch) {
+        if (tokens_.size() > c.first_token && tokens_.back().type == token::kind::literal) {
+          ++tokens_.back().length;
+        } else {
+          tokens_.push_back({token::kind::literal, static_cast<uint32_t>(literals_.size()), 1});
+        }
+        literals_.push_back(ch);
+      };
+    for (size_t i = 0; i < text.size(); ++i) {
+      const char ch = text[i];
+      if (ch == '*') {
+        // Consecutive stars within a component are a single one
+        if (tokens_.size() == c.first_token || tokens_.back().type != token::kind::any_run) {
+          tokens_.push_back({token::kind::any_run, 0, 0});
+        }
+      } else if (ch == '?') {
+        tokens_.push_back({token::kind::any_char, 0, 0});
+      } else if (ch == '[') {
+        size_t j = i + 1;
+        const bool negate = j < text.size() && (text[j] == '!' || text[j] == '^');
+        j += negate ? 1 : 0;
+        std::bitset<256> set;
+        // A leading ']' is a member rather than the end of the set
+        const size_t members = j;
+        for (; j < text.size() && (text[j] != ']' || j == members); ++j) {
+          const auto low = static_cast<unsigned char>(text[j]);
+          if (j + 2 < text.size() && text[j + 1] == '-' && text[j + 2] != ']') {
+            const auto high = static_cast<unsigned char>(text[j + 2]);
+            for (unsigned member = low; member <= high; ++member) {
+              set.set(member);
+            }
+            j += 2;
+          } else {
+            set.set(low);
+          }
+        }
+        if (j == text.size()) {
+          throw std::invalid_argument{"unterminated set in glob pattern: " + pattern_};
+        }
+        if (negate) {
+          set.flip();
+        }
+        tokens_.push_back({token::kind::char_set, static_cast<uint32_t>(sets_.size()), 0});
+        sets_.push_back(set);
+        i = j;
+#ifndef _WIN32
+      } else if (ch == '\\' && i + 1 < text.size()) {
+        add_literal(text[++i]);
+#endif
+      } else {
+        add_literal(ch);
+      }
+    }
+    c.num_tokens = static_cast<uint32_t>(tokens_.size()) - c.first_token;
+    c.literal = c.num_tokens == 1 && tokens_.back().type == token::kind::literal;
+    components_.push_back(c);
+  }
+}
+
+std::string_view glob_pattern::literal_text(const component & c) const noexcept
+{
+  const auto & t = tokens_[c.first_token];
+  return std::string_view(literals_).substr(t.offset, t.length);
+}
+
+bool glob_pattern::match_component(const component & c, std::string_view name) const noexcept
+{
+  const token * tokens = tokens_.data() + c.first_token;
+  size_t t = 0;
+  size_t n = 0;
+  // Where to resume after the last star, if what follows it does not match
+  bool after_star = false;
+  size_t star_token = 0;
+  size_t star_name = 0;
+  while (n < name.size()) {
+    if (t < c.num_tokens) {
+      const auto & current = tokens[t];
+      switch (current.type) {
+        case token::kind::literal:
+          if (name.compare(
+              n, current.length, literals_.data() + current.offset, current.length) == 0)
+          {
+            n += current.length;
+            ++t;
+            continue;
+          }
+          break;
+        case token::kind::any_char:
+          ++n;
+          ++t;
+          continue;
+        case token::kind::char_set:
+          if (sets_[current.offset].test(static_cast<unsigned char>(name[n]))) {
+            ++n;
+            ++t;
+            continue;
+          }
+          break;
+        case token::kind::any_run:
+          after_star = true;
+          star_token = ++t;
+          star_name = n;
+          continue;
+      }
+    }
+    if (!after_star) {
+      return false;
+    }
+    // Let the last star absorb one more character
+    t = star_token;
+    n = ++star_name;
+  }
+  while (t < c.num_tokens && tokens[t].type == token::kind::any_run) {
+    ++t;
+  }
+  return t == c.num_tokens;
+}
+
+bool glob_pattern::match(std::string_view p) const noexcept
+{
+  const size_t num_components = components_.size();
+  size_t c = 0;
+  size_t pos = 0;
+  // Where to resume after the last globstar, if what follows it does not match
+  size_t star_component = num_components + 1;
+  size_t star_pos = 0;
+  std::string_view name;
+  for (;;) {
+    size_t next = pos;
+    if (!next_component(p, next, name)) {
+      break;
+    }
+    if (c < num_components && components_[c].globstar) {
+      star_component = ++c;
+      star_pos = pos;
+      continue;
+    }
+    if (c < num_components && match_component(components_[c], name)) {
+      ++c;
+      pos = next;
+      continue;
+    }
+    if (star_component > num_components) {
+      return false;
+    }
+    // Let the last globstar absorb one more component
+    next_component(p, star_pos, name);
+    pos = star_pos;
+    c = star_component;
+  }
+  while (c < num_components && components_[c].globstar) {
+    ++c;
+  }
+  return c == num_components;
+}
+
+void glob_pattern::walk(
+  const path & dir, size_t c, size_t root_size, std::vector<path> & matches) const
+{
+  const auto & current = components_[c];
+  const bool last = c + 1 == components_.size();
+  const auto options = directory_options::skip_permission_denied;
+  if (current.globstar) {
+    if (!dir.is_directory()) {
+      return;
+    }
+    // Everything below may match, including the directory itself for an empty globstar
+    const std::string_view relative = std::string_view(dir.native()).substr(root_size);
+    if (!relative.empty() && match(relative)) {
+      matches.push_back(dir);
+    }
+    for (const auto & entry : recursive_directory_iterator(dir, options)) {
+      if (match(std::string_view(entry.path().native()).substr(root_size))) {
+        matches.push_back(entry.path());
+      }
+    }
+    return;
+  }
+  if (current.literal) {
+    auto candidate = dir / std::string(literal_text(current));
+    if (last) {
+      if (candidate.exists()) {
+        matches.push_back(std::move(candidate));
+      }
+    } else if (candidate.is_directory()) {
+      walk(candidate, c + 1, root_size, matches);
+    }
+    return;
+  }
+  if (!dir.is_directory()) {
+    return;
+  }
+  for (const auto & entry : directory_iterator(dir, options)) {
+    const std::string_view native = entry.path().native();
+    size_t name_start = native.size();
+    while (name_start > 0 && !is_separator(native[name_start - 1])) {
+      --name_start;
+    }
+    if (!match_component(current, native.substr(name_start))) {
+      continue;
+    }
+    if (last) {
+      matches.push_back(entry.path());
+    } else if (entry.is_directory()) {
+      walk(entry.path(), c + 1, root_size, matches);
+    }
+  }
+}
+
+std::vector<path> glob(const path & root, const glob_pattern & pattern)
+{
+  std::vector<path> matches;
+  if (pattern.components_.empty()) {
+    return matches;
+  }
+  pattern.walk(root, 0, root.native().size(), matches);
+  std::sort(
+    matches.begin(), matches.end(), [](const path & a, const path & b) {
+      return a.native() < b.native();
+    });
+  return matches;
+}
+
+std::vector<path> glob(const path & root, std::string_view pattern)
+{
+  return glob(root, glob_pattern(pattern));
+}
+
+}  // namespace fs
+}  // namespace rcpputils
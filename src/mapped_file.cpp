@@ -0,0 +1,469 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rcpputils/mapped_file.hpp"
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#  define NOMINMAX
+#  define NOGDI
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace rcpputils
+{
+namespace fs
+{
+
+namespace
+{
+
+[[noreturn]] void throw_last_error(const char * what)
+{
+#ifdef _WIN32
+  std::error_code ec(static_cast<int>(GetLastError()), std::system_category());
+#else
+  std::error_code ec{errno, std::system_category()};
+  errno = 0;
+#endif
+  throw std::system_error{ec, what};
+}
+
+/// \internal The granularity of the offsets of mappings.
+uint64_t mapping_granularity()
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwAllocationGranularity;
+#else
+  return static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+#ifdef _WIN32
+using native_handle = HANDLE;
+const native_handle kInvalidHandle = INVALID_HANDLE_VALUE;
+#else
+using native_handle = int;
+constexpr native_handle kInvalidHandle = -1;
+#endif
+
+/// \internal Closes a file on destruction, unless released.
+class file_handle final
+{
+public:
+  explicit file_handle(native_handle handle)
+  : handle_(handle)
+  {
+  }
+
+  ~file_handle()
+  {
+    if (handle_ != kInvalidHandle) {
+#ifdef _WIN32
+      CloseHandle(handle_);
+#else
+      close(handle_);
+#endif
+    }
+  }
+
+  file_handle(const file_handle &) = delete;
+  file_handle & operator=(const file_handle &) = delete;
+
+  native_handle get() const {return handle_;}
+
+  native_handle release()
+  {
+    return std::exchange(handle_, kInvalidHandle);
+  }
+
+private:
+  native_handle handle_;
+};
+
+uint64_t size_of(native_handle handle)
+{
+#ifdef _WIN32
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(handle, &file_size)) {
+    throw_last_error("cannot get the size of the mapped file");
+  }
+  return static_cast<uint64_t>(file_size.QuadPart);
+#else
+  struct stat stat_buffer;
+  if (fstat(handle, &stat_buffer) != 0) {
+    throw_last_error("cannot stat the mapped file");
+  }
+  return static_cast<uint64_t>(stat_buffer.st_size);
+#endif
+}
+
+/// \internal Grow a file with its blocks allocated, or truncate it.
+void resize_file(native_handle handle, uint64_t from, uint64_t to)
+{
+#ifdef _WIN32
+  (void)from;
+  FILE_END_OF_FILE_INFO info;
+  info.EndOfFile.QuadPart = static_cast<LONGLONG>(to);
+  if (!SetFileInformationByHandle(handle, FileEndOfFileInfo, &info, sizeof(info))) {
+    throw_last_error("cannot resize the mapped file");
+  }
+#else
+#  ifdef __linux__
+  if (to > from) {
+    if (fallocate(handle, 0, static_cast<off_t>(from), static_cast<off_t>(to - from)) == 0) {
+      return;
+    }
+    // Not all filesystems can allocate blocks ahead, fall back to a sparse file then
+    if (errno != EOPNOTSUPP && errno != ENOSYS) {
+      throw_last_error("cannot allocate the mapped file");
+    }
+    errno = 0;
+  }
+#  else
+  (void)from;
+#  endif
+  if (ftruncate(handle, static_cast<off_t>(to)) != 0) {
+    throw_last_error("cannot resize the mapped file");
+  }
+#endif
+}
+
+/// \internal Resize a mapping in place or move it, returning nullptr if the system cannot.
+void * remap_view(void * mapping, size_t size, size_t new_size)
+{
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+  void * view = mremap(mapping, size, new_size, MREMAP_MAYMOVE);
+  if (view == MAP_FAILED) {
+    throw_last_error("cannot remap the file");
+  }
+  return view;
+#else
+  (void)mapping;
+  (void)size;
+  (void)new_size;
+  return nullptr;
+#endif
+}
+
+void unmap_view(void * mapping, size_t size) noexcept
+{
+#ifdef _WIN32
+  (void)size;
+  UnmapViewOfFile(mapping);
+#else
+  munmap(mapping, size);
+#endif
+}
+
+}  // namespace
+
+mapped_file::mapped_file(const path & p)
+: mapped_file(p, map_mode::read_only, 0, 0)
+{
+}
+
+mapped_file::mapped_file(const path & p, uint64_t offset, size_t length)
+: mapped_file(p, map_mode::read_only, offset, length)
+{
+}
+
+mapped_file::mapped_file(const path & p, map_mode mode, uint64_t offset, size_t length)
+: mode_(mode), offset_(offset)
+{
+  const bool writable = mode == map_mode::read_write;
+#ifdef _WIN32
+  file_handle file(
+    CreateFileA(
+      p.string().c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+      FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, writable ? OPEN_ALWAYS : OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL, nullptr));
+#else
+  file_handle file(
+    open(
+      p.native().c_str(), writable ? O_RDWR | O_CREAT | O_CLOEXEC : O_RDONLY | O_CLOEXEC,
+      S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH));
+#endif
+  if (file.get() == kInvalidHandle) {
+    throw_last_error("cannot open the file to map");
+  }
+  const uint64_t size = size_of(file.get());
+  if (offset > size || (!writable && length > size - offset)) {
+    throw std::system_error{
+            std::make_error_code(std::errc::invalid_argument),
+            "the range to map goes past the end of the file"};
+  }
+  if (writable && length > size - offset) {
+    resize_file(file.get(), size, offset + length);
+  }
+
+#ifdef _WIN32
+  file_ = file.get();
+#else
+  fd_ = file.get();
+#endif
+  map(length != 0 ? length : static_cast<size_t>(size - offset));
+  if (writable) {
+    // Keep the file, to resize it later
+    file.release();
+  } else {
+#ifdef _WIN32
+    file_ = nullptr;
+#else
+    fd_ = -1;
+#endif
+  }
+}
+
+void mapped_file::map(size_t size)
+{
+  // Only claim the size once mapped, so that a failure leaves an empty mapping
+  size_ = 0;
+  mapping_size_ = 0;
+  data_ = nullptr;
+  mapping_ = nullptr;
+  // Nothing to map, which mmap() would refuse
+  if (size == 0) {
+    return;
+  }
+
+  const bool writable = mode_ == map_mode::read_write;
+  const uint64_t aligned_offset = offset_ - offset_ % mapping_granularity();
+  const size_t mapping_size = size + static_cast<size_t>(offset_ - aligned_offset);
+#ifdef _WIN32
+  const uint64_t mapping_end = offset_ + size;
+  const HANDLE mapping = CreateFileMappingA(
+    file_, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+    static_cast<DWORD>(mapping_end >> 32), static_cast<DWORD>(mapping_end & 0xffffffff),
+    nullptr);
+  if (mapping == nullptr) {
+    throw_last_error("cannot map the file");
+  }
+  void * view = MapViewOfFile(
+    mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, static_cast<DWORD>(aligned_offset >> 32),
+    static_cast<DWORD>(aligned_offset & 0xffffffff), mapping_size);
+  // The view keeps the mapping object alive
+  CloseHandle(mapping);
+  if (view == nullptr) {
+    throw_last_error("cannot map the file");
+  }
+#else
+  void * view = mmap(
+    nullptr, mapping_size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd_,
+    static_cast<off_t>(aligned_offset));
+  if (view == MAP_FAILED) {
+    throw_last_error("cannot map the file");
+  }
+#endif
+  mapping_ = view;
+  mapping_size_ = mapping_size;
+  data_ = static_cast<std::byte *>(mapping_) + (offset_ - aligned_offset);
+  size_ = size;
+}
+
+mapped_file::~mapped_file()
+{
+  unmap();
+}
+
+mapped_file::mapped_file(mapped_file && other) noexcept
+:
+#ifdef _WIN32
+  file_(std::exchange(other.file_, nullptr)),
+#else
+  fd_(std::exchange(other.fd_, -1)),
+#endif
+  mode_(std::exchange(other.mode_, map_mode::read_only)),
+  mapping_(std::exchange(other.mapping_, nullptr)),
+  mapping_size_(std::exchange(other.mapping_size_, 0)),
+  data_(std::exchange(other.data_, nullptr)),
+  size_(std::exchange(other.size_, 0)),
+  offset_(std::exchange(other.offset_, 0))
+{
+}
+
+mapped_file & mapped_file::operator=(mapped_file && other) noexcept
+{
+  if (this != &other) {
+    unmap();
+#ifdef _WIN32
+    file_ = std::exchange(other.file_, nullptr);
+#else
+    fd_ = std::exchange(other.fd_, -1);
+#endif
+    mode_ = std::exchange(other.mode_, map_mode::read_only);
+    mapping_ = std::exchange(other.mapping_, nullptr);
+    mapping_size_ = std::exchange(other.mapping_size_, 0);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    offset_ = std::exchange(other.offset_, 0);
+  }
+  return *this;
+}
+
+void mapped_file::resize(size_t size)
+{
+  if (mode_ != map_mode::read_write) {
+    throw std::system_error{
+            std::make_error_code(std::errc::operation_not_permitted),
+            "cannot resize a read-only mapping"};
+  }
+#ifdef _WIN32
+  const native_handle file = file_;
+#else
+  const native_handle file = fd_;
+#endif
+  const uint64_t file_size = size_of(file);
+  const uint64_t end = offset_ + size;
+  if (end > file_size) {
+    // Grow the file first, so that the new pages are backed
+    resize_file(file, file_size, end);
+  }
+  void * view = mapping_ != nullptr && size != 0 ?
+    remap_view(mapping_, mapping_size_, mapping_size_ - size_ + size) : nullptr;
+  if (view != nullptr) {
+    data_ = static_cast<std::byte *>(view) + (data_ - static_cast<std::byte *>(mapping_));
+    mapping_ = view;
+    mapping_size_ = mapping_size_ - size_ + size;
+    size_ = size;
+  } else {
+    if (mapping_ != nullptr) {
+      unmap_view(mapping_, mapping_size_);
+      mapping_ = nullptr;
+    }
+    map(size);
+  }
+  if (end < file_size) {
+    // Truncate last, so that no page is left mapped beyond the end of the file
+    resize_file(file, file_size, end);
+  }
+}
+
+void mapped_file::sync(sync_mode mode)
+{
+  sync(0, size_, mode);
+}
+
+void mapped_file::sync(size_t offset, size_t length, sync_mode mode)
+{
+  if (offset > size_ || length > size_ - offset) {
+    throw std::system_error{
+            std::make_error_code(std::errc::invalid_argument),
+            "the range to sync is not within the mapping"};
+  }
+  if (length == 0) {
+    return;
+  }
+  auto * const begin = data_ + offset;
+  const size_t misalignment =
+    static_cast<size_t>(reinterpret_cast<uintptr_t>(begin) % mapping_granularity());
+#ifdef _WIN32
+  if (!FlushViewOfFile(begin - misalignment, length + misalignment)) {
+    throw_last_error("cannot write the mapping back");
+  }
+  // FlushViewOfFile() only starts the write back, the file cache needs a flush to wait for it
+  if (mode == sync_mode::sync && file_ != nullptr && !FlushFileBuffers(file_)) {
+    throw_last_error("cannot write the mapping back");
+  }
+#else
+  const int flags = mode == sync_mode::sync ? MS_SYNC : MS_ASYNC;
+  if (msync(begin - misalignment, length + misalignment, flags) != 0) {
+    throw_last_error("cannot write the mapping back");
+  }
+#endif
+}
+
+bool mapped_file::advise(access_advice advice) const noexcept
+{
+  return advise(advice, 0, size_);
+}
+
+bool mapped_file::advise(access_advice advice, size_t offset, size_t length) const noexcept
+{
+  if (offset > size_ || length > size_ - offset) {
+    return false;
+  }
+  if (length == 0) {
+    return true;
+  }
+  // Hints apply to whole pages, the range is extended to the start of its first one
+  auto * const begin = data_ + offset;
+  const size_t misalignment =
+    static_cast<size_t>(reinterpret_cast<uintptr_t>(begin) % mapping_granularity());
+#ifdef _WIN32
+  // Windows can only prefetch, the other patterns are left to the cache manager
+  if (advice != access_advice::willneed) {
+    return advice == access_advice::normal;
+  }
+  WIN32_MEMORY_RANGE_ENTRY range;
+  range.VirtualAddress = begin - misalignment;
+  range.NumberOfBytes = length + misalignment;
+  return PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0) != 0;
+#else
+  int native_advice = MADV_NORMAL;
+  switch (advice) {
+    case access_advice::normal: native_advice = MADV_NORMAL; break;
+    case access_advice::sequential: native_advice = MADV_SEQUENTIAL; break;
+    case access_advice::random: native_advice = MADV_RANDOM; break;
+    case access_advice::willneed: native_advice = MADV_WILLNEED; break;
+    case access_advice::hugepage:
+#  ifdef MADV_HUGEPAGE
+      native_advice = MADV_HUGEPAGE;
+      break;
+#  else
+      return false;
+#  endif
+  }
+  const bool advised = madvise(begin - misalignment, length + misalignment, native_advice) == 0;
+  errno = 0;
+  return advised;
+#endif
+}
+
+void mapped_file::unmap() noexcept
+{
+  if (mapping_ != nullptr) {
+    unmap_view(mapping_, mapping_size_);
+  }
+#ifdef _WIN32
+  if (file_ != nullptr) {
+    CloseHandle(file_);
+  }
+  file_ = nullptr;
+#else
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+  fd_ = -1;
+#endif
+  mode_ = map_mode::read_only;
+  mapping_ = nullptr;
+  mapping_size_ = 0;
+  data_ = nullptr;
+  size_ = 0;
+  offset_ = 0;
+}
+
+}  // namespace fs
+}  // namespace rcpputils
@@ -0,0 +1,180 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rcpputils/path_interner.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rcpputils
+{
+namespace fs
+{
+
+namespace
+{
+
+/// \internal The size of the blocks holding the components, unless one is larger.
+constexpr size_t kBlockSize = 64 * 1024;
+
+uint64_t child_key(uint32_t parent, uint32_t name) noexcept
+{
+  return (static_cast<uint64_t>(parent) << 32) | name;
+}
+
+/// \internal Call a function on each component of a non-empty path, split at each separator.
+template<typename FunctionT>
+bool for_each_component(std::string_view p, FunctionT && function)
+{
+  for (size_t from = 0; ; ) {
+    const auto end = p.find(kPreferredSeparator, from);
+    if (!function(p.substr(from, end == std::string_view::npos ? end : end - from))) {
+      return false;
+    }
+    if (end == std::string_view::npos) {
+      return true;
+    }
+    from = end + 1;
+  }
+}
+
+}  // namespace
+
+path_interner::path_interner()
+: nodes_{{0, 0}}, names_{std::string_view()}
+{
+  name_index_.emplace(std::string_view(), 0);
+}
+
+path_interner::~path_interner() = default;
+
+uint32_t path_interner::intern_name(std::string_view name)
+{
+  const auto found = name_index_.find(name);
+  if (found != name_index_.end()) {
+    return found->second;
+  }
+  if (block_size_ - block_used_ < name.size()) {
+    block_size_ = std::max(kBlockSize, name.size());
+    blocks_.push_back(std::make_unique<char[]>(block_size_));
+    block_used_ = 0;
+  }
+  char * storage = blocks_.back().get() + block_used_;
+  std::memcpy(storage, name.data(), name.size());
+  block_used_ += name.size();
+  const auto index = static_cast<uint32_t>(names_.size());
+  names_.emplace_back(storage, name.size());
+  name_index_.emplace(names_.back(), index);
+  return index;
+}
+
+path_interner::handle path_interner::intern(handle parent, std::string_view name)
+{
+  const auto key = child_key(parent.index_, intern_name(name));
+  const auto found = children_.find(key);
+  if (found != children_.end()) {
+    return handle(found->second);
+  }
+  if (nodes_.size() > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error{"too many paths to intern"};
+  }
+  const auto index = static_cast<uint32_t>(nodes_.size());
+  nodes_.push_back({parent.index_, static_cast<uint32_t>(key)});
+  children_.emplace(key, index);
+  return handle(index);
+}
+
+path_interner::handle path_interner::intern(std::string_view p)
+{
+  handle current;
+  if (p.empty()) {
+    return current;
+  }
+  for_each_component(
+    p, [this, &current](std::string_view name) {
+      current = intern(current, name);
+      return true;
+    });
+  return current;
+}
+
+std::optional<path_interner::handle> path_interner::find(std::string_view p) const
+{
+  handle current;
+  if (p.empty()) {
+    return current;
+  }
+  const bool found = for_each_component(
+    p, [this, &current](std::string_view name) {
+      const auto name_index = name_index_.find(name);
+      if (name_index == name_index_.end()) {
+        return false;
+      }
+      const auto child = children_.find(child_key(current.index_, name_index->second));
+      if (child == children_.end()) {
+        return false;
+      }
+      current = handle(child->second);
+      return true;
+    });
+  return found ? std::optional<handle>(current) : std::nullopt;
+}
+
+path path_interner::get(handle h) const
+{
+  if (h.index_ == 0) {
+    return path();
+  }
+  size_t size = 0;
+  for (uint32_t i = h.index_; i != 0; i = nodes_[i].parent) {
+    size += names_[nodes_[i].name].size() + 1;
+  }
+  // Filled from its end, since nodes only know their parent
+  std::string result(size - 1, kPreferredSeparator);
+  size_t end = result.size();
+  for (uint32_t i = h.index_; i != 0; i = nodes_[i].parent) {
+    const auto name = names_[nodes_[i].name];
+    end -= name.size();
+    if (!name.empty()) {
+      std::memcpy(&result[end], name.data(), name.size());
+    }
+    end = end > 0 ? end - 1 : 0;
+  }
+  return path(std::move(result));
+}
+
+path_interner::handle path_interner::parent(handle h) const noexcept
+{
+  return handle(nodes_[h.index_].parent);
+}
+
+std::string_view path_interner::filename(handle h) const noexcept
+{
+  return names_[nodes_[h.index_].name];
+}
+
+size_t path_interner::size() const noexcept
+{
+  return nodes_.size();
+}
+
+}  // namespace fs
+}  // namespace rcpputils
@@ -0,0 +1,561 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rcpputils/watcher.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#  include <poll.h>
+#  include <sys/inotify.h>
+#  include <unistd.h>
+#endif
+
+namespace rcpputils
+{
+namespace fs
+{
+
+#ifdef __linux__
+
+namespace
+{
+
+[[noreturn]] void throw_errno(const char * what)
+{
+  std::error_code ec{errno, std::system_category()};
+  errno = 0;
+  throw std::system_error{ec, what};
+}
+
+constexpr uint32_t kWatchMask = IN_CREATE | IN_MODIFY | IN_ATTRIB | IN_DELETE | IN_MOVED_FROM |
+  IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_EXCL_UNLINK;
+
+watch_change to_changes(uint32_t mask)
+{
+  watch_change changes = watch_change::none;
+  if (mask & (IN_CREATE | IN_MOVED_TO)) {
+    changes = changes | watch_change::created;
+  }
+  if (mask & IN_MODIFY) {
+    changes = changes | watch_change::modified;
+  }
+  if (mask & (IN_DELETE | IN_MOVED_FROM | IN_DELETE_SELF | IN_MOVE_SELF)) {
+    changes = changes | watch_change::removed;
+  }
+  if (mask & IN_ATTRIB) {
+    changes = changes | watch_change::attributes;
+  }
+  return changes;
+}
+
+/// \internal Whether a path is strictly below a directory, comparing them as strings.
+bool is_below(const std::string & p, const std::string & dir)
+{
+  if (dir.empty() || p.size() <= dir.size() || p.compare(0, dir.size(), dir) != 0) {
+    return false;
+  }
+  return dir.back() == '/' || p[dir.size()] == '/';
+}
+
+std::string join(const std::string & dir, const char * name)
+{
+  return dir.back() == '/' ? dir + name : dir + '/' + name;
+}
+
+/// \internal The path as a key, without the trailing separator given to add() or remove().
+std::string watch_key(const path & p)
+{
+  std::string key = p.string();
+  while (key.size() > 1 && key.back() == '/') {
+    key.pop_back();
+  }
+  return key;
+}
+
+/// \internal Scan the entries of a watched path, keeping the ones that can be queried.
+std::unordered_map<std::string, file_status> scan(const std::string & root, bool recursive)
+{
+  std::unordered_map<std::string, file_status> snapshot;
+  const auto root_status = status(path(root));
+  if (!exists(root_status)) {
+    return snapshot;
+  }
+  snapshot.emplace(root, root_status);
+  if (!is_directory(root_status)) {
+    return snapshot;
+  }
+  auto add_entries = [&snapshot](auto && entries) {
+      for (const auto & entry : entries) {
+        try {
+          const auto s = entry.symlink_status();
+          if (exists(s)) {
+            snapshot.emplace(entry.path().string(), s);
+          }
+        } catch (const std::system_error &) {
+          // Removed or inaccessible by now, so it is left out
+        }
+      }
+    };
+  const auto options = directory_options::skip_permission_denied;
+  try {
+    if (recursive) {
+      add_entries(recursive_directory_iterator(path(root), options));
+    } else {
+      add_entries(directory_iterator(path(root), options));
+    }
+  } catch (const std::system_error &) {
+    // The directory was removed while scanning, which the next events report
+  }
+  return snapshot;
+}
+
+}  // namespace
+
+struct watcher::impl
+{
+  struct root_state
+  {
+    watch_options options;
+    // The entries last seen, kept only to resync
+    std::unordered_map<std::string, file_status> snapshot;
+  };
+
+  struct watch_state
+  {
+    std::string path;
+    // The roots needing the descriptor, which inotify shares between the paths of an inode
+    std::vector<std::string> roots;
+    bool is_directory = false;
+  };
+
+  impl()
+  : fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+  {
+    if (fd < 0) {
+      throw_errno("cannot initialize inotify");
+    }
+  }
+
+  ~impl()
+  {
+    close(fd);
+  }
+
+  impl(const impl &) = delete;
+  impl & operator=(const impl &) = delete;
+
+  /// Watch a single path on behalf of a root, returning false if it could not be watched.
+  bool watch(const std::string & p, const std::string & root, bool is_directory, bool throw_error)
+  {
+    const int wd = inotify_add_watch(fd, p.c_str(), kWatchMask);
+    if (wd < 0) {
+      if (throw_error) {
+        throw_errno("cannot watch path");
+      }
+      errno = 0;
+      return false;
+    }
+    // A directory moved within the tree keeps its descriptor, under a new path
+    auto & state = watches[wd];
+    if (!state.path.empty() && state.path != p) {
+      descriptors.erase(state.path);
+    }
+    state.path = p;
+    if (std::find(state.roots.begin(), state.roots.end(), root) == state.roots.end()) {
+      state.roots.push_back(root);
+    }
+    state.is_directory = is_directory;
+    descriptors[p] = wd;
+    return true;
+  }
+
+  /// Watch a directory and its subdirectories, optionally reporting their entries as created.
+  void watch_tree(const std::string & dir, const std::string & root, bool throw_error, bool report)
+  {
+    if (!watch(dir, root, true, throw_error)) {
+      return;
+    }
+    try {
+      for (const auto & entry :
+        recursive_directory_iterator(path(dir), directory_options::skip_permission_denied))
+      {
+        const bool is_directory = entry.type() == file_type::directory;
+        if (is_directory) {
+          watch(entry.path().string(), root, true, throw_error);
+        }
+        if (report) {
+          record(entry.path().string(), watch_change::created, is_directory, root);
+        }
+      }
+    } catch (const std::system_error &) {
+      if (throw_error) {
+        throw;
+      }
+    }
+  }
+
+  /// Stop watching a path of a root, and everything below it that no other root needs.
+  void unwatch_tree(const std::string & p, const std::string & root)
+  {
+    for (auto it = descriptors.begin(); it != descriptors.end(); ) {
+      if (it->first != p && !is_below(it->first, p)) {
+        ++it;
+        continue;
+      }
+      const auto state = watches.find(it->second);
+      auto & roots_of_watch = state->second.roots;
+      roots_of_watch.erase(
+        std::remove(roots_of_watch.begin(), roots_of_watch.end(), root), roots_of_watch.end());
+      if (roots_of_watch.empty()) {
+        inotify_rm_watch(fd, it->second);
+        watches.erase(state);
+        it = descriptors.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  /// Add changes to the event of a target, creating it on its first change.
+  void record(
+    const std::string & target, watch_change changes, bool is_directory, const std::string & root)
+  {
+    const auto inserted = event_index.emplace(target, events.size());
+    if (inserted.second) {
+      events.push_back(watch_event{path(target, deferred_parse), changes, is_directory});
+      event_roots.push_back({root});
+    } else {
+      const size_t index = inserted.first->second;
+      auto & event = events[index];
+      event.changes = event.changes | changes;
+      event.is_directory = is_directory;
+      auto & roots_of_event = event_roots[index];
+      if (std::find(roots_of_event.begin(), roots_of_event.end(), root) == roots_of_event.end()) {
+        roots_of_event.push_back(root);
+      }
+    }
+  }
+
+  void handle(const inotify_event & event)
+  {
+    if (event.mask & IN_Q_OVERFLOW) {
+      overflowed = true;
+      return;
+    }
+    const auto found = watches.find(event.wd);
+    if (found == watches.end()) {
+      // Already unwatched, which is confirmed by IN_IGNORED
+      return;
+    }
+    if (event.mask & IN_IGNORED) {
+      const auto descriptor = descriptors.find(found->second.path);
+      if (descriptor != descriptors.end() && descriptor->second == event.wd) {
+        descriptors.erase(descriptor);
+      }
+      watches.erase(found);
+      return;
+    }
+    // Copied, as watching or unwatching below may invalidate the state
+    const watch_state state = found->second;
+    const auto changes = to_changes(event.mask);
+    if (changes == watch_change::none) {
+      return;
+    }
+    if (event.len == 0) {
+      // A change to the watched path itself
+      for (const auto & root : state.roots) {
+        record(state.path, changes, state.is_directory, root);
+        if (event.mask & IN_MOVE_SELF) {
+          // The path does not refer to it anymore
+          unwatch_tree(state.path, root);
+        }
+      }
+      return;
+    }
+    const std::string target = join(state.path, event.name);
+    const bool is_directory = (event.mask & IN_ISDIR) != 0;
+    for (const auto & root : state.roots) {
+      record(target, changes, is_directory, root);
+      if (!is_directory || !roots[root].options.recursive) {
+        continue;
+      }
+      if (event.mask & IN_MOVED_FROM) {
+        unwatch_tree(target, root);
+      }
+      if (event.mask & (IN_CREATE | IN_MOVED_TO)) {
+        // Entries may have been created before the watch was in place
+        watch_tree(target, root, false, true);
+      }
+    }
+  }
+
+  /// Update the snapshots of the roots to resync, from the events recorded so far.
+  void update_snapshots()
+  {
+    for (size_t i = 0; i < events.size(); ++i) {
+      for (const auto & root_path : event_roots[i]) {
+        auto & root = roots[root_path];
+        if (!root.options.resync) {
+          continue;
+        }
+        const auto & target = events[i].target.native();
+        int error = 0;
+        file_status s;
+        try {
+          s = symlink_status(events[i].target);
+        } catch (const std::system_error & e) {
+          error = e.code().value();
+        }
+        if (exists(s)) {
+          root.snapshot[target] = s;
+          continue;
+        }
+        if (error != 0) {
+          continue;
+        }
+        root.snapshot.erase(target);
+        if (events[i].is_directory) {
+          // A directory moved out of the tree takes its entries with it, without further events
+          for (auto it = root.snapshot.begin(); it != root.snapshot.end(); ) {
+            it = is_below(it->first, target) ? root.snapshot.erase(it) : std::next(it);
+          }
+        }
+      }
+    }
+  }
+
+  /// Recover from dropped events, by watching new directories and comparing snapshots.
+  void resync()
+  {
+    overflowed = false;
+    for (auto & root : roots) {
+      const auto & root_path = root.first;
+      const auto & options = root.second.options;
+      if (options.recursive) {
+        watch_tree(root_path, root_path, false, false);
+      }
+      if (!options.resync) {
+        record(root_path, watch_change::overflow, path(root_path).is_directory(), root_path);
+        continue;
+      }
+      auto fresh = scan(root_path, options.recursive);
+      auto & snapshot = root.second.snapshot;
+      for (const auto & entry : fresh) {
+        const auto old = snapshot.find(entry.first);
+        const auto & s = entry.second;
+        watch_change changes = watch_change::none;
+        if (old == snapshot.end()) {
+          changes = watch_change::created;
+        } else if (old->second.type() != s.type() || old->second.inode() != s.inode()) {
+          changes = watch_change::removed | watch_change::created;
+        } else {
+          // The entries of directories are compared on their own, as with inotify
+          if (!is_directory(s) && (old->second.size() != s.size() ||
+            old->second.last_write_time() != s.last_write_time()))
+          {
+            changes = changes | watch_change::modified;
+          }
+          if (old->second.permissions() != s.permissions()) {
+            changes = changes | watch_change::attributes;
+          }
+        }
+        if (changes != watch_change::none) {
+          record(entry.first, changes, is_directory(s), root_path);
+        }
+      }
+      for (const auto & entry : snapshot) {
+        if (fresh.count(entry.first) == 0) {
+          record(entry.first, watch_change::removed, is_directory(entry.second), root_path);
+        }
+      }
+      snapshot = std::move(fresh);
+    }
+  }
+
+  /// Read and coalesce the pending events, until the queue is drained.
+  void read_events()
+  {
+    alignas(inotify_event) char buffer[64 * 1024];
+    for (;;) {
+      const ssize_t length = read(fd, buffer, sizeof(buffer));
+      if (length < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno == EAGAIN) {
+          errno = 0;
+          break;
+        }
+        throw_errno("cannot read events");
+      }
+      for (char * it = buffer; it < buffer + length; ) {
+        const auto * event = reinterpret_cast<const inotify_event *>(it);
+        handle(*event);
+        it += sizeof(inotify_event) + event->len;
+      }
+      // Stop once the queue was drained, rather than chasing a steady stream of events
+      if (static_cast<size_t>(length) < sizeof(buffer) - sizeof(inotify_event) - NAME_MAX - 1) {
+        break;
+      }
+    }
+    update_snapshots();
+    if (overflowed) {
+      resync();
+    }
+  }
+
+  std::vector<watch_event> take_events()
+  {
+    std::vector<watch_event> result = std::move(events);
+    events.clear();
+    event_roots.clear();
+    event_index.clear();
+    return result;
+  }
+
+  int fd;
+  std::unordered_map<std::string, root_state> roots;
+  std::unordered_map<int, watch_state> watches;
+  std::unordered_map<std::string, int> descriptors;
+  bool overflowed = false;
+
+  // The events being read, with their roots and the position of each target
+  std::vector<watch_event> events;
+  std::vector<std::vector<std::string>> event_roots;
+  std::unordered_map<std::string, size_t> event_index;
+};
+
+watcher::watcher()
+: impl_(std::make_unique<impl>())
+{
+}
+
+void watcher::add(const path & p, const watch_options & options)
+{
+  const std::string key = watch_key(p);
+  const bool is_dir = p.is_directory();
+  auto & root = impl_->roots[key];
+  root.options = options;
+  try {
+    if (options.recursive && is_dir) {
+      impl_->watch_tree(key, key, true, false);
+    } else {
+      impl_->watch(key, key, is_dir, true);
+    }
+  } catch (const std::system_error &) {
+    impl_->unwatch_tree(key, key);
+    impl_->roots.erase(key);
+    throw;
+  }
+  root.snapshot.clear();
+  if (options.resync) {
+    root.snapshot = scan(key, options.recursive);
+  }
+}
+
+bool watcher::remove(const path & p)
+{
+  const std::string key = watch_key(p);
+  if (impl_->roots.erase(key) == 0) {
+    return false;
+  }
+  impl_->unwatch_tree(key, key);
+  return true;
+}
+
+int watcher::native_handle() const noexcept
+{
+  return impl_ ? impl_->fd : -1;
+}
+
+std::vector<watch_event> watcher::poll(std::chrono::milliseconds timeout)
+{
+  if (!impl_) {
+    // Moved from, so there is nothing to read
+    return {};
+  }
+  if (timeout.count() != 0) {
+    pollfd descriptor{impl_->fd, POLLIN, 0};
+    const auto wait = std::min<std::chrono::milliseconds::rep>(timeout.count(), INT_MAX);
+    if (::poll(&descriptor, 1, wait < 0 ? -1 : static_cast<int>(wait)) < 0) {
+      if (errno != EINTR) {
+        throw_errno("cannot wait for events");
+      }
+      errno = 0;
+    }
+  }
+  impl_->read_events();
+  return impl_->take_events();
+}
+
+#else
+
+struct watcher::impl
+{
+};
+
+watcher::watcher()
+{
+  throw std::system_error{
+    std::make_error_code(std::errc::function_not_supported), "cannot watch paths"};
+}
+
+void watcher::add(const path &, const watch_options &)
+{
+  throw std::system_error{
+    std::make_error_code(std::errc::function_not_supported), "cannot watch paths"};
+}
+
+bool watcher::remove(const path &)
+{
+  return false;
+}
+
+int watcher::native_handle() const noexcept
+{
+  return -1;
+}
+
+std::vector<watch_event> watcher::poll(std::chrono::milliseconds)
+{
+  return {};
+}
+
+#endif
+
+watcher::~watcher() = default;
+
+watcher::watcher(watcher && other) noexcept = default;
+
+watcher & watcher::operator=(watcher && other) noexcept = default;
+
+size_t watcher::poll(const callback & on_event, std::chrono::milliseconds timeout)
+{
+  const auto events = poll(timeout);
+  for (const auto & event : events) {
+    on_event(event);
+  }
+  return events.size();
+}
+
+}  // namespace fs
+}  // namespace rcpputils
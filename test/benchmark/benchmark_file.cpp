@@ -0,0 +1,150 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+#include "rcpputils/direct_writer.hpp"
+#include "rcpputils/file.hpp"
+#include "rcpputils/filesystem_helper.hpp"
+
+using path = rcpputils::fs::path;
+
+namespace
+{
+
+// Records written per iteration, each made of a header, a payload and a trailer
+constexpr size_t kNumRecords = 1 << 14;
+constexpr size_t kHeaderSize = 16;
+constexpr size_t kTrailerSize = 8;
+// Bytes streamed per iteration
+constexpr size_t kStreamSize = 256 << 20;
+
+/// A temporary directory, removed on destruction.
+class temp_dir
+{
+public:
+  temp_dir()
+  : dir_(rcpputils::fs::create_temp_directory("benchmark_file"))
+  {
+  }
+
+  ~temp_dir()
+  {
+    rcpputils::fs::remove_all(dir_);
+  }
+
+  path file() const {return dir_ / "records.bin";}
+
+private:
+  path dir_;
+};
+
+rcpputils::fs::file open_output(const temp_dir & dir)
+{
+  using rcpputils::fs::open_flags;
+  return rcpputils::fs::file(
+    dir.file(), open_flags::write | open_flags::create | open_flags::truncate);
+}
+
+}  // namespace
+
+// The three parts are copied into a staging buffer, written with one call.
+static void BM_write_records_staged(benchmark::State & state)
+{
+  const auto payload_size = static_cast<size_t>(state.range(0));
+  const std::vector<char> header(kHeaderSize, 'h');
+  const std::vector<char> payload(payload_size, 'p');
+  const std::vector<char> trailer(kTrailerSize, 't');
+  std::vector<char> staging(kHeaderSize + payload_size + kTrailerSize);
+  const temp_dir dir;
+  std::error_code ec;
+  for (auto _ : state) {
+    auto output = open_output(dir);
+    for (size_t i = 0; i < kNumRecords; ++i) {
+      std::memcpy(staging.data(), header.data(), kHeaderSize);
+      std::memcpy(staging.data() + kHeaderSize, payload.data(), payload_size);
+      std::memcpy(staging.data() + kHeaderSize + payload_size, trailer.data(), kTrailerSize);
+      output.write(staging.data(), staging.size(), ec);
+    }
+  }
+  state.SetBytesProcessed(
+    state.iterations() * kNumRecords * (kHeaderSize + payload_size + kTrailerSize));
+}
+BENCHMARK(BM_write_records_staged)->Arg(64)->Arg(4096)->Arg(65536)
+  ->Unit(benchmark::kMillisecond);
+
+// The three parts are gathered by a single writev() call.
+static void BM_write_records_writev(benchmark::State & state)
+{
+  const auto payload_size = static_cast<size_t>(state.range(0));
+  const std::vector<char> header(kHeaderSize, 'h');
+  const std::vector<char> payload(payload_size, 'p');
+  const std::vector<char> trailer(kTrailerSize, 't');
+  const temp_dir dir;
+  std::error_code ec;
+  for (auto _ : state) {
+    auto output = open_output(dir);
+    for (size_t i = 0; i < kNumRecords; ++i) {
+      output.writev(
+        {{header.data(), kHeaderSize}, {payload.data(), payload_size},
+          {trailer.data(), kTrailerSize}}, ec);
+    }
+  }
+  state.SetBytesProcessed(
+    state.iterations() * kNumRecords * (kHeaderSize + payload_size + kTrailerSize));
+}
+BENCHMARK(BM_write_records_writev)->Arg(64)->Arg(4096)->Arg(65536)
+  ->Unit(benchmark::kMillisecond);
+
+// Streaming a large file in chunks, as a recorder would, through the page cache or bypassing it.
+// The file goes to the temporary directory, so set TMPDIR to compare filesystems.
+static void BM_write_stream_buffered(benchmark::State & state)
+{
+  const auto chunk_size = static_cast<size_t>(state.range(0));
+  const std::vector<char> chunk(chunk_size, 'c');
+  const temp_dir dir;
+  std::error_code ec;
+  for (auto _ : state) {
+    auto output = open_output(dir);
+    for (size_t written = 0; written < kStreamSize; written += chunk_size) {
+      output.write(chunk.data(), chunk_size, ec);
+    }
+    output.close(ec);
+  }
+  state.SetBytesProcessed(state.iterations() * kStreamSize);
+}
+BENCHMARK(BM_write_stream_buffered)->Arg(4096)->Arg(65536)
+  ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_write_stream_direct(benchmark::State & state)
+{
+  const auto chunk_size = static_cast<size_t>(state.range(0));
+  const std::vector<char> chunk(chunk_size, 'c');
+  const temp_dir dir;
+  std::error_code ec;
+  for (auto _ : state) {
+    rcpputils::fs::direct_writer output(dir.file());
+    for (size_t written = 0; written < kStreamSize; written += chunk_size) {
+      output.write(chunk.data(), chunk_size, ec);
+    }
+    output.close(ec);
+  }
+  state.SetBytesProcessed(state.iterations() * kStreamSize);
+}
+BENCHMARK(BM_write_stream_direct)->Arg(4096)->Arg(65536)
+  ->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,691 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "rcpputils/directory_handle.hpp"
+#include "rcpputils/filesystem_helper.hpp"
+#include "rcpputils/glob.hpp"
+
+using path = rcpputils::fs::path;
+
+namespace
+{
+
+std::string build_deep_path(int depth)
+{
+  std::string p;
+  for (int i = 0; i < depth; ++i) {
+    p += "/component_" + std::to_string(i);
+  }
+  return p;
+}
+
+/// A temporary tree of directories holding empty files, removed on destruction.
+class test_tree
+{
+public:
+  test_tree(const std::string & name, int num_dirs, int files_per_dir)
+  : root_(rcpputils::fs::create_temp_directory(name))
+  {
+    for (int d = 0; d < num_dirs; ++d) {
+      const auto dir = root_ / ("dir_" + std::to_string(d));
+      rcpputils::fs::create_directories(dir);
+      for (int f = 0; f < files_per_dir; ++f) {
+        std::ofstream((dir / ("file_" + std::to_string(f))).string());
+      }
+    }
+  }
+
+  ~test_tree()
+  {
+    rcpputils::fs::remove_all(root_);
+  }
+
+  const path & root() const {return root_;}
+
+  /// Detach the tree from this object, for when the benchmark removes it.
+  path release()
+  {
+    return std::move(root_);
+  }
+
+private:
+  path root_;
+};
+
+/// A tree of 100 directories of 1000 files each, shared by all benchmarks.
+const path & large_tree()
+{
+  static const test_tree tree("benchmark_tree", 100, 1000);
+  return tree.root();
+}
+
+/// A file of the given size, filled with non-zero bytes, removed on destruction.
+class test_file
+{
+public:
+  test_file(const std::string & name, size_t size)
+  : dir_(rcpputils::fs::create_temp_directory(name)), path_(dir_ / "file.bin")
+  {
+    std::ofstream output_buffer{path_.string(), std::ios::binary};
+    const std::string block(1 << 20, 'x');
+    for (size_t written = 0; written < size; written += block.size()) {
+      output_buffer.write(block.data(), static_cast<std::streamsize>(block.size()));
+    }
+  }
+
+  ~test_file()
+  {
+    rcpputils::fs::remove_all(dir_);
+  }
+
+  const path & dir() const {return dir_;}
+  const path & file() const {return path_;}
+
+private:
+  path dir_;
+  path path_;
+};
+
+const char * strategy_name(rcpputils::fs::copy_strategy strategy)
+{
+  switch (strategy) {
+    case rcpputils::fs::copy_strategy::reflink: return "reflink";
+    case rcpputils::fs::copy_strategy::copy_file_range: return "copy_file_range";
+    case rcpputils::fs::copy_strategy::sendfile: return "sendfile";
+    case rcpputils::fs::copy_strategy::read_write: return "read_write";
+    default: return "none";
+  }
+}
+
+}  // namespace
+
+static void BM_construct_eager(benchmark::State & state)
+{
+  const auto str = build_deep_path(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    path p(str);
+    benchmark::DoNotOptimize(p);
+  }
+}
+BENCHMARK(BM_construct_eager)->Arg(4)->Arg(16)->Arg(64);
+
+static void BM_construct_deferred(benchmark::State & state)
+{
+  const auto str = build_deep_path(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    path p(str, rcpputils::fs::deferred_parse);
+    benchmark::DoNotOptimize(p);
+  }
+}
+BENCHMARK(BM_construct_deferred)->Arg(4)->Arg(16)->Arg(64);
+
+// Construct a path only to stat it once, which is the common case when scanning directories.
+static void BM_stat_only_eager(benchmark::State & state)
+{
+  const auto str = rcpputils::fs::temp_directory_path().string();
+  for (auto _ : state) {
+    path p(str);
+    benchmark::DoNotOptimize(p.is_directory());
+  }
+}
+BENCHMARK(BM_stat_only_eager);
+
+static void BM_stat_only_deferred(benchmark::State & state)
+{
+  const auto str = rcpputils::fs::temp_directory_path().string();
+  for (auto _ : state) {
+    path p(str, rcpputils::fs::deferred_parse);
+    benchmark::DoNotOptimize(p.is_directory());
+  }
+}
+BENCHMARK(BM_stat_only_deferred);
+
+static void BM_join_copy(benchmark::State & state)
+{
+  for (auto _ : state) {
+    path p("/root");
+    for (int i = 0; i < state.range(0); ++i) {
+      p = p / "component";
+    }
+    benchmark::DoNotOptimize(p);
+  }
+}
+BENCHMARK(BM_join_copy)->Arg(16);
+
+static void BM_join_move(benchmark::State & state)
+{
+  for (auto _ : state) {
+    path p("/root");
+    for (int i = 0; i < state.range(0); ++i) {
+      p = std::move(p) / "component";
+    }
+    benchmark::DoNotOptimize(p);
+  }
+}
+BENCHMARK(BM_join_move)->Arg(16);
+
+static void BM_parent_path(benchmark::State & state)
+{
+  const path p(build_deep_path(static_cast<int>(state.range(0))) + "/file.tar.gz");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(p.parent_path());
+  }
+}
+BENCHMARK(BM_parent_path)->Arg(4)->Arg(16)->Arg(64);
+
+static void BM_parent_path_view(benchmark::State & state)
+{
+  const path p(build_deep_path(static_cast<int>(state.range(0))) + "/file.tar.gz");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(p.parent_path_view());
+  }
+}
+BENCHMARK(BM_parent_path_view)->Arg(4)->Arg(16)->Arg(64);
+
+static void BM_extension(benchmark::State & state)
+{
+  const path p(build_deep_path(static_cast<int>(state.range(0))) + "/file.tar.gz");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(p.extension());
+  }
+}
+BENCHMARK(BM_extension)->Arg(4)->Arg(64);
+
+static void BM_extension_view(benchmark::State & state)
+{
+  const path p(build_deep_path(static_cast<int>(state.range(0))) + "/file.tar.gz");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(p.extension_view());
+  }
+}
+BENCHMARK(BM_extension_view)->Arg(4)->Arg(64);
+
+static void BM_remove_extension(benchmark::State & state)
+{
+  const path p(build_deep_path(static_cast<int>(state.range(0))) + "/file.tar.gz");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(rcpputils::fs::remove_extension(p, 2));
+  }
+}
+BENCHMARK(BM_remove_extension)->Arg(4)->Arg(64);
+
+static void BM_recursive_directory_iterator(benchmark::State & state)
+{
+  const auto & root = large_tree();
+  for (auto _ : state) {
+    size_t files = 0;
+    for (const auto & entry : rcpputils::fs::recursive_directory_iterator(root)) {
+      files += entry.is_regular_file() ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(files);
+  }
+}
+BENCHMARK(BM_recursive_directory_iterator)->Unit(benchmark::kMillisecond);
+
+static void BM_parallel_walk(benchmark::State & state)
+{
+  const auto & root = large_tree();
+  for (auto _ : state) {
+    std::atomic<size_t> files{0};
+    rcpputils::fs::parallel_walk(
+      root, [&files](const rcpputils::fs::directory_entry & entry) {
+        if (entry.is_regular_file()) {
+          ++files;
+        }
+        return rcpputils::fs::walk_action::proceed;
+      }, static_cast<size_t>(state.range(0)));
+    benchmark::DoNotOptimize(files.load());
+  }
+}
+BENCHMARK(BM_parallel_walk)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+#ifndef _WIN32
+// The hand-written walk that the iterators replace, with one stat per entry.
+static size_t count_files_with_stat(const std::string & dir_path)
+{
+  size_t files = 0;
+  DIR * dir = opendir(dir_path.c_str());
+  while (const struct dirent * entry = readdir(dir)) {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+      continue;
+    }
+    const auto entry_path = dir_path + "/" + entry->d_name;
+    struct stat stat_buffer;
+    if (stat(entry_path.c_str(), &stat_buffer) != 0) {
+      continue;
+    }
+    if (S_ISDIR(stat_buffer.st_mode)) {
+      files += count_files_with_stat(entry_path);
+    } else if (S_ISREG(stat_buffer.st_mode)) {
+      ++files;
+    }
+  }
+  closedir(dir);
+  return files;
+}
+
+static void BM_readdir_and_stat(benchmark::State & state)
+{
+  const auto & root = large_tree();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(count_files_with_stat(root.string()));
+  }
+}
+BENCHMARK(BM_readdir_and_stat)->Unit(benchmark::kMillisecond);
+#endif
+
+static void BM_remove_all(benchmark::State & state)
+{
+  const int files_per_dir = 1000;
+  const int num_dirs = static_cast<int>(state.range(0)) / files_per_dir;
+  for (auto _ : state) {
+    state.PauseTiming();
+    test_tree tree("benchmark_remove_all", num_dirs, files_per_dir);
+    const auto root = tree.release();
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(rcpputils::fs::remove_all(root));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_remove_all)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+static void BM_parallel_remove_all(benchmark::State & state)
+{
+  const int files_per_dir = 1000;
+  const int num_dirs = 10;
+  rcpputils::fs::parallel_options options;
+  options.num_threads = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    test_tree tree("benchmark_parallel_remove_all", num_dirs, files_per_dir);
+    const auto root = tree.release();
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(rcpputils::fs::remove_all(root, options));
+  }
+  state.SetItemsProcessed(state.iterations() * num_dirs * files_per_dir);
+}
+BENCHMARK(BM_parallel_remove_all)->Arg(1)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_copy_file(benchmark::State & state)
+{
+  const test_file source("benchmark_copy_file", static_cast<size_t>(state.range(0)) << 20);
+  const auto destination = source.dir() / "copy.bin";
+  rcpputils::fs::copy_strategy strategy = rcpputils::fs::copy_strategy::none;
+  for (auto _ : state) {
+    rcpputils::fs::copy_file(
+      source.file(), destination, rcpputils::fs::copy_options::overwrite_existing, strategy);
+  }
+  state.SetLabel(strategy_name(strategy));
+  state.SetBytesProcessed(state.iterations() * (state.range(0) << 20));
+}
+BENCHMARK(BM_copy_file)->Arg(64)->Unit(benchmark::kMillisecond);
+
+// The stream copy that copy_file() replaces.
+static void BM_copy_with_streams(benchmark::State & state)
+{
+  const test_file source("benchmark_copy_with_streams", static_cast<size_t>(state.range(0)) << 20);
+  const auto destination = source.dir() / "copy.bin";
+  for (auto _ : state) {
+    std::ifstream input_buffer{source.file().string(), std::ios::binary};
+    std::ofstream output_buffer{destination.string(), std::ios::binary | std::ios::trunc};
+    output_buffer << input_buffer.rdbuf();
+  }
+  state.SetBytesProcessed(state.iterations() * (state.range(0) << 20));
+}
+BENCHMARK(BM_copy_with_streams)->Arg(64)->Unit(benchmark::kMillisecond);
+
+static void BM_copy_tree(benchmark::State & state)
+{
+  const test_tree tree("benchmark_copy_tree", 10, 1000);
+  const auto target = rcpputils::fs::create_temp_directory("benchmark_copy_tree_target");
+  rcpputils::fs::parallel_options parallel;
+  parallel.num_threads = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    rcpputils::fs::copy(
+      tree.root(), target / "copy",
+      rcpputils::fs::copy_options::recursive | rcpputils::fs::copy_options::overwrite_existing,
+      parallel);
+  }
+  rcpputils::fs::remove_all(target);
+  state.SetItemsProcessed(state.iterations() * 10 * 1000);
+}
+BENCHMARK(BM_copy_tree)->Arg(1)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_atomic_write_each(benchmark::State & state)
+{
+  const auto dir = rcpputils::fs::create_temp_directory("benchmark_atomic_write");
+  const std::string data(4096, 'x');
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); ++i) {
+      rcpputils::fs::atomic_write(dir / ("file_" + std::to_string(i)), data);
+    }
+  }
+  rcpputils::fs::remove_all(dir);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_atomic_write_each)->Arg(16)->Unit(benchmark::kMillisecond);
+
+static void BM_atomic_write_batch(benchmark::State & state)
+{
+  const auto dir = rcpputils::fs::create_temp_directory("benchmark_atomic_write_batch");
+  const std::string data(4096, 'x');
+  for (auto _ : state) {
+    rcpputils::fs::atomic_write_batch batch;
+    for (int i = 0; i < state.range(0); ++i) {
+      batch.add(dir / ("file_" + std::to_string(i)), data);
+    }
+    batch.commit();
+  }
+  rcpputils::fs::remove_all(dir);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_atomic_write_batch)->Arg(16)->Unit(benchmark::kMillisecond);
+
+static void BM_read_file(benchmark::State & state)
+{
+  const test_file source("benchmark_read_file", static_cast<size_t>(state.range(0)) << 20);
+  rcpputils::fs::read_options options;
+  options.mmap_threshold = static_cast<uint64_t>(state.range(1)) << 20;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(rcpputils::fs::read_file(source.file(), options));
+  }
+  state.SetBytesProcessed(state.iterations() * (state.range(0) << 20));
+}
+BENCHMARK(BM_read_file)->Args({1, 0})->Args({64, 0})->Args({64, 1})->Unit(benchmark::kMillisecond);
+
+// The idiom that read_file() replaces.
+static void BM_read_file_stringstream(benchmark::State & state)
+{
+  const test_file source(
+    "benchmark_read_file_stringstream", static_cast<size_t>(state.range(0)) << 20);
+  for (auto _ : state) {
+    std::ifstream input_buffer{source.file().string(), std::ios::binary};
+    std::stringstream content;
+    content << input_buffer.rdbuf();
+    benchmark::DoNotOptimize(content.str());
+  }
+  state.SetBytesProcessed(state.iterations() * (state.range(0) << 20));
+}
+BENCHMARK(BM_read_file_stringstream)->Arg(1)->Arg(64)->Unit(benchmark::kMillisecond);
+
+static void BM_write_file(benchmark::State & state)
+{
+  const auto dir = rcpputils::fs::create_temp_directory("benchmark_write_file");
+  const std::string content(static_cast<size_t>(state.range(0)) << 20, 'x');
+  for (auto _ : state) {
+    rcpputils::fs::write_file(dir / "file.bin", content);
+  }
+  rcpputils::fs::remove_all(dir);
+  state.SetBytesProcessed(state.iterations() * (state.range(0) << 20));
+}
+BENCHMARK(BM_write_file)->Arg(1)->Arg(64)->Unit(benchmark::kMillisecond);
+
+static void BM_write_file_ofstream(benchmark::State & state)
+{
+  const auto dir = rcpputils::fs::create_temp_directory("benchmark_write_file_ofstream");
+  const std::string content(static_cast<size_t>(state.range(0)) << 20, 'x');
+  for (auto _ : state) {
+    std::ofstream output_buffer{(dir / "file.bin").string(), std::ios::binary};
+    output_buffer << content;
+  }
+  rcpputils::fs::remove_all(dir);
+  state.SetBytesProcessed(state.iterations() * (state.range(0) << 20));
+}
+BENCHMARK(BM_write_file_ofstream)->Arg(1)->Arg(64)->Unit(benchmark::kMillisecond);
+
+namespace
+{
+
+/// The paths of the files in the shared tree, along with those of its directories.
+const std::vector<path> & large_tree_paths()
+{
+  static const std::vector<path> paths = [] {
+      std::vector<path> result;
+      for (const auto & entry : rcpputils::fs::recursive_directory_iterator(large_tree())) {
+        result.push_back(entry.path());
+      }
+      return result;
+    }();
+  return paths;
+}
+
+/// A directory 16 levels below the temporary directory, holding 1000 empty files.
+const path & deep_directory()
+{
+  static const test_tree tree("benchmark_deep", 0, 0);
+  static const path directory = [] {
+      const auto result = path(tree.root().string() + build_deep_path(16));
+      rcpputils::fs::create_directories(result);
+      for (int f = 0; f < 1000; ++f) {
+        std::ofstream((result / ("file_" + std::to_string(f))).string());
+      }
+      return result;
+    }();
+  return directory;
+}
+
+/// Drop the page, dentry and inode caches, so the next queries have to hit the disk.
+bool drop_caches()
+{
+  std::ofstream drop_caches{"/proc/sys/vm/drop_caches"};
+  drop_caches << "3" << std::flush;
+  return drop_caches.good();
+}
+
+}  // namespace
+
+// The first argument is the number of threads used without io_uring, the second whether the
+// caches are dropped before each batch.
+static void BM_status_many(benchmark::State & state)
+{
+  const auto & paths = large_tree_paths();
+  rcpputils::fs::parallel_options options;
+  options.num_threads = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    if (state.range(1) != 0) {
+      state.PauseTiming();
+      if (!drop_caches()) {
+        state.SkipWithError("cannot drop the caches");
+        break;
+      }
+      state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(rcpputils::fs::status_many(paths, options));
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(paths.size()));
+}
+BENCHMARK(BM_status_many)->Args({1, 0})->Args({4, 0})->Args({4, 1})
+  ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_status_each(benchmark::State & state)
+{
+  const auto & paths = large_tree_paths();
+  for (auto _ : state) {
+    if (state.range(0) != 0) {
+      state.PauseTiming();
+      if (!drop_caches()) {
+        state.SkipWithError("cannot drop the caches");
+        break;
+      }
+      state.ResumeTiming();
+    }
+    std::vector<rcpputils::fs::file_status> statuses;
+    statuses.reserve(paths.size());
+    for (const auto & p : paths) {
+      statuses.push_back(rcpputils::fs::status(p));
+    }
+    benchmark::DoNotOptimize(statuses);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(paths.size()));
+}
+BENCHMARK(BM_status_each)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_glob_pattern_match(benchmark::State & state)
+{
+  const auto & paths = large_tree_paths();
+  const rcpputils::fs::glob_pattern pattern("**/dir_1?/file_*9");
+  for (auto _ : state) {
+    size_t matches = 0;
+    for (const auto & p : paths) {
+      matches += pattern.match(p) ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(matches);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(paths.size()));
+}
+BENCHMARK(BM_glob_pattern_match)->Unit(benchmark::kMillisecond);
+
+// The std::regex filter that glob_pattern replaces.
+static void BM_regex_match(benchmark::State & state)
+{
+  const auto & paths = large_tree_paths();
+  const std::regex pattern(".*/dir_1[^/]/file_[^/]*9");
+  for (auto _ : state) {
+    size_t matches = 0;
+    for (const auto & p : paths) {
+      matches += std::regex_match(p.native(), pattern) ? 1 : 0;
+    }
+    benchmark::DoNotOptimize(matches);
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(paths.size()));
+}
+BENCHMARK(BM_regex_match)->Unit(benchmark::kMillisecond);
+
+static void BM_glob(benchmark::State & state)
+{
+  const auto & root = large_tree();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(rcpputils::fs::glob(root, "dir_1?/file_*9"));
+  }
+}
+BENCHMARK(BM_glob)->Unit(benchmark::kMillisecond);
+
+// Listing the whole tree and filtering it, without pruning the directories that cannot match.
+static void BM_glob_without_pruning(benchmark::State & state)
+{
+  const auto & root = large_tree();
+  const rcpputils::fs::glob_pattern pattern("dir_1?/file_*9");
+  for (auto _ : state) {
+    std::vector<path> matches;
+    for (const auto & entry : rcpputils::fs::recursive_directory_iterator(root)) {
+      const auto relative = std::string_view(entry.path().native()).substr(root.native().size());
+      if (pattern.match(relative)) {
+        matches.push_back(entry.path());
+      }
+    }
+    benchmark::DoNotOptimize(matches);
+  }
+}
+BENCHMARK(BM_glob_without_pruning)->Unit(benchmark::kMillisecond);
+
+static void BM_canonical(benchmark::State & state)
+{
+  const auto & paths = large_tree_paths();
+  for (auto _ : state) {
+    for (const auto & p : paths) {
+      benchmark::DoNotOptimize(rcpputils::fs::canonical(p));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(paths.size()));
+}
+BENCHMARK(BM_canonical)->Unit(benchmark::kMillisecond);
+
+// A fresh cache each time, so resolving the directories is accounted for.
+static void BM_canonical_cache(benchmark::State & state)
+{
+  const auto & paths = large_tree_paths();
+  for (auto _ : state) {
+    rcpputils::fs::canonical_cache cache;
+    for (const auto & p : paths) {
+      benchmark::DoNotOptimize(cache.canonical(p));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(paths.size()));
+}
+BENCHMARK(BM_canonical_cache)->Unit(benchmark::kMillisecond);
+
+// Probing paths that mostly do not exist, as when searching a list of directories.
+static void BM_file_size_missing_throwing(benchmark::State & state)
+{
+  const auto missing = rcpputils::fs::temp_directory_path() / "missing" / "file.txt";
+  for (auto _ : state) {
+    try {
+      benchmark::DoNotOptimize(rcpputils::fs::file_size(missing));
+    } catch (const std::system_error & e) {
+      benchmark::DoNotOptimize(e.code());
+    }
+  }
+}
+BENCHMARK(BM_file_size_missing_throwing);
+
+static void BM_file_size_missing_error_code(benchmark::State & state)
+{
+  const auto missing = rcpputils::fs::temp_directory_path() / "missing" / "file.txt";
+  std::error_code ec;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(rcpputils::fs::file_size(missing, ec));
+    benchmark::DoNotOptimize(ec);
+  }
+}
+BENCHMARK(BM_file_size_missing_error_code);
+
+// Querying the entries of one deep directory, by their full path or relative to the directory.
+static void BM_status_deep_full_path(benchmark::State & state)
+{
+  std::vector<path> paths;
+  for (int f = 0; f < 1000; ++f) {
+    paths.push_back(deep_directory() / ("file_" + std::to_string(f)));
+  }
+  for (auto _ : state) {
+    for (const auto & p : paths) {
+      benchmark::DoNotOptimize(rcpputils::fs::status(p));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(paths.size()));
+}
+BENCHMARK(BM_status_deep_full_path)->Unit(benchmark::kMicrosecond);
+
+static void BM_status_deep_directory_handle(benchmark::State & state)
+{
+  std::vector<std::string> names;
+  for (int f = 0; f < 1000; ++f) {
+    names.push_back("file_" + std::to_string(f));
+  }
+  const rcpputils::fs::directory_handle directory(deep_directory());
+  for (auto _ : state) {
+    for (const auto & name : names) {
+      benchmark::DoNotOptimize(directory.status(name));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(names.size()));
+}
+BENCHMARK(BM_status_deep_directory_handle)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,116 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+#include "rcpputils/mapped_file.hpp"
+
+using path = rcpputils::fs::path;
+
+namespace
+{
+
+// Records written per iteration, growing the output as a recorder would
+constexpr size_t kNumRecords = 1 << 16;
+constexpr size_t kGrowthSize = 16 << 20;
+
+/// A temporary directory, removed on destruction.
+class temp_dir
+{
+public:
+  temp_dir()
+  : dir_(rcpputils::fs::create_temp_directory("benchmark_mapped_file"))
+  {
+  }
+
+  ~temp_dir()
+  {
+    rcpputils::fs::remove_all(dir_);
+  }
+
+  path file() const {return dir_ / "records.bin";}
+
+private:
+  path dir_;
+};
+
+}  // namespace
+
+static void BM_write_records_mapped(benchmark::State & state)
+{
+  const auto record_size = static_cast<size_t>(state.range(0));
+  const std::vector<char> record(record_size, 'r');
+  const temp_dir dir;
+  for (auto _ : state) {
+    rcpputils::fs::mapped_file output(
+      dir.file(), rcpputils::fs::map_mode::read_write, 0, kGrowthSize);
+    size_t used = 0;
+    for (size_t i = 0; i < kNumRecords; ++i) {
+      if (used + record_size > output.size()) {
+        output.resize(output.size() + kGrowthSize);
+      }
+      std::memcpy(output.mutable_data() + used, record.data(), record_size);
+      used += record_size;
+    }
+    output.resize(used);
+  }
+  state.SetBytesProcessed(state.iterations() * kNumRecords * record_size);
+}
+BENCHMARK(BM_write_records_mapped)->Arg(64)->Arg(1024)->Unit(benchmark::kMillisecond);
+
+// The buffered stdio output that the mapped file replaces.
+static void BM_write_records_buffered(benchmark::State & state)
+{
+  const auto record_size = static_cast<size_t>(state.range(0));
+  const std::vector<char> record(record_size, 'r');
+  const temp_dir dir;
+  for (auto _ : state) {
+    std::FILE * output = std::fopen(dir.file().string().c_str(), "wb");
+    for (size_t i = 0; i < kNumRecords; ++i) {
+      std::fwrite(record.data(), 1, record_size, output);
+    }
+    std::fclose(output);
+  }
+  state.SetBytesProcessed(state.iterations() * kNumRecords * record_size);
+}
+BENCHMARK(BM_write_records_buffered)->Arg(64)->Arg(1024)->Unit(benchmark::kMillisecond);
+
+#ifndef _WIN32
+// One write() syscall per record.
+static void BM_write_records_syscall(benchmark::State & state)
+{
+  const auto record_size = static_cast<size_t>(state.range(0));
+  const std::vector<char> record(record_size, 'r');
+  const temp_dir dir;
+  for (auto _ : state) {
+    const int fd = open(dir.file().string().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    for (size_t i = 0; i < kNumRecords; ++i) {
+      benchmark::DoNotOptimize(write(fd, record.data(), record_size));
+    }
+    close(fd);
+  }
+  state.SetBytesProcessed(state.iterations() * kNumRecords * record_size);
+}
+BENCHMARK(BM_write_records_syscall)->Arg(64)->Arg(1024)->Unit(benchmark::kMillisecond);
+#endif
@@ -0,0 +1,120 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "rcpputils/direct_writer.hpp"
+#include "rcpputils/filesystem_helper.hpp"
+
+using rcpputils::fs::direct_writer;
+using rcpputils::fs::direct_writer_options;
+using rcpputils::fs::path;
+
+class TestDirectWriter : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    dir_ = rcpputils::fs::create_temp_directory("direct_writer");
+    file_ = dir_ / "records.bin";
+  }
+
+  void TearDown() override
+  {
+    rcpputils::fs::remove_all(dir_);
+  }
+
+  path dir_;
+  path file_;
+};
+
+#ifndef _WIN32
+
+TEST_F(TestDirectWriter, write) {
+  direct_writer_options options;
+  options.buffer_size = 8192;
+  options.num_buffers = 3;
+  direct_writer writer(file_, options);
+  ASSERT_TRUE(writer.is_open());
+  const size_t alignment = writer.alignment();
+  EXPECT_NE(0u, alignment);
+  EXPECT_EQ(0u, alignment & (alignment - 1));
+
+  // Records of various sizes, some spanning several buffers, ending within a block
+  std::string expected;
+  std::error_code ec;
+  for (int i = 0; i < 100; ++i) {
+    const std::string record(static_cast<size_t>(i * 397 % 20000), static_cast<char>('a' + i % 26));
+    EXPECT_EQ(record.size(), writer.write(record.data(), record.size(), ec));
+    EXPECT_FALSE(ec);
+    expected += record;
+  }
+  ASSERT_NE(0u, expected.size() % alignment);
+  EXPECT_EQ(expected.size(), writer.size());
+
+  writer.close();
+  EXPECT_FALSE(writer.is_open());
+  EXPECT_EQ(expected.size(), rcpputils::fs::file_size(file_));
+  EXPECT_EQ(expected, rcpputils::fs::read_file(file_));
+
+  EXPECT_EQ(0u, writer.write("x", 1, ec));
+  EXPECT_EQ(std::errc::bad_file_descriptor, ec);
+  writer.close(ec);
+  EXPECT_FALSE(ec);
+}
+
+TEST_F(TestDirectWriter, aligned_and_empty) {
+  {
+    direct_writer writer(file_);
+    const std::string block(writer.alignment() * 3, 'b');
+    std::error_code ec;
+    EXPECT_EQ(block.size(), writer.write(block.data(), block.size(), ec));
+    writer.close();
+    EXPECT_EQ(block, rcpputils::fs::read_file(file_));
+  }
+  {
+    direct_writer writer(file_);
+  }
+  EXPECT_EQ(0u, rcpputils::fs::file_size(file_));
+}
+
+TEST_F(TestDirectWriter, move) {
+  direct_writer writer(file_);
+  std::error_code ec;
+  writer.write("abc", 3, ec);
+  direct_writer moved(std::move(writer));
+  EXPECT_FALSE(writer.is_open());  // NOLINT(bugprone-use-after-move)
+  EXPECT_EQ(0u, writer.write("x", 1, ec));  // NOLINT(bugprone-use-after-move)
+  EXPECT_EQ(std::errc::bad_file_descriptor, ec);
+  moved.write("def", 3, ec);
+  moved.close();
+  EXPECT_EQ("abcdef", rcpputils::fs::read_file(file_));
+}
+
+TEST_F(TestDirectWriter, errors) {
+  direct_writer_options options;
+  options.num_buffers = 1;
+  EXPECT_THROW(direct_writer(file_, options), std::invalid_argument);
+  options.num_buffers = 2;
+  options.alignment = 3000;
+  EXPECT_THROW(direct_writer(file_, options), std::invalid_argument);
+  EXPECT_THROW(direct_writer(dir_ / "missing" / "file"), std::system_error);
+}
+
+#endif
@@ -0,0 +1,202 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "rcpputils/directory_handle.hpp"
+#include "rcpputils/filesystem_helper.hpp"
+
+#ifndef _WIN32
+#  include <unistd.h>
+#endif
+
+using rcpputils::fs::directory_handle;
+using rcpputils::fs::file_type;
+using rcpputils::fs::path;
+
+class TestDirectoryHandle : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    dir_ = rcpputils::fs::create_temp_directory("directory_handle");
+    rcpputils::fs::write_file(dir_ / "file.txt", std::string_view("content"));
+    ASSERT_TRUE(rcpputils::fs::create_directories(dir_ / "sub"));
+  }
+
+  void TearDown() override
+  {
+    rcpputils::fs::remove_all(dir_);
+  }
+
+  path dir_;
+};
+
+#ifndef _WIN32
+
+TEST_F(TestDirectoryHandle, open) {
+  directory_handle none;
+  EXPECT_FALSE(none.is_open());
+  EXPECT_EQ(-1, none.native_handle());
+
+  directory_handle handle(dir_);
+  ASSERT_TRUE(handle.is_open());
+  EXPECT_GE(handle.native_handle(), 0);
+  EXPECT_EQ(dir_, handle.path());
+
+  const auto sub = handle.open("sub");
+  ASSERT_TRUE(sub.is_open());
+  EXPECT_EQ(dir_ / "sub", sub.path());
+  EXPECT_THROW(handle.open("file.txt"), std::system_error);
+  EXPECT_THROW(handle.open("missing"), std::system_error);
+  EXPECT_THROW(directory_handle(dir_ / "missing"), std::system_error);
+
+  std::error_code ec;
+  const directory_handle missing(dir_ / "missing", ec);
+  EXPECT_EQ(std::errc::no_such_file_or_directory, ec);
+  EXPECT_FALSE(missing.is_open());
+  const auto not_directory = handle.open("file.txt", ec);
+  EXPECT_EQ(std::errc::not_a_directory, ec);
+  EXPECT_FALSE(not_directory.is_open());
+
+  directory_handle moved(std::move(handle));
+  EXPECT_TRUE(moved.is_open());
+  EXPECT_FALSE(handle.is_open());  // NOLINT(bugprone-use-after-move)
+  moved.close();
+  EXPECT_FALSE(moved.is_open());
+  EXPECT_FALSE(moved.exists("file.txt", ec));
+  EXPECT_EQ(std::errc::bad_file_descriptor, ec);
+}
+
+TEST_F(TestDirectoryHandle, status) {
+  const directory_handle handle(dir_);
+  const auto file_status = handle.status("file.txt");
+  EXPECT_EQ(file_type::regular, file_status.type());
+  EXPECT_EQ(7u, file_status.size());
+  EXPECT_EQ(rcpputils::fs::status(dir_ / "file.txt").inode(), file_status.inode());
+  EXPECT_EQ(file_type::directory, handle.status("sub").type());
+  EXPECT_EQ(file_type::not_found, handle.status("missing").type());
+  EXPECT_EQ(file_type::not_found, handle.status("file.txt/missing").type());
+
+  std::error_code ec = std::make_error_code(std::errc::io_error);
+  EXPECT_EQ(file_type::not_found, handle.status("missing", ec).type());
+  EXPECT_FALSE(ec);
+
+  EXPECT_TRUE(handle.exists("file.txt"));
+  EXPECT_TRUE(handle.exists("sub"));
+  EXPECT_FALSE(handle.exists("missing"));
+  EXPECT_FALSE(handle.exists("missing", ec));
+  EXPECT_FALSE(ec);
+}
+
+TEST_F(TestDirectoryHandle, symlink_status) {
+  const directory_handle handle(dir_);
+  ASSERT_EQ(0, symlinkat("file.txt", handle.native_handle(), "link"));
+  ASSERT_EQ(0, symlinkat("missing", handle.native_handle(), "dangling"));
+  EXPECT_EQ(file_type::regular, handle.status("link").type());
+  EXPECT_EQ(file_type::symlink, handle.symlink_status("link").type());
+  EXPECT_EQ(file_type::not_found, handle.status("dangling").type());
+  EXPECT_EQ(file_type::symlink, handle.symlink_status("dangling").type());
+}
+
+TEST_F(TestDirectoryHandle, create_and_remove) {
+  const directory_handle handle(dir_);
+  EXPECT_TRUE(handle.create_directory("new"));
+  EXPECT_TRUE(rcpputils::fs::is_directory(dir_ / "new"));
+  EXPECT_FALSE(handle.create_directory("new"));
+  EXPECT_TRUE(handle.create_directory("new/nested"));
+  EXPECT_THROW(handle.create_directory("file.txt"), std::system_error);
+  EXPECT_THROW(handle.create_directory("missing/nested"), std::system_error);
+
+  std::error_code ec;
+  EXPECT_FALSE(handle.create_directory("file.txt", ec));
+  EXPECT_EQ(std::errc::not_a_directory, ec);
+
+  EXPECT_THROW(handle.remove("new"), std::system_error);
+  EXPECT_TRUE(handle.remove("new/nested"));
+  EXPECT_TRUE(handle.remove("new"));
+  EXPECT_TRUE(handle.remove("file.txt"));
+  EXPECT_FALSE(handle.remove("file.txt"));
+  EXPECT_FALSE(handle.remove("missing", ec));
+  EXPECT_FALSE(ec);
+  EXPECT_FALSE(rcpputils::fs::exists(dir_ / "new"));
+  EXPECT_FALSE(rcpputils::fs::exists(dir_ / "file.txt"));
+}
+
+TEST_F(TestDirectoryHandle, rename) {
+  const directory_handle handle(dir_);
+  handle.rename("file.txt", "renamed.txt");
+  EXPECT_FALSE(handle.exists("file.txt"));
+  EXPECT_EQ("content", rcpputils::fs::read_file(dir_ / "renamed.txt"));
+
+  const auto sub = handle.open("sub");
+  handle.rename("renamed.txt", sub, "moved.txt");
+  EXPECT_FALSE(handle.exists("renamed.txt"));
+  EXPECT_EQ("content", rcpputils::fs::read_file(dir_ / "sub" / "moved.txt"));
+
+  EXPECT_THROW(handle.rename("missing", "other"), std::system_error);
+  std::error_code ec;
+  handle.rename("missing", sub, "other", ec);
+  EXPECT_EQ(std::errc::no_such_file_or_directory, ec);
+}
+
+TEST_F(TestDirectoryHandle, list) {
+  const directory_handle handle(dir_);
+  rcpputils::fs::write_file(dir_ / "sub" / "nested.txt", std::string_view("nested"));
+  auto entries = handle.list();
+  std::sort(
+    entries.begin(), entries.end(), [](const auto & a, const auto & b) {
+      return a.path().string() < b.path().string();
+    });
+  ASSERT_EQ(2u, entries.size());
+  EXPECT_EQ(dir_ / "file.txt", entries[0].path());
+  EXPECT_TRUE(entries[0].is_regular_file());
+  EXPECT_EQ(dir_ / "sub", entries[1].path());
+  EXPECT_TRUE(entries[1].is_directory());
+
+  const auto sub_entries = handle.open("sub").list();
+  ASSERT_EQ(1u, sub_entries.size());
+  EXPECT_EQ(dir_ / "sub" / "nested.txt", sub_entries[0].path());
+
+  std::error_code ec;
+  EXPECT_TRUE(directory_handle().list(ec).empty());
+  EXPECT_EQ(std::errc::bad_file_descriptor, ec);
+}
+
+TEST_F(TestDirectoryHandle, follows_moved_directory) {
+  const directory_handle handle(dir_ / "sub");
+  ASSERT_EQ(0, std::rename((dir_ / "sub").string().c_str(), (dir_ / "moved").string().c_str()));
+  EXPECT_TRUE(handle.create_directory("created"));
+  EXPECT_TRUE(rcpputils::fs::is_directory(dir_ / "moved" / "created"));
+  EXPECT_FALSE(rcpputils::fs::exists(dir_ / "sub"));
+}
+
+#else
+
+TEST_F(TestDirectoryHandle, not_supported) {
+  std::error_code ec;
+  const directory_handle handle(dir_, ec);
+  EXPECT_EQ(std::errc::function_not_supported, ec);
+  EXPECT_FALSE(handle.is_open());
+  EXPECT_THROW(directory_handle{dir_}, std::system_error);
+}
+
+#endif
@@ -0,0 +1,199 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "rcpputils/file.hpp"
+#include "rcpputils/filesystem_helper.hpp"
+
+using rcpputils::fs::const_buffer;
+using rcpputils::fs::file;
+using rcpputils::fs::file_advice;
+using rcpputils::fs::mutable_buffer;
+using rcpputils::fs::open_flags;
+using rcpputils::fs::path;
+
+class TestFile : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    dir_ = rcpputils::fs::create_temp_directory("file");
+    file_ = dir_ / "data.bin";
+  }
+
+  void TearDown() override
+  {
+    rcpputils::fs::remove_all(dir_);
+  }
+
+  path dir_;
+  path file_;
+};
+
+#ifndef _WIN32
+
+TEST_F(TestFile, open) {
+  file none;
+  EXPECT_FALSE(none.is_open());
+  EXPECT_EQ(-1, none.native_handle());
+
+  EXPECT_THROW(file{file_}, std::system_error);
+  std::error_code ec;
+  none.open(file_, open_flags::read, ec);
+  EXPECT_EQ(std::errc::no_such_file_or_directory, ec);
+  EXPECT_FALSE(none.is_open());
+  none.open(file_, open_flags::create, ec);
+  EXPECT_EQ(std::errc::invalid_argument, ec);
+
+  file created(file_, open_flags::write | open_flags::create | open_flags::exclusive);
+  EXPECT_TRUE(created.is_open());
+  EXPECT_TRUE(rcpputils::fs::exists(file_));
+  EXPECT_THROW(
+    file(file_, open_flags::write | open_flags::create | open_flags::exclusive),
+    std::system_error);
+
+  file moved(std::move(created));
+  EXPECT_TRUE(moved.is_open());
+  EXPECT_FALSE(created.is_open());  // NOLINT(bugprone-use-after-move)
+  moved.close(ec);
+  EXPECT_FALSE(ec);
+  EXPECT_FALSE(moved.is_open());
+
+  const char byte = 'x';
+  EXPECT_EQ(0u, moved.write(&byte, 1, ec));
+  EXPECT_EQ(std::errc::bad_file_descriptor, ec);
+}
+
+TEST_F(TestFile, read_write) {
+  std::error_code ec;
+  file output(file_, open_flags::write | open_flags::create | open_flags::truncate);
+  EXPECT_EQ(5u, output.write("hello", 5, ec));
+  EXPECT_FALSE(ec);
+  EXPECT_EQ(6u, output.write(" world", 6, ec));
+  EXPECT_EQ(11u, output.size(ec));
+  EXPECT_EQ(5u, output.pwrite("HELLO", 5, 0, ec));
+  EXPECT_FALSE(ec);
+
+  file input(file_);
+  char buffer[16] = {};
+  EXPECT_EQ(5u, input.pread(buffer, 5, 6, ec));
+  EXPECT_FALSE(ec);
+  EXPECT_EQ("world", std::string(buffer, 5));
+  // Reading past the end stops there, without an error
+  EXPECT_EQ(11u, input.read(buffer, sizeof(buffer), ec));
+  EXPECT_FALSE(ec);
+  EXPECT_EQ("HELLO world", std::string(buffer, 11));
+  EXPECT_EQ(0u, input.read(buffer, sizeof(buffer), ec));
+  EXPECT_FALSE(ec);
+  EXPECT_EQ(0u, input.pread(buffer, sizeof(buffer), 100, ec));
+  EXPECT_FALSE(ec);
+
+  EXPECT_EQ(0u, input.write("x", 1, ec));
+  EXPECT_EQ(std::errc::bad_file_descriptor, ec);
+
+  file append(file_, open_flags::write | open_flags::append);
+  EXPECT_EQ(1u, append.write("!", 1, ec));
+  EXPECT_EQ("HELLO world!", rcpputils::fs::read_file(file_));
+}
+
+TEST_F(TestFile, vectored) {
+  std::error_code ec;
+  file output(file_, open_flags::read_write | open_flags::create);
+  const std::string header = "head";
+  const std::string payload(100000, 'p');
+  const std::string trailer = "tail";
+  EXPECT_EQ(
+    header.size() + payload.size() + trailer.size(),
+    output.writev(
+      {{header.data(), header.size()}, {nullptr, 0}, {payload.data(), payload.size()},
+        {trailer.data(), trailer.size()}}, ec));
+  EXPECT_FALSE(ec);
+  EXPECT_EQ(header + payload + trailer, rcpputils::fs::read_file(file_));
+
+  // More buffers than passed to a single call
+  std::vector<std::string> parts;
+  std::vector<const_buffer> buffers;
+  std::string expected;
+  for (int i = 0; i < 200; ++i) {
+    parts.push_back(std::to_string(i) + ",");
+    expected += parts.back();
+  }
+  for (const auto & part : parts) {
+    buffers.push_back({part.data(), part.size()});
+  }
+  EXPECT_EQ(expected.size(), output.pwritev(buffers.data(), buffers.size(), 4, ec));
+  EXPECT_FALSE(ec);
+  output.resize(4 + expected.size(), ec);
+
+  std::string first(4, '\0');
+  std::string second(expected.size(), '\0');
+  std::string rest(10, '\0');
+  EXPECT_EQ(
+    4u + expected.size(),
+    output.preadv(
+      std::vector<mutable_buffer>{{first.data(), first.size()}, {second.data(), second.size()},
+        {rest.data(), rest.size()}}.data(), 3, 0, ec));
+  EXPECT_FALSE(ec);
+  EXPECT_EQ("head", first);
+  EXPECT_EQ(expected, second);
+
+  file input(file_);
+  std::string a(2, '\0');
+  std::string b(3, '\0');
+  EXPECT_EQ(5u, input.readv({{a.data(), a.size()}, {b.data(), b.size()}}, ec));
+  EXPECT_EQ("he", a);
+  EXPECT_EQ("ad0", b);
+}
+
+TEST_F(TestFile, allocate_resize_sync) {
+  std::error_code ec;
+  file output(file_, open_flags::write | open_flags::create);
+  output.allocate(0, 1 << 20, ec);
+#ifndef __APPLE__
+  EXPECT_FALSE(ec);
+  EXPECT_EQ(1u << 20, output.size(ec));
+#endif
+  output.resize(10, ec);
+  EXPECT_FALSE(ec);
+  EXPECT_EQ(10u, output.size(ec));
+  output.sync_data(ec);
+  EXPECT_FALSE(ec);
+  output.sync(ec);
+  EXPECT_FALSE(ec);
+  output.advise(file_advice::dontneed);
+
+  file none;
+  none.sync_data(ec);
+  EXPECT_EQ(std::errc::bad_file_descriptor, ec);
+  EXPECT_EQ(static_cast<uint64_t>(-1), none.size(ec));
+  EXPECT_FALSE(none.advise(file_advice::sequential));
+}
+
+#else
+
+TEST_F(TestFile, not_supported) {
+  std::error_code ec;
+  file f;
+  f.open(file_, open_flags::write | open_flags::create, ec);
+  EXPECT_EQ(std::errc::function_not_supported, ec);
+  EXPECT_FALSE(f.is_open());
+}
+
+#endif
@@ -14,8 +14,21 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <mutex>
+#include <set>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "rcpputils/filesystem_helper.hpp"
 #include "rcpputils/env.hpp"
@@ -23,6 +36,9 @@
 #ifdef _WIN32
 static constexpr const bool is_win32 = true;
 #else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 static constexpr const bool is_win32 = false;
 #endif
 
@@ -77,6 +93,49 @@ TEST(TestFilesystemHelper, join_path)
   }
 }
 
+TEST(TestFilesystemHelper, construct_and_move)
+{
+  const std::string expected = is_win32 ? "foo\\bar" : "foo/bar";
+  EXPECT_EQ(path(std::string_view("foo/bar")).string(), expected);
+  EXPECT_EQ(path("foo/bar").string(), expected);
+  EXPECT_EQ(path(std::string("foo/bar")).string(), expected);
+
+  path p("foo/bar");
+  const std::string & native = p.native();
+  EXPECT_EQ(native, expected);
+  EXPECT_EQ(&native, &p.native());
+
+  path moved(std::move(p));
+  EXPECT_EQ(moved.string(), expected);
+  EXPECT_EQ(std::vector<std::string>(moved.cbegin(), moved.cend()),
+    std::vector<std::string>({"foo", "bar"}));
+
+  path assigned;
+  assigned = std::move(moved);
+  EXPECT_EQ(assigned.string(), expected);
+}
+
+TEST(TestFilesystemHelper, join_rvalue_path)
+{
+  path p("foo");
+  for (int i = 0; i < 3; ++i) {
+    p = std::move(p) / std::to_string(i);
+  }
+  p = std::move(p) / "bar" / path("baz");
+  const auto expected = path("foo") / "0" / "1" / "2" / "bar" / "baz";
+  EXPECT_EQ(p, expected);
+  EXPECT_EQ(std::vector<std::string>(p.cbegin(), p.cend()),
+    std::vector<std::string>({"foo", "0", "1", "2", "bar", "baz"}));
+
+  // Separators of the appended string are normalized and absolute strings replace the path
+  p /= std::string("qux\\quux");
+  EXPECT_EQ(*--p.cend(), "quux");
+  p /= "/abs/olute";
+  EXPECT_EQ(p, path("/abs/olute"));
+  EXPECT_EQ(std::vector<std::string>(p.cbegin(), p.cend()),
+    std::vector<std::string>({"", "abs", "olute"}));
+}
+
 TEST(TestFilesystemHelper, parent_path)
 {
   {
@@ -123,6 +182,85 @@ TEST(TestFilesystemHelper, parent_path)
   }
 }
 
+TEST(TestFilesystemHelper, iterate_components)
+{
+  auto components = [](const path & p) {
+      return std::vector<std::string>(p.cbegin(), p.cend());
+    };
+  EXPECT_EQ(components(path("")), std::vector<std::string>{});
+  EXPECT_EQ(components(path("foo")), std::vector<std::string>({"foo"}));
+  EXPECT_EQ(components(path("foo/bar/")), std::vector<std::string>({"foo", "bar"}));
+  EXPECT_EQ(components(path("/foo//bar")), std::vector<std::string>({"", "foo", "", "bar"}));
+  EXPECT_EQ(components(path("/")), std::vector<std::string>({""}));
+
+  auto p = path("foo") / "bar" / path("baz/qux");
+  EXPECT_EQ(components(p), std::vector<std::string>({"foo", "bar", "baz", "qux"}));
+
+  // Copies own their storage, so iterating a copy must not refer to the original
+  path copy;
+  {
+    const path original = path("a") / "b";
+    copy = original;
+  }
+  EXPECT_EQ(components(copy), std::vector<std::string>({"a", "b"}));
+  EXPECT_EQ(*--copy.cend(), "b");
+}
+
+TEST(TestFilesystemHelper, deferred_parse)
+{
+  const path eager("foo\\bar/baz");
+  const path deferred("foo\\bar/baz", rcpputils::fs::deferred_parse);
+  EXPECT_EQ(eager.string(), deferred.string());
+  EXPECT_EQ(eager, deferred);
+  EXPECT_EQ(std::vector<std::string>(deferred.cbegin(), deferred.cend()),
+    std::vector<std::string>(eager.cbegin(), eager.cend()));
+
+  EXPECT_EQ(path("foo/bar", rcpputils::fs::deferred_parse).filename().string(), "bar");
+  EXPECT_EQ(path("foo/bar", rcpputils::fs::deferred_parse).parent_path().string(), "foo");
+  EXPECT_TRUE(path(".", rcpputils::fs::deferred_parse).exists());
+
+  // Mixing parsed and unparsed paths keeps the components consistent
+  auto parsed_lhs = path("foo") / path("bar/baz", rcpputils::fs::deferred_parse);
+  EXPECT_EQ(std::vector<std::string>(parsed_lhs.cbegin(), parsed_lhs.cend()),
+    std::vector<std::string>({"foo", "bar", "baz"}));
+  auto deferred_lhs = path("foo", rcpputils::fs::deferred_parse) / path("bar/baz");
+  EXPECT_EQ(std::vector<std::string>(deferred_lhs.cbegin(), deferred_lhs.cend()),
+    std::vector<std::string>({"foo", "bar", "baz"}));
+}
+
+TEST(TestFilesystemHelper, deferred_parse_shared)
+{
+  // The first iteration of a const path parses it, while other threads iterate or copy it
+  const std::vector<std::string> expected({"foo", "bar", "baz", "qux"});
+  for (int round = 0; round < 50; ++round) {
+    const path shared("foo/bar/baz/qux", rcpputils::fs::deferred_parse);
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+      threads.emplace_back([&shared, &expected, &mismatches, i] {
+          // Half of the threads copy the path before it is parsed, the others after
+          path copy;
+          if (i % 2 == 0) {
+            copy = shared;
+          }
+          if (std::vector<std::string>(shared.cbegin(), shared.cend()) != expected) {
+            ++mismatches;
+          }
+          if (i % 2 != 0) {
+            copy = shared;
+          }
+          if (std::vector<std::string>(copy.cbegin(), copy.cend()) != expected) {
+            ++mismatches;
+          }
+        });
+    }
+    for (auto & thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(mismatches.load(), 0);
+  }
+}
+
 TEST(TestFilesystemHelper, to_native_path)
 {
   {
@@ -237,6 +375,46 @@ TEST(TestFilesystemHelper, correct_extension)
   }
 }
 
+TEST(TestFilesystemHelper, path_views)
+{
+  const path p("/foo/bar/baz.tar.gz");
+  const std::string expected_parent = is_win32 ? "\\foo\\bar" : "/foo/bar";
+  EXPECT_EQ(p.parent_path_view(), expected_parent);
+  EXPECT_EQ(p.filename_view(), "baz.tar.gz");
+  EXPECT_EQ(p.stem_view(), "baz.tar");
+  EXPECT_EQ(p.extension_view(), ".gz");
+  EXPECT_EQ(p.stem().string(), "baz.tar");
+
+  // Views point into the path itself
+  EXPECT_GE(p.filename_view().data(), p.native().data());
+  EXPECT_LE(
+    p.filename_view().data() + p.filename_view().size(), p.native().data() + p.native().size());
+
+  EXPECT_EQ(path("foo").parent_path_view(), "");
+  EXPECT_EQ(path("foo/bar/").parent_path_view(), "foo");
+  EXPECT_EQ(path("foo/bar/").filename_view(), "bar");
+  EXPECT_EQ(path("").filename_view(), "");
+  EXPECT_EQ(path("").extension_view(), "");
+}
+
+TEST(TestFilesystemHelper, behaviour_change_extension_only_in_filename)
+{
+  EXPECT_EQ(path("foo.d/bar").extension_view(), "");
+  EXPECT_EQ(path("foo.d/bar").extension().string(), "");
+  EXPECT_EQ(path("foo.d/bar").stem_view(), "bar");
+  EXPECT_EQ(path("foo/..").extension_view(), "");
+  EXPECT_EQ(path("foo.").extension_view(), ".");
+}
+
+TEST(TestFilesystemHelper, behaviour_change_dotfile_has_no_extension)
+{
+  EXPECT_EQ(path(".bashrc").extension_view(), "");
+  EXPECT_EQ(path(".bashrc").extension().string(), "");
+  EXPECT_EQ(path(".bashrc").stem_view(), ".bashrc");
+  EXPECT_EQ(path("foo/.bashrc.bak").extension_view(), ".bak");
+  EXPECT_EQ(rcpputils::fs::remove_extension(path(".bashrc")).string(), ".bashrc");
+}
+
 TEST(TestFilesystemHelper, is_empty)
 {
   auto p_no_arg = path();
@@ -370,6 +548,805 @@ TEST(TestFilesystemHelper, filesystem_manipulation)
   EXPECT_FALSE(rcpputils::fs::create_directories(rcpputils::fs::path("")));
 }
 
+TEST(TestFilesystemHelper, create_directories_error_code)
+{
+  const auto root = rcpputils::fs::create_temp_directory("create_directories");
+  const auto deep = root / "a" / "b" / "c";
+
+  std::error_code ec;
+  EXPECT_TRUE(rcpputils::fs::create_directories(deep, ec));
+  EXPECT_FALSE(ec);
+  EXPECT_TRUE(rcpputils::fs::is_directory(deep));
+
+  // Existing directories are reported apart from created ones
+  EXPECT_FALSE(rcpputils::fs::create_directories(deep, ec));
+  EXPECT_FALSE(ec);
+  EXPECT_FALSE(rcpputils::fs::create_directories(root / "a" / "b/", ec));
+  EXPECT_FALSE(ec);
+
+  // Only the missing suffix is created, separators may repeat
+  EXPECT_TRUE(rcpputils::fs::create_directories(root / "a" / "d//e/", ec));
+  EXPECT_FALSE(ec);
+  EXPECT_TRUE(rcpputils::fs::is_directory(root / "a" / "d" / "e"));
+
+  const auto file = root / "file.txt";
+  {
+    std::ofstream output_buffer{file.string()};
+    output_buffer << "test";
+  }
+  EXPECT_FALSE(rcpputils::fs::create_directories(file, ec));
+  EXPECT_EQ(ec, std::errc::not_a_directory);
+  EXPECT_FALSE(rcpputils::fs::create_directories(file / "sub", ec));
+  EXPECT_EQ(ec, std::errc::not_a_directory);
+
+  EXPECT_FALSE(rcpputils::fs::create_directories(path(""), ec));
+  EXPECT_TRUE(ec);
+
+  EXPECT_TRUE(rcpputils::fs::remove_all(root));
+}
+
+TEST(TestFilesystemHelper, error_code_overloads)
+{
+  std::error_code ec;
+  const auto root = rcpputils::fs::create_temp_directory(
+    "error_code", rcpputils::fs::temp_directory_path(ec), ec);
+  ASSERT_FALSE(ec);
+  const auto missing = root / "missing";
+  const auto file = root / "file.txt";
+  rcpputils::fs::write_file(file, "content", ec);
+  ASSERT_FALSE(ec);
+
+  // A missing path is not a failure for probes
+  EXPECT_EQ(rcpputils::fs::status(missing, ec).type(), rcpputils::fs::file_type::not_found);
+  EXPECT_FALSE(ec);
+  EXPECT_FALSE(rcpputils::fs::exists(missing, ec));
+  EXPECT_FALSE(ec);
+  EXPECT_TRUE(rcpputils::fs::exists(file, ec));
+  EXPECT_FALSE(ec);
+  EXPECT_FALSE(rcpputils::fs::remove(missing, ec));
+  EXPECT_FALSE(ec);
+  EXPECT_FALSE(rcpputils::fs::remove_all(missing, ec));
+  EXPECT_FALSE(ec);
+  EXPECT_TRUE(rcpputils::fs::is_regular_file(file, ec));
+  EXPECT_FALSE(ec);
+  EXPECT_TRUE(rcpputils::fs::is_directory(root, ec));
+  EXPECT_FALSE(ec);
+  EXPECT_FALSE(rcpputils::fs::is_directory(missing, ec));
+  EXPECT_FALSE(ec);
+  EXPECT_FALSE(rcpputils::fs::is_symlink(file, ec));
+  EXPECT_FALSE(ec);
+#ifndef _WIN32
+  // Unlike a missing path, a loop of symlinks cannot be queried
+  const auto loop = root / "loop";
+  ASSERT_EQ(0, symlink(loop.string().c_str(), loop.string().c_str()));
+  EXPECT_TRUE(rcpputils::fs::is_symlink(loop, ec));
+  EXPECT_FALSE(ec);
+  EXPECT_FALSE(rcpputils::fs::is_regular_file(loop / "file", ec));
+  EXPECT_EQ(ec, std::errc::too_many_symbolic_link_levels);
+  EXPECT_FALSE(rcpputils::fs::is_directory(loop, ec));
+  EXPECT_EQ(ec, std::errc::too_many_symbolic_link_levels);
+  EXPECT_FALSE(rcpputils::fs::is_symlink(loop / "file", ec));
+  EXPECT_EQ(ec, std::errc::too_many_symbolic_link_levels);
+  ASSERT_TRUE(rcpputils::fs::remove(loop));
+#endif
+
+  EXPECT_EQ(rcpputils::fs::file_size(file, ec), 7u);
+  EXPECT_FALSE(ec);
+  EXPECT_EQ(rcpputils::fs::file_size(missing, ec), static_cast<uint64_t>(-1));
+  EXPECT_EQ(ec, std::errc::no_such_file_or_directory);
+  EXPECT_EQ(rcpputils::fs::file_size(root, ec), static_cast<uint64_t>(-1));
+  EXPECT_EQ(ec, std::errc::is_a_directory);
+  EXPECT_EQ(rcpputils::fs::read_file(file, {}, ec), "content");
+  EXPECT_FALSE(ec);
+  EXPECT_TRUE(rcpputils::fs::read_file(missing, {}, ec).empty());
+  EXPECT_EQ(ec, std::errc::no_such_file_or_directory);
+  rcpputils::fs::write_file(missing / "file.txt", "content", ec);
+  EXPECT_EQ(ec, std::errc::no_such_file_or_directory);
+  rcpputils::fs::atomic_write(missing / "file.txt", "content", rcpputils::fs::durability::none, ec);
+  EXPECT_EQ(ec, std::errc::no_such_file_or_directory);
+  EXPECT_TRUE(rcpputils::fs::canonical(missing, ec).empty());
+  EXPECT_EQ(ec, std::errc::no_such_file_or_directory);
+  rcpputils::fs::canonical_cache cache;
+  EXPECT_TRUE(cache.canonical(missing / "file.txt", ec).empty());
+  EXPECT_EQ(ec, std::errc::no_such_file_or_directory);
+  EXPECT_EQ(cache.canonical(file, ec), rcpputils::fs::canonical(file));
+  EXPECT_FALSE(ec);
+  EXPECT_FALSE(rcpputils::fs::current_path(ec).empty());
+  EXPECT_FALSE(ec);
+  EXPECT_TRUE(rcpputils::fs::create_temp_directory("sub", file, ec).empty());
+  EXPECT_EQ(ec, std::errc::not_a_directory);
+
+  // Iterators become the end iterator on failure
+  rcpputils::fs::directory_iterator it(missing, rcpputils::fs::directory_options::none, ec);
+  EXPECT_EQ(ec, std::errc::no_such_file_or_directory);
+  EXPECT_EQ(it, rcpputils::fs::directory_iterator());
+  rcpputils::fs::recursive_directory_iterator recursive(
+    root, rcpputils::fs::directory_options::none, ec);
+  ASSERT_FALSE(ec);
+  ASSERT_NE(recursive, rcpputils::fs::recursive_directory_iterator());
+  EXPECT_EQ(recursive->path(), file);
+  recursive.increment(ec);
+  EXPECT_FALSE(ec);
+  EXPECT_EQ(recursive, rcpputils::fs::recursive_directory_iterator());
+  EXPECT_FALSE(
+    rcpputils::fs::parallel_walk(
+      missing, [](const rcpputils::fs::directory_entry &) {
+        return rcpputils::fs::walk_action::proceed;
+      }, 1, rcpputils::fs::directory_options::none, ec));
+  EXPECT_EQ(ec, std::errc::no_such_file_or_directory);
+
+  EXPECT_FALSE(
+    rcpputils::fs::copy_file(missing, root / "copy.txt", rcpputils::fs::copy_options::none, ec));
+  EXPECT_EQ(ec, std::errc::no_such_file_or_directory);
+  EXPECT_FALSE(
+    rcpputils::fs::copy_file(file, file, rcpputils::fs::copy_options::overwrite_existing, ec));
+  EXPECT_EQ(ec, std::errc::file_exists);
+  rcpputils::fs::copy(missing, root / "copy", rcpputils::fs::copy_options::recursive, {}, ec);
+  EXPECT_EQ(ec, std::errc::no_such_file_or_directory);
+
+  // Removing a directory with content is a failure, unless removing it all
+  EXPECT_FALSE(rcpputils::fs::remove(root, ec));
+  EXPECT_EQ(ec, std::errc::directory_not_empty);
+  rcpputils::fs::remove_all_stats stats;
+  EXPECT_TRUE(rcpputils::fs::remove_all(root, stats, ec));
+  EXPECT_FALSE(ec);
+  EXPECT_EQ(stats.entries, 2u);
+}
+
+TEST(TestFilesystemHelper, read_and_write_file)
+{
+  const auto dir = rcpputils::fs::create_temp_directory("read_file");
+  const auto file = dir / "data.bin";
+
+  std::string content(100000, '\0');
+  for (size_t i = 0; i < content.size(); ++i) {
+    content[i] = static_cast<char>(i % 256);
+  }
+  rcpputils::fs::write_file(file, content);
+  EXPECT_EQ(rcpputils::fs::file_size(file), content.size());
+  EXPECT_EQ(rcpputils::fs::read_file(file), content);
+
+  rcpputils::fs::read_options options;
+  options.sequential = false;
+  options.no_atime = true;
+  options.mmap_threshold = 4096;
+  EXPECT_EQ(rcpputils::fs::read_file(file, options), content);
+
+  // Reads capped below the size carry on until the end
+  rcpputils::fs::read_options capped;
+  capped.max_read_size = 4093;
+  EXPECT_EQ(rcpputils::fs::read_file(file, capped), content);
+  capped.max_read_size = 7;
+  EXPECT_EQ(rcpputils::fs::read_file_bytes(file, capped).size(), content.size());
+
+  const auto bytes = rcpputils::fs::read_file_bytes(file);
+  ASSERT_EQ(bytes.size(), content.size());
+  EXPECT_EQ(0, std::memcmp(bytes.data(), content.data(), content.size()));
+
+  // Writing truncates longer content
+  rcpputils::fs::write_file(file, std::vector<std::byte>(3, std::byte{'a'}));
+  EXPECT_EQ(rcpputils::fs::read_file(file), "aaa");
+  rcpputils::fs::write_file(file, "");
+  EXPECT_EQ(rcpputils::fs::read_file(file), "");
+
+#ifdef __linux__
+  // Files that report no size are read all the same
+  EXPECT_FALSE(rcpputils::fs::read_file("/proc/self/status").empty());
+#endif
+
+  EXPECT_THROW(rcpputils::fs::read_file(dir / "missing"), std::system_error);
+  EXPECT_THROW(rcpputils::fs::read_file(dir), std::system_error);
+  EXPECT_THROW(rcpputils::fs::write_file(dir / "missing" / "file", "data"), std::system_error);
+
+  EXPECT_TRUE(rcpputils::fs::remove_all(dir));
+}
+
+TEST(TestFilesystemHelper, atomic_write)
+{
+  const auto dir = rcpputils::fs::create_temp_directory("atomic_write");
+  const auto file = dir / "config.yaml";
+  auto read = [](const path & p) {
+      std::ifstream input_buffer{p.string()};
+      return std::string(std::istreambuf_iterator<char>(input_buffer), {});
+    };
+
+  rcpputils::fs::atomic_write(file, "first");
+  EXPECT_EQ(read(file), "first");
+  rcpputils::fs::atomic_write(file, "second", rcpputils::fs::durability::data);
+  EXPECT_EQ(read(file), "second");
+  rcpputils::fs::atomic_write(file, "", rcpputils::fs::durability::none);
+  EXPECT_EQ(read(file), "");
+
+  // A failed write leaves the file alone
+  EXPECT_THROW(
+    rcpputils::fs::atomic_write(dir / "missing" / "file", "content"), std::system_error);
+  EXPECT_THROW(rcpputils::fs::atomic_write(dir, "content"), std::system_error);
+
+#ifndef _WIN32
+  // Replacing a file keeps its permissions
+  ASSERT_EQ(0, chmod(file.string().c_str(), 0600));
+  rcpputils::fs::atomic_write(file, "private");
+  EXPECT_EQ(read(file), "private");
+  struct stat stat_buffer;
+  ASSERT_EQ(0, stat(file.string().c_str(), &stat_buffer));
+  EXPECT_EQ(stat_buffer.st_mode & 07777, 0600u);
+#endif
+
+  {
+    rcpputils::fs::atomic_write_batch batch;
+    batch.add(dir / "a.txt", "a");
+    batch.add(dir / "b.txt", "b");
+    EXPECT_FALSE(rcpputils::fs::exists(dir / "a.txt"));
+    batch.commit();
+    EXPECT_EQ(read(dir / "a.txt"), "a");
+    EXPECT_EQ(read(dir / "b.txt"), "b");
+
+    // Uncommitted files are discarded
+    batch.add(dir / "c.txt", "c");
+  }
+  EXPECT_FALSE(rcpputils::fs::exists(dir / "c.txt"));
+
+  // Only the written files are left, no temporary one
+  size_t num_entries = 0;
+  for (const auto & entry : rcpputils::fs::directory_iterator(dir)) {
+    (void)entry;
+    ++num_entries;
+  }
+  EXPECT_EQ(num_entries, 3u);
+
+  EXPECT_TRUE(rcpputils::fs::remove_all(dir));
+}
+
+TEST(TestFilesystemHelper, status)
+{
+  const auto dir = rcpputils::fs::create_temp_directory("status");
+  const auto file = dir / "test_file.txt";
+  {
+    std::ofstream output_buffer{file.string()};
+    output_buffer << "test";
+  }
+
+  const auto before = std::chrono::system_clock::now() - std::chrono::hours(1);
+  const auto file_status = rcpputils::fs::status(file);
+  EXPECT_EQ(file_status.type(), rcpputils::fs::file_type::regular);
+  EXPECT_TRUE(rcpputils::fs::exists(file_status));
+  EXPECT_TRUE(rcpputils::fs::is_regular_file(file_status));
+  EXPECT_FALSE(rcpputils::fs::is_directory(file_status));
+  EXPECT_EQ(rcpputils::fs::file_size(file_status), 4u);
+  EXPECT_NE(
+    file_status.permissions() & rcpputils::fs::perms::owner_read, rcpputils::fs::perms::none);
+  EXPECT_GT(file_status.last_write_time(), before);
+
+  const auto dir_status = rcpputils::fs::status(dir);
+  EXPECT_TRUE(rcpputils::fs::is_directory(dir_status));
+  EXPECT_THROW(rcpputils::fs::file_size(dir_status), std::system_error);
+  EXPECT_EQ(dir_status.device(), file_status.device());
+  if (!is_win32) {
+    EXPECT_NE(dir_status.inode(), file_status.inode());
+  }
+
+  const auto missing_status = rcpputils::fs::status(dir / "missing");
+  EXPECT_EQ(missing_status.type(), rcpputils::fs::file_type::not_found);
+  EXPECT_TRUE(rcpputils::fs::status_known(missing_status));
+  EXPECT_FALSE(rcpputils::fs::exists(missing_status));
+  EXPECT_THROW(rcpputils::fs::file_size(missing_status), std::system_error);
+  EXPECT_FALSE(rcpputils::fs::status_known(rcpputils::fs::file_status()));
+
+#ifndef _WIN32
+  const auto link = dir / "link";
+  ASSERT_EQ(0, symlink(file.string().c_str(), link.string().c_str()));
+  EXPECT_TRUE(rcpputils::fs::is_regular_file(rcpputils::fs::status(link)));
+  EXPECT_TRUE(rcpputils::fs::is_symlink(rcpputils::fs::symlink_status(link)));
+  EXPECT_TRUE(rcpputils::fs::is_symlink(link));
+  EXPECT_FALSE(rcpputils::fs::is_symlink(file));
+#endif
+
+  EXPECT_TRUE(rcpputils::fs::remove_all(dir));
+}
+
+/**
+ * Create the tree:
+ *  root/a.txt
+ *  root/sub/b.txt
+ *  root/sub/deeper/c.txt
+ *  root/link -> sub (if symlinks are available)
+ */
+static path create_test_tree(const std::string & base_name)
+{
+  const auto root = rcpputils::fs::create_temp_directory(base_name);
+  EXPECT_TRUE(rcpputils::fs::create_directories(root / "sub" / "deeper"));
+  for (const auto & file : {root / "a.txt", root / "sub" / "b.txt", root / "sub/deeper/c.txt"}) {
+    std::ofstream output_buffer{file.string()};
+    output_buffer << "test";
+  }
+#ifndef _WIN32
+  EXPECT_EQ(0, symlink((root / "sub").string().c_str(), (root / "link").string().c_str()));
+#endif
+  return root;
+}
+
+TEST(TestFilesystemHelper, status_many)
+{
+  const auto root = create_test_tree("status_many");
+  std::vector<path> paths = {
+    root, root / "a.txt", root / "sub", root / "sub" / "deeper" / "c.txt", root / "missing",
+    root / "a.txt" / "not_a_directory", path("")};
+#ifndef _WIN32
+  paths.push_back(root / "link");
+#endif
+
+  // Few paths are queried in place, many are batched
+  for (const size_t copies : {1, 10}) {
+    std::vector<path> batch;
+    for (size_t i = 0; i < copies; ++i) {
+      batch.insert(batch.end(), paths.begin(), paths.end());
+    }
+    const auto statuses = rcpputils::fs::status_many(batch);
+    ASSERT_EQ(statuses.size(), batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+      const auto expected = rcpputils::fs::status(batch[i]);
+      EXPECT_EQ(statuses[i].type(), expected.type()) << batch[i];
+      EXPECT_EQ(statuses[i].size(), expected.size()) << batch[i];
+      EXPECT_EQ(statuses[i].inode(), expected.inode()) << batch[i];
+      EXPECT_EQ(statuses[i].device(), expected.device()) << batch[i];
+      EXPECT_EQ(statuses[i].permissions(), expected.permissions()) << batch[i];
+      EXPECT_EQ(statuses[i].last_write_time(), expected.last_write_time()) << batch[i];
+    }
+  }
+  EXPECT_TRUE(rcpputils::fs::status_many({}).empty());
+
+  EXPECT_TRUE(rcpputils::fs::remove_all(root));
+}
+
+TEST(TestFilesystemHelper, directory_iterator)
+{
+  const auto root = create_test_tree("directory_iterator");
+
+  std::set<std::string> names;
+  for (const auto & entry : rcpputils::fs::directory_iterator(root)) {
+    names.insert(entry.path().filename().string());
+    EXPECT_EQ(entry.path().parent_path(), root);
+    if (entry.path().filename_view() == "a.txt") {
+      EXPECT_EQ(entry.type(), rcpputils::fs::file_type::regular);
+      EXPECT_TRUE(entry.is_regular_file());
+      EXPECT_EQ(entry.status().size(), 4u);
+    } else if (entry.path().filename_view() == "sub") {
+      EXPECT_EQ(entry.type(), rcpputils::fs::file_type::directory);
+      EXPECT_TRUE(entry.is_directory());
+    } else {
+      EXPECT_TRUE(entry.is_symlink());
+      EXPECT_TRUE(entry.is_directory());
+      EXPECT_TRUE(rcpputils::fs::is_symlink(entry.symlink_status()));
+    }
+  }
+  std::set<std::string> expected_names{"a.txt", "sub"};
+  if (!is_win32) {
+    expected_names.insert("link");
+  }
+  EXPECT_EQ(names, expected_names);
+
+  // Files cannot be iterated
+  EXPECT_THROW(rcpputils::fs::directory_iterator(root / "a.txt"), std::system_error);
+
+  EXPECT_TRUE(rcpputils::fs::remove_all(root));
+}
+
+TEST(TestFilesystemHelper, directory_iterator_errors)
+{
+  EXPECT_THROW(rcpputils::fs::directory_iterator(path("some") / "nonsense"), std::system_error);
+  EXPECT_THROW(
+    rcpputils::fs::recursive_directory_iterator(path("some") / "nonsense"), std::system_error);
+
+  // An empty directory yields no entry
+  const auto root = rcpputils::fs::create_temp_directory("directory_iterator_errors");
+  EXPECT_EQ(rcpputils::fs::directory_iterator(root), rcpputils::fs::directory_iterator());
+  EXPECT_TRUE(rcpputils::fs::remove_all(root));
+}
+
+TEST(TestFilesystemHelper, recursive_directory_iterator)
+{
+  const auto root = create_test_tree("recursive_directory_iterator");
+  const auto relative = [&root](const path & p) {
+      return p.string().substr(root.string().size() + 1);
+    };
+
+  std::set<std::string> names;
+  for (auto it = rcpputils::fs::recursive_directory_iterator(root);
+    it != rcpputils::fs::recursive_directory_iterator(); ++it)
+  {
+    names.insert(relative(it->path()));
+    EXPECT_EQ(it.depth(), static_cast<int>(std::distance(it->path().cbegin(), it->path().cend())) -
+      static_cast<int>(std::distance(root.cbegin(), root.cend())) - 1);
+  }
+  std::set<std::string> expected_names{
+    "a.txt", "sub", (path("sub") / "b.txt").string(), (path("sub") / "deeper").string(),
+    (path("sub") / "deeper" / "c.txt").string()};
+  if (!is_win32) {
+    expected_names.insert("link");
+  }
+  EXPECT_EQ(names, expected_names);
+
+  if (!is_win32) {
+    names.clear();
+    const auto options = rcpputils::fs::directory_options::follow_directory_symlink;
+    for (const auto & entry : rcpputils::fs::recursive_directory_iterator(root, options)) {
+      names.insert(relative(entry.path()));
+    }
+    EXPECT_EQ(names.count("link/deeper/c.txt"), 1u);
+    EXPECT_EQ(names.size(), expected_names.size() + 3);
+  }
+
+  // Don't enter directories with recursion disabled, and leave them with pop
+  names.clear();
+  for (auto it = rcpputils::fs::recursive_directory_iterator(root);
+    it != rcpputils::fs::recursive_directory_iterator(); ++it)
+  {
+    if (it->path().filename_view() == "deeper") {
+      it.disable_recursion_pending();
+    }
+    names.insert(relative(it->path()));
+  }
+  EXPECT_EQ(names.count((path("sub") / "deeper" / "c.txt").string()), 0u);
+  EXPECT_EQ(names.count((path("sub") / "deeper").string()), 1u);
+
+  auto it = rcpputils::fs::recursive_directory_iterator(root);
+  while (it != rcpputils::fs::recursive_directory_iterator() && it.depth() == 0) {
+    ++it;
+  }
+  if (it != rcpputils::fs::recursive_directory_iterator()) {
+    it.pop();
+    EXPECT_TRUE(
+      it == rcpputils::fs::recursive_directory_iterator() || it.depth() == 0);
+  }
+
+#ifndef _WIN32
+  // Permissions are not enforced for the superuser
+  if (geteuid() != 0) {
+    const auto locked = root / "sub" / "deeper";
+    ASSERT_EQ(0, chmod(locked.string().c_str(), 0));
+    const auto iterate_all = [&root]() {
+        auto it = rcpputils::fs::recursive_directory_iterator(root);
+        while (it != rcpputils::fs::recursive_directory_iterator()) {
+          ++it;
+        }
+      };
+    EXPECT_THROW(iterate_all(), std::system_error);
+    names.clear();
+    const auto options = rcpputils::fs::directory_options::skip_permission_denied;
+    for (const auto & entry : rcpputils::fs::recursive_directory_iterator(root, options)) {
+      names.insert(relative(entry.path()));
+    }
+    EXPECT_EQ(names.count((path("sub") / "deeper").string()), 1u);
+    ASSERT_EQ(0, chmod(locked.string().c_str(), 0755));
+  }
+#endif
+
+  EXPECT_TRUE(rcpputils::fs::remove_all(root));
+}
+
+TEST(TestFilesystemHelper, parallel_walk)
+{
+  const auto root = create_test_tree("parallel_walk");
+  const auto relative = [&root](const path & p) {
+      return p.string().substr(root.string().size() + 1);
+    };
+
+  std::set<std::string> expected_names{
+    "a.txt", "sub", (path("sub") / "b.txt").string(), (path("sub") / "deeper").string(),
+    (path("sub") / "deeper" / "c.txt").string()};
+  if (!is_win32) {
+    expected_names.insert("link");
+  }
+
+  for (size_t num_threads : {1u, 4u}) {
+    std::mutex mutex;
+    std::set<std::string> names;
+    const bool completed = rcpputils::fs::parallel_walk(
+      root, [&](const rcpputils::fs::directory_entry & entry) {
+        std::lock_guard<std::mutex> lock(mutex);
+        names.insert(relative(entry.path()));
+        return rcpputils::fs::walk_action::proceed;
+      }, num_threads);
+    EXPECT_TRUE(completed);
+    EXPECT_EQ(names, expected_names);
+  }
+
+  // Skipping a subtree
+  {
+    std::mutex mutex;
+    std::set<std::string> names;
+    EXPECT_TRUE(
+      rcpputils::fs::parallel_walk(
+        root, [&](const rcpputils::fs::directory_entry & entry) {
+          std::lock_guard<std::mutex> lock(mutex);
+          names.insert(relative(entry.path()));
+          return entry.path().filename_view() == "deeper" ?
+          rcpputils::fs::walk_action::skip_subtree : rcpputils::fs::walk_action::proceed;
+        }));
+    EXPECT_EQ(names.count((path("sub") / "deeper").string()), 1u);
+    EXPECT_EQ(names.count((path("sub") / "deeper" / "c.txt").string()), 0u);
+  }
+
+  // Following symlinks
+  if (!is_win32) {
+    std::atomic<size_t> count{0};
+    EXPECT_TRUE(
+      rcpputils::fs::parallel_walk(
+        root, [&](const rcpputils::fs::directory_entry &) {
+          ++count;
+          return rcpputils::fs::walk_action::proceed;
+        }, 2, rcpputils::fs::directory_options::follow_directory_symlink));
+    EXPECT_EQ(count, expected_names.size() + 3);
+  }
+
+  // Cancelling
+  {
+    std::atomic<size_t> count{0};
+    EXPECT_FALSE(
+      rcpputils::fs::parallel_walk(
+        root, [&](const rcpputils::fs::directory_entry &) {
+          ++count;
+          return rcpputils::fs::walk_action::stop;
+        }, 1));
+    EXPECT_EQ(count, 1u);
+  }
+
+  // Errors
+  EXPECT_THROW(
+    rcpputils::fs::parallel_walk(
+      root, [](const rcpputils::fs::directory_entry &) -> rcpputils::fs::walk_action {
+        throw std::runtime_error("visitor error");
+      }, 2), std::runtime_error);
+  EXPECT_THROW(
+    rcpputils::fs::parallel_walk(
+      root / "missing", [](const rcpputils::fs::directory_entry &) {
+        return rcpputils::fs::walk_action::proceed;
+      }), std::system_error);
+
+  EXPECT_TRUE(rcpputils::fs::remove_all(root));
+}
+
+TEST(TestFilesystemHelper, remove_all_stats)
+{
+  const auto target = rcpputils::fs::create_temp_directory("remove_all_target");
+  {
+    std::ofstream output_buffer{(target / "kept.txt").string()};
+    output_buffer << "kept";
+  }
+
+  const auto root = create_test_tree("remove_all_stats");
+#ifndef _WIN32
+  // A symlink to a directory outside of the tree must not be followed
+  ASSERT_EQ(0, symlink(target.string().c_str(), (root / "outside").string().c_str()));
+#endif
+
+  rcpputils::fs::remove_all_stats stats;
+  EXPECT_TRUE(rcpputils::fs::remove_all(root, stats));
+  EXPECT_FALSE(rcpputils::fs::exists(root));
+  // root, a.txt, sub, b.txt, deeper, c.txt and the two symlinks
+  EXPECT_EQ(stats.entries, is_win32 ? 6u : 8u);
+  EXPECT_EQ(stats.bytes, 12u);
+
+  EXPECT_TRUE(rcpputils::fs::exists(target / "kept.txt"));
+
+  // A single file
+  stats = rcpputils::fs::remove_all_stats();
+  EXPECT_TRUE(rcpputils::fs::remove_all(target / "kept.txt", stats));
+  EXPECT_EQ(stats.entries, 1u);
+  EXPECT_EQ(stats.bytes, 4u);
+
+  stats = rcpputils::fs::remove_all_stats();
+  EXPECT_FALSE(rcpputils::fs::remove_all(target / "missing", stats));
+  EXPECT_EQ(stats.entries, 0u);
+
+  EXPECT_TRUE(rcpputils::fs::remove_all(target));
+}
+
+TEST(TestFilesystemHelper, parallel_remove_all)
+{
+  const auto target = rcpputils::fs::create_temp_directory("parallel_remove_all_target");
+  {
+    std::ofstream output_buffer{(target / "kept.txt").string()};
+    output_buffer << "kept";
+  }
+
+  const auto root = create_test_tree("parallel_remove_all");
+#ifndef _WIN32
+  ASSERT_EQ(0, symlink(target.string().c_str(), (root / "outside").string().c_str()));
+#endif
+  // Enough directories to keep several workers busy
+  for (int i = 0; i < 20; ++i) {
+    const auto directory = root / ("dir" + std::to_string(i));
+    ASSERT_TRUE(rcpputils::fs::create_directories(directory / "nested"));
+    std::ofstream output_buffer{(directory / "nested" / "file.txt").string()};
+    output_buffer << "test";
+  }
+
+  rcpputils::fs::parallel_options options;
+  options.num_threads = 4;
+  auto report = rcpputils::fs::remove_all(root, options);
+  EXPECT_TRUE(report.success());
+  EXPECT_FALSE(rcpputils::fs::exists(root));
+  // The test tree, plus three entries per directory created above
+  EXPECT_EQ(report.entries, (is_win32 ? 6u : 8u) + 60u);
+  EXPECT_TRUE(rcpputils::fs::exists(target / "kept.txt"));
+
+  // A single file
+  report = rcpputils::fs::remove_all(target / "kept.txt", options);
+  EXPECT_TRUE(report.success());
+  EXPECT_EQ(report.entries, 1u);
+
+  report = rcpputils::fs::remove_all(target / "missing", options);
+  EXPECT_FALSE(report.success());
+  EXPECT_EQ(report.entries, 0u);
+  ASSERT_EQ(report.errors.size(), 1u);
+  EXPECT_EQ(report.errors[0].target, target / "missing");
+  EXPECT_EQ(report.errors[0].error, std::errc::no_such_file_or_directory);
+
+#ifndef _WIN32
+  // The content goes, but rmdir() refuses a path ending with ".", which has to be reported
+  ASSERT_TRUE(rcpputils::fs::create_directories(target / "dot" / "nested"));
+  report = rcpputils::fs::remove_all(target / "dot" / ".", options);
+  EXPECT_FALSE(report.success());
+  ASSERT_FALSE(report.errors.empty());
+  for (const auto & error : report.errors) {
+    EXPECT_TRUE(error.error);
+    EXPECT_NE(error.error.value(), 0);
+  }
+  EXPECT_FALSE(rcpputils::fs::exists(target / "dot" / "nested"));
+  EXPECT_TRUE(rcpputils::fs::remove(target / "dot"));
+
+  // Root can remove anything, regardless of permissions
+  if (geteuid() != 0) {
+    const auto locked = create_test_tree("parallel_remove_all_locked");
+    ASSERT_EQ(0, chmod((locked / "sub" / "deeper").string().c_str(), 0500));
+    report = rcpputils::fs::remove_all(locked, options);
+    ASSERT_EQ(report.errors.size(), 1u);
+    EXPECT_EQ(report.errors[0].target, locked / "sub" / "deeper" / "c.txt");
+    EXPECT_EQ(report.errors[0].error, std::errc::permission_denied);
+    // Everything else is removed, but the ancestors of the locked file are kept
+    EXPECT_TRUE(rcpputils::fs::exists(locked / "sub" / "deeper" / "c.txt"));
+    EXPECT_FALSE(rcpputils::fs::exists(locked / "a.txt"));
+    EXPECT_FALSE(rcpputils::fs::exists(locked / "sub" / "b.txt"));
+    ASSERT_EQ(0, chmod((locked / "sub" / "deeper").string().c_str(), 0700));
+    EXPECT_TRUE(rcpputils::fs::remove_all(locked));
+  }
+#endif
+
+  EXPECT_TRUE(rcpputils::fs::remove_all(target));
+}
+
+TEST(TestFilesystemHelper, parallel_remove_all_concurrent)
+{
+  // Entries removed by someone else meanwhile are not failures
+  for (int round = 0; round < 10; ++round) {
+    const auto root = create_test_tree("parallel_remove_all_concurrent");
+    for (int i = 0; i < 20; ++i) {
+      const auto directory = root / ("dir" + std::to_string(i));
+      ASSERT_TRUE(rcpputils::fs::create_directories(directory / "nested"));
+      for (int j = 0; j < 5; ++j) {
+        std::ofstream output_buffer{(directory / "nested" / std::to_string(j)).string()};
+        output_buffer << "test";
+      }
+    }
+
+    rcpputils::fs::parallel_options options;
+    options.num_threads = 4;
+    rcpputils::fs::remove_all_report reports[2];
+    std::thread other([&] {reports[1] = rcpputils::fs::remove_all(root, options);});
+    reports[0] = rcpputils::fs::remove_all(root, options);
+    other.join();
+    EXPECT_FALSE(rcpputils::fs::exists(root));
+    for (const auto & report : reports) {
+      for (const auto & error : report.errors) {
+        // Only a root already removed before starting is reported as missing
+        EXPECT_EQ(error.target, root);
+        EXPECT_EQ(error.error, std::errc::no_such_file_or_directory);
+      }
+    }
+  }
+}
+
+TEST(TestFilesystemHelper, copy_file)
+{
+  using rcpputils::fs::copy_options;
+  const auto dir = rcpputils::fs::create_temp_directory("copy_file");
+  const auto from = dir / "from.txt";
+  const auto to = dir / "to.txt";
+  auto write = [](const path & p, const std::string & content) {
+      std::ofstream output_buffer{p.string()};
+      output_buffer << content;
+    };
+  auto read = [](const path & p) {
+      std::ifstream input_buffer{p.string()};
+      return std::string(std::istreambuf_iterator<char>(input_buffer), {});
+    };
+  // Larger than the buffer of the read and write loop
+  const std::string content(3 << 20, 'x');
+  write(from, content);
+
+  rcpputils::fs::copy_strategy strategy;
+  EXPECT_TRUE(rcpputils::fs::copy_file(from, to, copy_options::none, strategy));
+  EXPECT_NE(strategy, rcpputils::fs::copy_strategy::none);
+  EXPECT_EQ(read(to), content);
+
+  EXPECT_THROW(rcpputils::fs::copy_file(from, to), std::system_error);
+  EXPECT_FALSE(rcpputils::fs::copy_file(from, to, copy_options::skip_existing, strategy));
+  EXPECT_EQ(strategy, rcpputils::fs::copy_strategy::none);
+
+  // Overwriting with shorter content truncates the destination
+  write(from, "short");
+  EXPECT_TRUE(rcpputils::fs::copy_file(from, to, copy_options::overwrite_existing));
+  EXPECT_EQ(read(to), "short");
+
+  EXPECT_THROW(
+    rcpputils::fs::copy_file(from, from, copy_options::overwrite_existing), std::system_error);
+  EXPECT_EQ(read(from), "short");
+  EXPECT_THROW(rcpputils::fs::copy_file(dir, dir / "copy"), std::system_error);
+  EXPECT_THROW(rcpputils::fs::copy_file(dir / "missing", dir / "copy"), std::system_error);
+
+#ifndef _WIN32
+  // Go back in time, so that a fresh copy would not match
+  const struct timespec times[2] = {{0, UTIME_OMIT}, {1000000000, 0}};
+  ASSERT_EQ(0, utimensat(AT_FDCWD, from.string().c_str(), times, 0));
+  EXPECT_TRUE(
+    rcpputils::fs::copy_file(
+      from, to, copy_options::overwrite_existing | copy_options::preserve_last_write_time));
+  EXPECT_EQ(
+    rcpputils::fs::status(to).last_write_time(), rcpputils::fs::status(from).last_write_time());
+#endif
+
+  EXPECT_TRUE(rcpputils::fs::remove_all(dir));
+}
+
+TEST(TestFilesystemHelper, copy)
+{
+  using rcpputils::fs::copy_options;
+  const auto root = create_test_tree("copy");
+  const auto target = rcpputils::fs::create_temp_directory("copy_target");
+  auto read = [](const path & p) {
+      std::ifstream input_buffer{p.string()};
+      return std::string(std::istreambuf_iterator<char>(input_buffer), {});
+    };
+
+  rcpputils::fs::parallel_options parallel;
+  parallel.num_threads = 4;
+  // Smaller than two files, so that they are copied one at a time
+  parallel.max_bytes_in_flight = 6;
+  rcpputils::fs::copy(root, target / "tree", copy_options::recursive, parallel);
+  EXPECT_EQ(read(target / "tree" / "a.txt"), "test");
+  EXPECT_EQ(read(target / "tree" / "sub" / "b.txt"), "test");
+  EXPECT_EQ(read(target / "tree" / "sub" / "deeper" / "c.txt"), "test");
+#ifndef _WIN32
+  EXPECT_TRUE(rcpputils::fs::is_symlink(target / "tree" / "link"));
+  EXPECT_EQ(read(target / "tree" / "link" / "b.txt"), "test");
+#endif
+
+  // Copying again needs an option for the existing files
+  EXPECT_THROW(
+    rcpputils::fs::copy(root, target / "tree", copy_options::recursive), std::system_error);
+  EXPECT_NO_THROW(
+    rcpputils::fs::copy(
+      root, target / "tree", copy_options::recursive | copy_options::overwrite_existing));
+  EXPECT_NO_THROW(
+    rcpputils::fs::copy(
+      root, target / "tree", copy_options::recursive | copy_options::skip_existing));
+
+  // Without recursion, only the files directly inside are copied
+  rcpputils::fs::copy(root, target / "flat");
+  EXPECT_TRUE(rcpputils::fs::exists(target / "flat" / "a.txt"));
+  EXPECT_FALSE(rcpputils::fs::exists(target / "flat" / "sub"));
+
+  // A file is copied into a directory
+  rcpputils::fs::copy(root / "a.txt", target);
+  EXPECT_EQ(read(target / "a.txt"), "test");
+
+  EXPECT_THROW(rcpputils::fs::copy(root / "missing", target), std::system_error);
+
+  EXPECT_TRUE(rcpputils::fs::remove_all(root));
+  EXPECT_TRUE(rcpputils::fs::remove_all(target));
+}
+
 TEST(TestFilesystemHelper, remove_extension)
 {
   auto p = path("foo.txt");
@@ -391,6 +1368,16 @@ TEST(TestFilesystemHelper, remove_extensions_overcount)
   EXPECT_EQ("foo", p.string());
 }
 
+TEST(TestFilesystemHelper, behaviour_change_remove_extension_stops_at_separator)
+{
+  auto p = path("foo.d") / "bar";
+  p = rcpputils::fs::remove_extension(p);
+  EXPECT_EQ(path("foo.d") / "bar", p);
+
+  p = rcpputils::fs::remove_extension(path("foo.d") / "bar.txt.gz", 3);
+  EXPECT_EQ(path("foo.d") / "bar", p);
+}
+
 TEST(TestFilesystemHelper, remove_extension_no_extension)
 {
   auto p = path("foo");
@@ -524,3 +1511,159 @@ TEST(TestFilesystemHelper, equal_operators)
   path d = path("foo") / "bar";
   EXPECT_EQ(c, d);
 }
+
+TEST(TestFilesystemHelper, lexically_normal)
+{
+  const std::vector<std::pair<std::string, std::string>> cases = {
+    {"", ""},
+    {".", "."},
+    {"./", "."},
+    {"a", "a"},
+    {"a/./b", "a/b"},
+    {"a//b///c", "a/b/c"},
+    {"a/b/..", "a/"},
+    {"a/b/../", "a/"},
+    {"a/b/.", "a/b/"},
+    {"a/b/", "a/b/"},
+    {"a/..", "."},
+    {"a/../..", ".."},
+    {"../a/../..", "../.."},
+    {"../../b/", "../../b/"},
+    {"/", "/"},
+    {"/..", "/"},
+    {"/../a", "/a"},
+    {"//a/./b/../c", "/a/c"},
+  };
+  for (const auto & c : cases) {
+    EXPECT_EQ(path(c.first).lexically_normal().string(), path(c.second).string()) << c.first;
+  }
+}
+
+TEST(TestFilesystemHelper, lexically_relative)
+{
+  EXPECT_EQ(path("/a/d").lexically_relative("/a/b/c").string(), path("../../d").string());
+  EXPECT_EQ(path("/a/b/c").lexically_relative("/a/d").string(), path("../b/c").string());
+  EXPECT_EQ(path("a/b/c").lexically_relative("a").string(), path("b/c").string());
+  EXPECT_EQ(path("a/b/c").lexically_relative("a/b/c/x/y").string(), path("../..").string());
+  EXPECT_EQ(path("a/b/c").lexically_relative("a/b/c").string(), ".");
+  EXPECT_EQ(path("a/b").lexically_relative("c/d").string(), path("../../a/b").string());
+  EXPECT_EQ(path("a/b/").lexically_relative("a//b").string(), ".");
+  EXPECT_EQ(path("a/b").lexically_relative("a/b/x/..").string(), ".");
+  EXPECT_TRUE(path("a").lexically_relative("../../b").empty());
+  EXPECT_TRUE(path("/a").lexically_relative("a").empty());
+  EXPECT_TRUE(path("a").lexically_relative("/a").empty());
+
+  EXPECT_EQ(path("/a/b").lexically_proximate("/a").string(), "b");
+  EXPECT_EQ(path("/a/b").lexically_proximate("a").string(), path("/a/b").string());
+}
+
+TEST(TestFilesystemHelper, canonical)
+{
+  const auto root = rcpputils::fs::canonical(rcpputils::fs::create_temp_directory("canonical"));
+  EXPECT_TRUE(root.is_absolute());
+  ASSERT_TRUE(rcpputils::fs::create_directories(root / "real" / "sub"));
+  std::ofstream{(root / "real" / "sub" / "file.txt").string()};
+  std::ofstream{(root / "real" / "other.txt").string()};
+
+  std::vector<std::pair<path, path>> cases = {
+    {root / "real" / "sub" / "file.txt", root / "real" / "sub" / "file.txt"},
+    {root / "real" / "sub" / ".." / "other.txt", root / "real" / "other.txt"},
+    {root / "real" / "." / "sub" / "", root / "real" / "sub"},
+    {root / "real" / "sub" / ".." / "..", root},
+  };
+#ifndef _WIN32
+  ASSERT_EQ(symlink("real/sub", (root / "dir_link").string().c_str()), 0);
+  ASSERT_EQ(symlink("real/other.txt", (root / "file_link").string().c_str()), 0);
+  // The ".." applies to the target of the symlink, unlike with lexically_normal()
+  cases.push_back({root / "dir_link" / "file.txt", root / "real" / "sub" / "file.txt"});
+  cases.push_back({root / "dir_link" / ".." / "other.txt", root / "real" / "other.txt"});
+  cases.push_back({root / "file_link", root / "real" / "other.txt"});
+#endif
+
+  rcpputils::fs::canonical_cache cache;
+  for (int pass = 0; pass < 2; ++pass) {
+    for (const auto & c : cases) {
+      EXPECT_EQ(rcpputils::fs::canonical(c.first).string(), c.second.string()) << c.first;
+      EXPECT_EQ(cache.canonical(c.first).string(), c.second.string()) << c.first;
+    }
+  }
+  EXPECT_GT(cache.size(), 0u);
+
+  // Threads resolve through the same cache, filling it concurrently
+  rcpputils::fs::canonical_cache shared_cache;
+  std::atomic<int> mismatches{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&cases, &shared_cache, &mismatches] {
+        for (const auto & c : cases) {
+          if (shared_cache.canonical(c.first).string() != c.second.string()) {
+            ++mismatches;
+          }
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(mismatches.load(), 0);
+
+  // Relative paths are resolved from the current working directory
+  EXPECT_EQ(
+    cache.canonical(path(".")).string(),
+    rcpputils::fs::canonical(rcpputils::fs::current_path()).string());
+
+  EXPECT_THROW(rcpputils::fs::canonical(root / "missing"), std::system_error);
+  EXPECT_THROW(cache.canonical(root / "missing"), std::system_error);
+  EXPECT_THROW(cache.canonical(root / "missing" / "file.txt"), std::system_error);
+
+#ifndef _WIN32
+  // A file cannot be walked through, even to come back with ".."
+  std::vector<path> not_directories = {
+    root / "real" / "other.txt" / "..",
+    root / "real" / "other.txt" / "sub",
+    root / "real" / "other.txt" / "",
+    root / "file_link" / "..",
+    root / "file_link" / "",
+  };
+  for (const auto & p : not_directories) {
+    std::error_code ec;
+    EXPECT_TRUE(rcpputils::fs::canonical(p, ec).empty()) << p;
+    EXPECT_EQ(ec, std::errc::not_a_directory) << p;
+    EXPECT_TRUE(cache.canonical(p, ec).empty()) << p;
+    EXPECT_EQ(ec, std::errc::not_a_directory) << p;
+  }
+#endif
+
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0u);
+  EXPECT_TRUE(rcpputils::fs::remove_all(root));
+}
+
+TEST(TestFilesystemHelper, compare_and_hash)
+{
+  // Components are compared, rather than characters
+  EXPECT_LT(path("a/b"), path("a-b"));
+  EXPECT_LT(path("a"), path("a/b"));
+  EXPECT_LT(path("a/b"), path("a/c"));
+  EXPECT_LT(path("/z"), path("a"));
+  EXPECT_GT(path("ab"), path("a/c"));
+  EXPECT_LE(path("a/b"), path("a/b"));
+  EXPECT_GE(path("a/b"), path("a/b"));
+  EXPECT_EQ(path("a/b").compare(path("a/b")), 0);
+  // Consistent with operator==, which compares the strings
+  EXPECT_NE(path("a//b").compare(path("a/b")), 0);
+  EXPECT_NE(path("a/").compare(path("a")), 0);
+
+  std::vector<path> sorted = {path("b"), path("a-b"), path("a/b/c"), path("a"), path("a/b")};
+  std::sort(sorted.begin(), sorted.end());
+  EXPECT_EQ(
+    sorted, std::vector<path>({path("a"), path("a/b"), path("a/b/c"), path("a-b"), path("b")}));
+
+  EXPECT_EQ(std::hash<path>()(path("a/b")), std::hash<path>()(path("a") / "b"));
+  std::unordered_map<path, int> map;
+  map[path("a/b")] = 1;
+  map[path("a") / "b"] += 1;
+  map[path("c")] = 3;
+  EXPECT_EQ(map.size(), 2u);
+  EXPECT_EQ(map[path("a/b")], 2);
+}
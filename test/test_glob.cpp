@@ -0,0 +1,141 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+#include "rcpputils/glob.hpp"
+
+using rcpputils::fs::glob_pattern;
+using rcpputils::fs::path;
+
+TEST(TestGlob, wildcards)
+{
+  const glob_pattern star("*.so");
+  EXPECT_TRUE(star.match("libfoo.so"));
+  EXPECT_TRUE(star.match(".so"));
+  EXPECT_FALSE(star.match("libfoo.so.1"));
+  EXPECT_FALSE(star.match("lib/foo.so"));
+  EXPECT_EQ(star.str(), "*.so");
+
+  const glob_pattern backtrack("a*b*c");
+  EXPECT_TRUE(backtrack.match("abc"));
+  EXPECT_TRUE(backtrack.match("aXbYbZc"));
+  EXPECT_TRUE(backtrack.match("abcbc"));
+  EXPECT_FALSE(backtrack.match("aXbYbZ"));
+  EXPECT_FALSE(backtrack.match("XabC"));
+
+  const glob_pattern question("file_??.txt");
+  EXPECT_TRUE(question.match("file_01.txt"));
+  EXPECT_FALSE(question.match("file_1.txt"));
+  EXPECT_FALSE(question.match("file_001.txt"));
+
+  EXPECT_TRUE(glob_pattern("**").match("anything"));
+  EXPECT_TRUE(glob_pattern("a**b").match("aXYb"));
+  EXPECT_TRUE(glob_pattern("exact").match("exact"));
+  EXPECT_FALSE(glob_pattern("exact").match("exactly"));
+  EXPECT_FALSE(glob_pattern("exact").match(""));
+}
+
+TEST(TestGlob, sets)
+{
+  const glob_pattern digits("v[0-9][0-9x]");
+  EXPECT_TRUE(digits.match("v10"));
+  EXPECT_TRUE(digits.match("v1x"));
+  EXPECT_FALSE(digits.match("va0"));
+
+  const glob_pattern negated("[!.]*");
+  EXPECT_TRUE(negated.match("visible"));
+  EXPECT_FALSE(negated.match(".hidden"));
+  EXPECT_FALSE(glob_pattern("[^.]*").match(".hidden"));
+
+  EXPECT_TRUE(glob_pattern("[]a]").match("]"));
+  EXPECT_TRUE(glob_pattern("[a-]").match("-"));
+  EXPECT_THROW(glob_pattern("[abc"), std::invalid_argument);
+  EXPECT_THROW(glob_pattern("[]"), std::invalid_argument);
+#ifndef _WIN32
+  EXPECT_TRUE(glob_pattern("\\*").match("*"));
+  EXPECT_FALSE(glob_pattern("\\*").match("a"));
+#endif
+}
+
+TEST(TestGlob, components)
+{
+  const glob_pattern pattern("share/*/package.xml");
+  EXPECT_TRUE(pattern.match("share/rcpputils/package.xml"));
+  EXPECT_TRUE(pattern.match(path("share") / "rcpputils" / "package.xml"));
+  EXPECT_TRUE(pattern.match("share//rcpputils/package.xml/"));
+  EXPECT_FALSE(pattern.match("share/package.xml"));
+  EXPECT_FALSE(pattern.match("share/a/b/package.xml"));
+
+  const glob_pattern globstar("lib/**/*.so");
+  EXPECT_TRUE(globstar.match("lib/libfoo.so"));
+  EXPECT_TRUE(globstar.match("lib/a/libfoo.so"));
+  EXPECT_TRUE(globstar.match("lib/a/b/c/libfoo.so"));
+  EXPECT_FALSE(globstar.match("lib/a/b/c/libfoo.a"));
+  EXPECT_FALSE(globstar.match("other/libfoo.so"));
+
+  const glob_pattern nested("**/x/**/y");
+  EXPECT_TRUE(nested.match("x/y"));
+  EXPECT_TRUE(nested.match("a/x/b/x/c/y"));
+  EXPECT_FALSE(nested.match("a/x/b/y/c"));
+  EXPECT_TRUE(glob_pattern("a/**").match("a"));
+  EXPECT_TRUE(glob_pattern("a/**").match("a/b/c"));
+}
+
+TEST(TestGlob, glob)
+{
+  const auto root = rcpputils::fs::create_temp_directory("glob");
+  for (const auto & file : {
+      "share/a/package.xml", "share/b/package.xml", "share/b/other.xml", "share/c/d/package.xml",
+      "lib/liba.so", "lib/sub/libb.so", "lib/sub/deeper/libc.so", "lib/libd.a"})
+  {
+    const auto p = root / file;
+    rcpputils::fs::create_directories(p.parent_path());
+    std::ofstream{p.string()};
+  }
+  auto relative = [&root](const std::vector<path> & matches) {
+      std::vector<std::string> result;
+      for (const auto & match : matches) {
+        result.push_back(match.string().substr(root.string().size() + 1));
+      }
+      return result;
+    };
+  const auto sep = std::string(1, rcpputils::fs::kPreferredSeparator);
+
+  EXPECT_EQ(
+    relative(rcpputils::fs::glob(root, "share/*/package.xml")),
+    std::vector<std::string>({"share" + sep + "a" + sep + "package.xml",
+      "share" + sep + "b" + sep + "package.xml"}));
+  EXPECT_EQ(
+    relative(rcpputils::fs::glob(root, "lib/**/*.so")),
+    std::vector<std::string>({"lib" + sep + "liba.so",
+      "lib" + sep + "sub" + sep + "deeper" + sep + "libc.so",
+      "lib" + sep + "sub" + sep + "libb.so"}));
+  EXPECT_EQ(
+    relative(rcpputils::fs::glob(root, glob_pattern("s[h]are"))),
+    std::vector<std::string>({"share"}));
+  EXPECT_TRUE(rcpputils::fs::glob(root, "missing/*").empty());
+  EXPECT_TRUE(rcpputils::fs::glob(root, "").empty());
+  EXPECT_TRUE(rcpputils::fs::glob(root / "missing", "*").empty());
+  EXPECT_TRUE(rcpputils::fs::glob(root / "missing", "**").empty());
+  EXPECT_TRUE(rcpputils::fs::glob(root / "lib" / "liba.so", "**/*.so").empty());
+
+  EXPECT_TRUE(rcpputils::fs::remove_all(root));
+}
@@ -0,0 +1,184 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "rcpputils/filesystem_helper.hpp"
+#include "rcpputils/mapped_file.hpp"
+
+using rcpputils::fs::access_advice;
+using rcpputils::fs::map_mode;
+using rcpputils::fs::mapped_file;
+using rcpputils::fs::path;
+
+class TestMappedFile : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    dir_ = rcpputils::fs::create_temp_directory("mapped_file");
+    file_ = dir_ / "data.bin";
+    // Spans a few pages, with a recognizable byte at each position
+    content_.resize(3 * 65536 + 123);
+    for (size_t i = 0; i < content_.size(); ++i) {
+      content_[i] = static_cast<char>(i % 251);
+    }
+    std::ofstream output_buffer{file_.string(), std::ios::binary};
+    output_buffer << content_;
+  }
+
+  void TearDown() override
+  {
+    rcpputils::fs::remove_all(dir_);
+  }
+
+  std::string as_string(const mapped_file & mapping)
+  {
+    return std::string(reinterpret_cast<const char *>(mapping.data()), mapping.size());
+  }
+
+  path dir_;
+  path file_;
+  std::string content_;
+};
+
+TEST_F(TestMappedFile, map_whole_file)
+{
+  const mapped_file mapping(file_);
+  ASSERT_EQ(mapping.size(), content_.size());
+  EXPECT_EQ(mapping.offset(), 0u);
+  EXPECT_EQ(as_string(mapping), content_);
+  EXPECT_EQ(static_cast<size_t>(mapping.end() - mapping.begin()), content_.size());
+}
+
+TEST_F(TestMappedFile, map_range)
+{
+  // Neither the offset nor the length are aligned to pages
+  const mapped_file mapping(file_, 70001, 1000);
+  EXPECT_EQ(mapping.offset(), 70001u);
+  EXPECT_EQ(as_string(mapping), content_.substr(70001, 1000));
+
+  const mapped_file tail(file_, 65536, 0);
+  EXPECT_EQ(as_string(tail), content_.substr(65536));
+
+  const mapped_file at_end(file_, content_.size(), 0);
+  EXPECT_TRUE(at_end.empty());
+
+  EXPECT_THROW(mapped_file(file_, content_.size() + 1, 0), std::system_error);
+  EXPECT_THROW(mapped_file(file_, content_.size() - 10, 11), std::system_error);
+}
+
+TEST_F(TestMappedFile, empty_and_missing_files)
+{
+  const auto empty_file = dir_ / "empty.bin";
+  std::ofstream{empty_file.string()};
+  const mapped_file mapping(empty_file);
+  EXPECT_TRUE(mapping.empty());
+  EXPECT_EQ(mapping.data(), nullptr);
+
+  EXPECT_THROW(mapped_file(dir_ / "missing.bin"), std::system_error);
+}
+
+TEST_F(TestMappedFile, advise)
+{
+  const mapped_file mapping(file_, 100, 0);
+  EXPECT_TRUE(mapping.advise(access_advice::normal));
+  EXPECT_TRUE(mapping.advise(access_advice::willneed, 1000, 5000));
+  EXPECT_FALSE(mapping.advise(access_advice::willneed, mapping.size(), 1));
+#ifndef _WIN32
+  EXPECT_TRUE(mapping.advise(access_advice::sequential));
+  EXPECT_TRUE(mapping.advise(access_advice::random));
+#endif
+  // Hugepages depend on the kernel and filesystem, but must not break the mapping
+  mapping.advise(access_advice::hugepage);
+  EXPECT_EQ(as_string(mapping), content_.substr(100));
+}
+
+TEST_F(TestMappedFile, move_and_unmap)
+{
+  mapped_file mapping(file_);
+  const std::byte * data = mapping.data();
+
+  mapped_file moved(std::move(mapping));
+  EXPECT_EQ(moved.data(), data);
+  EXPECT_TRUE(mapping.empty());
+
+  mapping = std::move(moved);
+  EXPECT_EQ(mapping.data(), data);
+  EXPECT_EQ(as_string(mapping), content_);
+
+  mapping.unmap();
+  EXPECT_TRUE(mapping.empty());
+  EXPECT_EQ(mapping.data(), nullptr);
+}
+
+TEST_F(TestMappedFile, write)
+{
+  const auto output = dir_ / "output.bin";
+  mapped_file mapping(output, map_mode::read_write, 0, 4096);
+  EXPECT_EQ(mapping.mode(), map_mode::read_write);
+  ASSERT_EQ(mapping.size(), 4096u);
+  EXPECT_EQ(rcpputils::fs::file_size(output), 4096u);
+  std::memset(mapping.mutable_data(), 'a', mapping.size());
+
+  // Growing keeps the content, and extends the file
+  mapping.resize(3 * 65536);
+  EXPECT_EQ(rcpputils::fs::file_size(output), 3u * 65536u);
+  EXPECT_EQ(static_cast<char>(mapping.data()[4095]), 'a');
+  std::memset(mapping.mutable_data() + 4096, 'b', mapping.size() - 4096);
+  mapping.sync(4096, 100, rcpputils::fs::sync_mode::async);
+  mapping.sync();
+  EXPECT_THROW(mapping.sync(mapping.size(), 1), std::system_error);
+
+  // Shrinking truncates the file to the written records
+  mapping.resize(5000);
+  EXPECT_EQ(rcpputils::fs::file_size(output), 5000u);
+  mapping.unmap();
+
+  const mapped_file reader(output);
+  EXPECT_EQ(as_string(reader), std::string(4096, 'a') + std::string(904, 'b'));
+}
+
+TEST_F(TestMappedFile, write_range)
+{
+  {
+    mapped_file mapping(file_, map_mode::read_write, 70001, 3);
+    std::memcpy(mapping.mutable_data(), "xyz", 3);
+  }
+  content_.replace(70001, 3, "xyz");
+  EXPECT_EQ(as_string(mapped_file(file_)), content_);
+
+  // Mapping past the end grows the file
+  {
+    mapped_file mapping(file_, map_mode::read_write, content_.size(), 10);
+    std::memset(mapping.mutable_data(), 'z', 10);
+  }
+  EXPECT_EQ(as_string(mapped_file(file_)), content_ + std::string(10, 'z'));
+}
+
+TEST_F(TestMappedFile, read_only_is_not_writable)
+{
+  mapped_file mapping(file_);
+  EXPECT_EQ(mapping.mode(), map_mode::read_only);
+  EXPECT_EQ(mapping.mutable_data(), nullptr);
+  EXPECT_THROW(mapping.resize(10), std::system_error);
+  EXPECT_THROW(mapped_file(dir_ / "missing.bin", map_mode::read_only), std::system_error);
+}
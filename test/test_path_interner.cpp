@@ -0,0 +1,88 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+#include "rcpputils/path_interner.hpp"
+
+using rcpputils::fs::path;
+using rcpputils::fs::path_interner;
+
+TEST(TestPathInterner, round_trip)
+{
+  path_interner interner;
+  EXPECT_EQ(interner.size(), 1u);
+  EXPECT_EQ(interner.intern(""), path_interner::handle());
+  EXPECT_TRUE(interner.get(path_interner::handle()).empty());
+
+  // Separators are kept as given, so equal handles mean equal paths
+  const std::vector<path> paths = {
+    path("/"), path("/opt/ros/share/rcpputils"), path("/opt/ros/share/rcpputils/"),
+    path("/opt/ros/share/rclcpp"), path("relative/share/rcpputils"), path("a//b"), path("a"),
+    path("a/b")};
+  std::vector<path_interner::handle> handles;
+  for (const auto & p : paths) {
+    handles.push_back(interner.intern(p));
+  }
+  for (size_t i = 0; i < paths.size(); ++i) {
+    EXPECT_EQ(interner.get(handles[i]), paths[i]);
+    EXPECT_EQ(interner.intern(paths[i]), handles[i]);
+    ASSERT_TRUE(interner.find(paths[i]).has_value());
+    EXPECT_EQ(*interner.find(paths[i]), handles[i]);
+    for (size_t j = 0; j < i; ++j) {
+      EXPECT_NE(handles[i], handles[j]) << paths[i] << " " << paths[j];
+    }
+  }
+  EXPECT_FALSE(interner.find("/opt/ros/lib").has_value());
+  EXPECT_FALSE(interner.find("/opt/ros/share/rcpputils/missing").has_value());
+}
+
+TEST(TestPathInterner, shared_prefixes)
+{
+  path_interner interner;
+  const auto share = interner.intern("/opt/ros/share");
+  const size_t size = interner.size();
+  const auto own = interner.intern("/opt/ros/share/rcpputils");
+  const auto rclcpp = interner.intern(share, "rclcpp");
+  // Only the last components were added
+  EXPECT_EQ(interner.size(), size + 2);
+
+  EXPECT_EQ(interner.parent(own), share);
+  EXPECT_EQ(interner.parent(rclcpp), share);
+  EXPECT_EQ(interner.filename(own), "rcpputils");
+  EXPECT_EQ(interner.get(rclcpp), path("/opt/ros/share/rclcpp"));
+  EXPECT_EQ(interner.find("/opt/ros/share/rclcpp"), rclcpp);
+  EXPECT_EQ(interner.parent(interner.intern("single")), path_interner::handle());
+
+  std::unordered_set<path_interner::handle> set{own, rclcpp, share, own};
+  EXPECT_EQ(set.size(), 3u);
+}
+
+TEST(TestPathInterner, many_paths)
+{
+  path_interner interner;
+  std::vector<path_interner::handle> handles;
+  for (int i = 0; i < 10000; ++i) {
+    handles.push_back(
+      interner.intern(
+        "/data/recordings/" + std::to_string(i % 10) + "/file_" + std::to_string(i) + ".mcap"));
+  }
+  EXPECT_EQ(interner.size(), 1u + 3u + 10u + 10000u);
+  EXPECT_EQ(interner.get(handles[1234]), path("/data/recordings/4/file_1234.mcap"));
+}
@@ -0,0 +1,283 @@
+// Copyright 2026 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#ifdef __linux__
+#include <poll.h>
+#endif
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "rcpputils/filesystem_helper.hpp"
+#include "rcpputils/watcher.hpp"
+
+using rcpputils::fs::path;
+using rcpputils::fs::watch_change;
+using rcpputils::fs::watch_event;
+using rcpputils::fs::watcher;
+
+#ifdef __linux__
+
+namespace
+{
+
+bool has(watch_change changes, watch_change flag)
+{
+  return (changes & flag) != watch_change::none;
+}
+
+/// Find the event of a target, or nullptr if it changed without being reported.
+const watch_event * find_event(const std::vector<watch_event> & events, const path & target)
+{
+  for (const auto & event : events) {
+    if (event.target.string() == target.string()) {
+      return &event;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+class TestWatcher : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    dir_ = rcpputils::fs::create_temp_directory("watcher");
+  }
+
+  void TearDown() override
+  {
+    rcpputils::fs::remove_all(dir_);
+  }
+
+  /// Read the events, until those that already happened have all arrived.
+  static std::vector<watch_event> wait_events(watcher & w)
+  {
+    auto events = w.poll(std::chrono::milliseconds(1000));
+    for (auto more = w.poll(std::chrono::milliseconds(50)); !more.empty();
+      more = w.poll(std::chrono::milliseconds(50)))
+    {
+      events.insert(events.end(), more.begin(), more.end());
+    }
+    return events;
+  }
+
+  path dir_;
+};
+
+TEST_F(TestWatcher, directory)
+{
+  watcher w;
+  w.add(dir_);
+  EXPECT_TRUE(w.poll().empty());
+
+  const auto file = dir_ / "file.txt";
+  {
+    std::ofstream output_buffer{file.string()};
+    output_buffer << "first";
+    output_buffer.flush();
+    output_buffer << "second";
+  }
+  auto events = wait_events(w);
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(events[0].target.string(), file.string());
+  EXPECT_TRUE(has(events[0].changes, watch_change::created));
+  EXPECT_TRUE(has(events[0].changes, watch_change::modified));
+  EXPECT_FALSE(events[0].is_directory);
+
+  ASSERT_EQ(std::rename(file.string().c_str(), (dir_ / "renamed.txt").string().c_str()), 0);
+  rcpputils::fs::create_directories(dir_ / "sub");
+  events = wait_events(w);
+  ASSERT_EQ(events.size(), 3u);
+  EXPECT_EQ(events[0].changes, watch_change::removed);
+  EXPECT_EQ(events[1].target.string(), (dir_ / "renamed.txt").string());
+  EXPECT_EQ(events[1].changes, watch_change::created);
+  EXPECT_EQ(events[2].target.string(), (dir_ / "sub").string());
+  EXPECT_TRUE(events[2].is_directory);
+
+  // Not recursive, so changes in the subdirectory are not reported
+  std::ofstream{(dir_ / "sub" / "ignored.txt").string()};
+  EXPECT_TRUE(w.poll(std::chrono::milliseconds(50)).empty());
+
+  EXPECT_TRUE(w.remove(dir_));
+  EXPECT_FALSE(w.remove(dir_));
+  std::ofstream{(dir_ / "after.txt").string()};
+  EXPECT_TRUE(w.poll(std::chrono::milliseconds(50)).empty());
+
+  EXPECT_THROW(w.add(dir_ / "missing"), std::system_error);
+}
+
+TEST_F(TestWatcher, file)
+{
+  const auto file = dir_ / "config.yaml";
+  std::ofstream{file.string()};
+  watcher w;
+  w.add(file);
+
+  std::ofstream{(dir_ / "other.yaml").string()};
+  {
+    std::ofstream output_buffer{file.string(), std::ios::app};
+    output_buffer << "key: value";
+  }
+  const auto events = wait_events(w);
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(events[0].target.string(), file.string());
+  EXPECT_TRUE(has(events[0].changes, watch_change::modified));
+}
+
+TEST_F(TestWatcher, recursive)
+{
+  rcpputils::fs::create_directories(dir_ / "a" / "b");
+  rcpputils::fs::watch_options options;
+  options.recursive = true;
+  watcher w;
+  w.add(dir_, options);
+
+  std::ofstream{(dir_ / "a" / "b" / "deep.txt").string()};
+  // Created along with its content, before it can be watched
+  rcpputils::fs::create_directories(dir_ / "new" / "nested");
+  std::ofstream{(dir_ / "new" / "nested" / "early.txt").string()};
+
+  auto events = wait_events(w);
+  EXPECT_NE(find_event(events, dir_ / "a" / "b" / "deep.txt"), nullptr);
+  EXPECT_NE(find_event(events, dir_ / "new"), nullptr);
+  EXPECT_NE(find_event(events, dir_ / "new" / "nested"), nullptr);
+  const auto early = find_event(events, dir_ / "new" / "nested" / "early.txt");
+  ASSERT_NE(early, nullptr);
+  EXPECT_TRUE(has(early->changes, watch_change::created));
+
+  // The new directories are watched from now on
+  std::ofstream{(dir_ / "new" / "nested" / "late.txt").string()};
+  events = wait_events(w);
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(events[0].target.string(), (dir_ / "new" / "nested" / "late.txt").string());
+
+  // Moved directories are watched under their new path
+  ASSERT_EQ(
+    std::rename((dir_ / "new").string().c_str(), (dir_ / "moved").string().c_str()), 0);
+  wait_events(w);
+  std::ofstream{(dir_ / "moved" / "nested" / "after_move.txt").string()};
+  events = wait_events(w);
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(
+    events[0].target.string(), (dir_ / "moved" / "nested" / "after_move.txt").string());
+}
+
+TEST_F(TestWatcher, nested_roots)
+{
+  rcpputils::fs::create_directories(dir_ / "b");
+  rcpputils::fs::watch_options options;
+  options.recursive = true;
+  watcher w;
+  w.add(dir_, options);
+
+  // The nested path shares its inotify watch with the recursive root
+  w.add(dir_ / "b");
+  EXPECT_TRUE(w.remove(dir_ / "b"));
+  std::ofstream{(dir_ / "b" / "f").string()};
+  auto events = wait_events(w);
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(events[0].target.string(), (dir_ / "b" / "f").string());
+
+  // Removing the recursive root keeps the nested one
+  w.add(dir_ / "b");
+  EXPECT_TRUE(w.remove(dir_));
+  std::ofstream{(dir_ / "b" / "g").string()};
+  std::ofstream{(dir_ / "outside").string()};
+  events = wait_events(w);
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(events[0].target.string(), (dir_ / "b" / "g").string());
+}
+
+TEST_F(TestWatcher, native_handle_and_callback)
+{
+  watcher w;
+  w.add(dir_);
+  pollfd descriptor{w.native_handle(), POLLIN, 0};
+  ASSERT_GE(descriptor.fd, 0);
+  EXPECT_EQ(poll(&descriptor, 1, 0), 0);
+
+  std::ofstream{(dir_ / "file.txt").string()};
+  ASSERT_EQ(poll(&descriptor, 1, 1000), 1);
+  std::vector<path> targets;
+  EXPECT_EQ(w.poll([&targets](const watch_event & event) {targets.push_back(event.target);}), 1u);
+  ASSERT_EQ(targets.size(), 1u);
+  EXPECT_EQ(targets[0].string(), (dir_ / "file.txt").string());
+
+  watcher moved(std::move(w));
+  EXPECT_EQ(moved.native_handle(), descriptor.fd);
+  EXPECT_EQ(w.native_handle(), -1);  // NOLINT(bugprone-use-after-move)
+  EXPECT_TRUE(w.poll().empty());  // NOLINT(bugprone-use-after-move)
+}
+
+TEST_F(TestWatcher, overflow)
+{
+  size_t max_queued_events = 0;
+  std::ifstream{"/proc/sys/fs/inotify/max_queued_events"} >> max_queued_events;
+  if (max_queued_events == 0 || max_queued_events > 100000) {
+    GTEST_SKIP() << "the event queue is too large to overflow";
+  }
+
+  std::ofstream{(dir_ / "removed.txt").string()};
+  std::ofstream{(dir_ / "kept.txt").string()};
+  rcpputils::fs::watch_options options;
+  options.resync = true;
+  watcher resyncing;
+  resyncing.add(dir_, options);
+  watcher plain;
+  plain.add(dir_);
+
+  const size_t count = max_queued_events + 100;
+  for (size_t i = 0; i < count; ++i) {
+    std::ofstream{(dir_ / ("file_" + std::to_string(i))).string()};
+  }
+  rcpputils::fs::remove(dir_ / "removed.txt");
+
+  // Without resync, the lost events are reported as an overflow of the watched directory
+  const auto plain_events = wait_events(plain);
+  const auto overflow = find_event(plain_events, dir_);
+  ASSERT_NE(overflow, nullptr);
+  EXPECT_TRUE(has(overflow->changes, watch_change::overflow));
+
+  // With resync, every change is reported as if no event had been lost
+  const auto events = wait_events(resyncing);
+  EXPECT_EQ(find_event(events, dir_), nullptr);
+  EXPECT_EQ(find_event(events, dir_ / "kept.txt"), nullptr);
+  const auto removed = find_event(events, dir_ / "removed.txt");
+  ASSERT_NE(removed, nullptr);
+  EXPECT_EQ(removed->changes, watch_change::removed);
+  size_t created = 0;
+  for (const auto & event : events) {
+    created += has(event.changes, watch_change::created) ? 1 : 0;
+  }
+  EXPECT_EQ(created, count);
+}
+
+#else
+
+TEST(TestWatcher, not_supported)
+{
+  EXPECT_THROW(watcher(), std::system_error);
+}
+
+#endif